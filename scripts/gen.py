@@ -188,6 +188,8 @@ _CPP_HEADER = """// Autogenerated file by {gen}. Do not edit directly!
 #include "tensorflow/compiler/xla/xla_client/tf_logging.h"
 #include "torch_xla/csrc/aten_xla_bridge.h"
 #include "torch_xla/csrc/aten_xla_type.h"
+#include "torch_xla/csrc/fallback_tracker.h"
+#include "torch_xla/csrc/op_profiler.h"
 
 namespace torch_xla {{
 
@@ -554,8 +556,9 @@ def get_return_value(rtype, rname, param, var, ref_param, fnopts):
     # If instead the return type is a value Tensor, we create a new one by
     # wrapping the proper local variable which has been created by calling
     # into the CPU tensor implementation.
-    return 'bridge::CreateXlaTensor({}, bridge::GetXlaDevice({}))'.format(
-        rname, get_optional(fnopts, 'device_param', param_name(ref_param)))
+    device = get_optional(fnopts, 'device_param', param_name(ref_param))
+    return 'bridge::CreateFallbackXlaTensor({}, bridge::GetXlaDevice({}))'.format(
+        rname, device)
 
 
 def get_reference_param(params, fnopts=None):
@@ -608,6 +611,10 @@ def generate_entry_debug_code(t, fname, params, fname_ns=None):
   code = ''
   if fname_ns is not None:
     code += '  XLA_COUNTER("{}::{}", 1);\n'.format(fname_ns, fname)
+    code += ('  OpProfiler::OpScope op_scope("{}::", "{}", '
+             '/*fallback=*/true);\n').format(fname_ns, fname)
+    code += '  FallbackTracker::Scope fallback_scope("{}::{}");\n'.format(
+        fname_ns, fname)
   # VLOG info. Use the following to see debug output:
   #  export TF_CPP_VMODULE=aten_xla_type_default=3
   code += '  TF_VLOG(3) << "XLA {} :"'.format(fname)
@@ -635,8 +642,9 @@ def generate_return_stmt(t, rtype_str, fname, rname, params, param_vars,
     retstr = get_tuple_return(rtype, rtype_str, rname, params, param_vars,
                               ref_param, fnopts)
   elif ctype == 'std::vector':
-    retstr = 'bridge::CreateXlaTensors({}, bridge::GetXlaDevice({}))'.format(
-        rname, get_optional(fnopts, 'device_param', param_name(ref_param)))
+    device = get_optional(fnopts, 'device_param', param_name(ref_param))
+    retstr = ('bridge::CreateFallbackXlaTensors({}, bridge::GetXlaDevice({}))'
+              .format(rname, device))
   elif ctype == 'Tensor':
     retstr = get_return_value(rtype, rname, params[0], param_vars[0], ref_param,
                               fnopts)
@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "torch_xla/csrc/ir.h"
+#include "torch_xla/csrc/ir_util.h"
+#include "torch_xla/csrc/lowering_context.h"
+#include "torch_xla/csrc/ops/arithmetic_ir_ops.h"
+#include "torch_xla/csrc/ops/ops.h"
+
+namespace torch_xla {
+namespace cpp_test {
+namespace {
+
+// Builds a graph of length nodes, where every node uses both the previous one
+// and a new scalar, so that the post-order walks find shared operands.
+ir::Value BuildGraph(int64_t length) {
+  ir::Value value = ir::ops::ScalarOp(1.0, xla::F32);
+  for (int64_t i = 0; i < length; ++i) {
+    value = value * value + ir::ops::ScalarOp(i, xla::F32);
+  }
+  return value;
+}
+
+void BM_NodeCreate(benchmark::State& state) {
+  ir::Value value = ir::ops::ScalarOp(1.0, xla::F32);
+  for (auto _ : state) {
+    // The node creation includes its shape inference and hashing.
+    ir::Value add = value + value;
+    benchmark::DoNotOptimize(add.hash());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NodeCreate);
+
+void BM_ComputePostOrder(benchmark::State& state) {
+  ir::Value root = BuildGraph(state.range(0));
+  for (auto _ : state) {
+    std::vector<const ir::Node*> post_order =
+        ir::Util::ComputePostOrder({root.node.get()});
+    benchmark::DoNotOptimize(post_order.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ComputePostOrder)->Range(64, 16384);
+
+void BM_LowerGraph(benchmark::State& state) {
+  ir::Value root = BuildGraph(state.range(0));
+  for (auto _ : state) {
+    ir::LoweringContext lowering_ctx("BenchLowerGraph");
+    lowering_ctx.AddResult(lowering_ctx.GetOutputOp(root));
+    xla::XlaComputation computation = lowering_ctx.Build().ConsumeValueOrDie();
+    benchmark::DoNotOptimize(&computation);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_LowerGraph)->Range(64, 4096);
+
+}  // namespace
+}  // namespace cpp_test
+}  // namespace torch_xla
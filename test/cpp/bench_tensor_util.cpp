@@ -0,0 +1,53 @@
+#include <ATen/ATen.h>
+#include <benchmark/benchmark.h>
+
+#include "torch_xla/csrc/device.h"
+#include "torch_xla/csrc/tensor_util.h"
+
+namespace torch_xla {
+namespace cpp_test {
+namespace {
+
+// The benchmarks run on the default device, which is the CPU one when the XRT
+// CPU device is the only one configured.
+
+void BM_GetTensorLiteral(benchmark::State& state) {
+  at::Tensor tensor =
+      at::rand({state.range(0), 1024}, at::TensorOptions(at::kFloat));
+  for (auto _ : state) {
+    xla::Literal literal =
+        GetTensorLiteral(tensor, /*shape=*/nullptr, /*device=*/nullptr);
+    benchmark::DoNotOptimize(literal.untyped_data());
+  }
+  state.SetBytesProcessed(state.iterations() * tensor.nbytes());
+}
+BENCHMARK(BM_GetTensorLiteral)->Range(1, 4096);
+
+void BM_MakeTensorFromXlaLiteral(benchmark::State& state) {
+  at::Tensor tensor =
+      at::rand({state.range(0), 1024}, at::TensorOptions(at::kFloat));
+  xla::Literal literal =
+      GetTensorLiteral(tensor, /*shape=*/nullptr, /*device=*/nullptr);
+  for (auto _ : state) {
+    at::Tensor result = MakeTensorFromXlaLiteral(literal, at::kFloat);
+    benchmark::DoNotOptimize(result.data_ptr());
+  }
+  state.SetBytesProcessed(state.iterations() * tensor.nbytes());
+}
+BENCHMARK(BM_MakeTensorFromXlaLiteral)->Range(1, 4096);
+
+void BM_TensorToXlaData(benchmark::State& state) {
+  at::Tensor tensor =
+      at::rand({state.range(0), 1024}, at::TensorOptions(at::kFloat));
+  const Device* device = GetDefaultDevice();
+  for (auto _ : state) {
+    xla::ComputationClient::DataPtr data = TensorToXlaData(tensor, *device);
+    benchmark::DoNotOptimize(data.get());
+  }
+  state.SetBytesProcessed(state.iterations() * tensor.nbytes());
+}
+BENCHMARK(BM_TensorToXlaData)->Range(1, 4096)->UseRealTime();
+
+}  // namespace
+}  // namespace cpp_test
+}  // namespace torch_xla
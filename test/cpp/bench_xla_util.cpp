@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+
+#include "tensorflow/compiler/xla/xla_client/cache.h"
+#include "tensorflow/compiler/xla/xla_client/metrics.h"
+
+namespace torch_xla {
+namespace cpp_test {
+namespace {
+
+constexpr int64_t kCacheSize = 1024;
+
+using BenchCache = xla::util::Cache<int64_t, int64_t>;
+
+BenchCache* GetBenchCache() {
+  static BenchCache* cache = []() {
+    BenchCache* cache = new BenchCache(kCacheSize);
+    for (int64_t i = 0; i < kCacheSize; ++i) {
+      cache->Add(i, std::make_shared<int64_t>(i));
+    }
+    return cache;
+  }();
+  return cache;
+}
+
+void BM_CacheGet(benchmark::State& state) {
+  BenchCache* cache = GetBenchCache();
+  // Half of the lookups miss, like a compilation cache warming up.
+  int64_t key = state.thread_index;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(cache->Get(key % (2 * kCacheSize)));
+    key += 7;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CacheGet)->ThreadRange(1, 16)->UseRealTime();
+
+void BM_CounterAdd(benchmark::State& state) {
+  static xla::metrics::Counter* counter =
+      new xla::metrics::Counter("BenchCounter");
+  for (auto _ : state) {
+    counter->AddValue(1);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CounterAdd)->ThreadRange(1, 16)->UseRealTime();
+
+void BM_MetricAddSample(benchmark::State& state) {
+  static xla::metrics::Metric* metric =
+      new xla::metrics::Metric("BenchMetric", xla::metrics::MetricFnTime);
+  double value = 0;
+  for (auto _ : state) {
+    metric->AddSample(value);
+    value += 1;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MetricAddSample)->ThreadRange(1, 16)->UseRealTime();
+
+}  // namespace
+}  // namespace cpp_test
+}  // namespace torch_xla
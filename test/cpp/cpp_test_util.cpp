@@ -4,6 +4,7 @@
 #include <string>
 
 #include "tensorflow/compiler/xla/xla_client/debug_macros.h"
+#include "tensorflow/compiler/xla/xla_client/metrics.h"
 #include "tensorflow/compiler/xla/xla_client/sys_util.h"
 #include "torch_xla/csrc/aten_xla_bridge.h"
 #include "torch_xla/csrc/ir_dump_util.h"
@@ -227,5 +228,15 @@ std::vector<at::Tensor> ExecuteAndFetch(
   return Fetch(results);
 }
 
+xla::int64 GetCounterValue(const std::string& name) {
+  xla::metrics::CounterData* counter = xla::metrics::GetCounter(name);
+  return counter != nullptr ? counter->Value() : 0;
+}
+
+size_t GetMetricTotalSamples(const std::string& name) {
+  xla::metrics::MetricData* metric = xla::metrics::GetMetric(name);
+  return metric != nullptr ? metric->TotalSamples() : 0;
+}
+
 }  // namespace cpp_test
 }  // namespace torch_xla
@@ -82,5 +82,12 @@ std::vector<at::Tensor> Fetch(
 std::vector<at::Tensor> ExecuteAndFetch(
     tensorflow::gtl::ArraySlice<const ir::Value> roots, const Device& device);
 
+// Returns the value of the given counter, or zero if it has not been created.
+xla::int64 GetCounterValue(const std::string& name);
+
+// Returns the total number of samples recorded by the given metric, or zero if
+// it has not been created.
+size_t GetMetricTotalSamples(const std::string& name);
+
 }  // namespace cpp_test
 }  // namespace torch_xla
@@ -0,0 +1,220 @@
+// Replays the graphs saved by running with XLA_CAPTURE_GRAPHS_DIR set. Every
+// graph is compiled and executed on the selected device, fed with synthetic
+// inputs generated out of the seed stored within its .meta file, and the
+// compile and execute times are reported.
+//
+//   replay_ptxla [--device=CPU:0] [--iterations=10] graph_HASH.hlo.pb ...
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/compiler/xla/literal.h"
+#include "tensorflow/compiler/xla/service/hlo.pb.h"
+#include "tensorflow/compiler/xla/shape_util.h"
+#include "tensorflow/compiler/xla/types.h"
+#include "tensorflow/compiler/xla/xla_client/computation_client.h"
+#include "tensorflow/compiler/xla/xla_client/debug_macros.h"
+#include "tensorflow/compiler/xla/xla_client/metrics.h"
+#include "tensorflow/compiler/xla/xla_client/sys_util.h"
+#include "torch_xla/csrc/debug_util.h"
+
+namespace torch_xla {
+namespace {
+
+const char* const kGraphSuffix = ".hlo.pb";
+
+struct ReplayOptions {
+  std::string device;
+  xla::int64 iterations = 10;
+  std::vector<std::string> graph_paths;
+};
+
+ReplayOptions ParseArguments(int argc, char* argv[]) {
+  ReplayOptions options;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg(argv[i]);
+    if (absl::StartsWith(arg, "--device=")) {
+      options.device = arg.substr(std::strlen("--device="));
+    } else if (absl::StartsWith(arg, "--iterations=")) {
+      options.iterations = std::stoll(arg.substr(std::strlen("--iterations=")));
+    } else {
+      XLA_CHECK(absl::EndsWith(arg, kGraphSuffix))
+          << "Not a captured graph: " << arg;
+      options.graph_paths.push_back(std::move(arg));
+    }
+  }
+  if (options.device.empty()) {
+    options.device = xla::ComputationClient::Get()->GetDefaultDevice();
+  }
+  XLA_CHECK_GT(options.iterations, 0);
+  return options;
+}
+
+xla::HloModuleProto LoadGraph(const std::string& path) {
+  std::ifstream graph_file(path, std::ios::in | std::ios::binary);
+  xla::HloModuleProto proto;
+  XLA_CHECK(proto.ParseFromIstream(&graph_file))
+      << "Failed to load graph " << path;
+  return proto;
+}
+
+// Reads the inputs seed out of the .meta file saved next to the graph.
+xla::uint64 LoadSeed(const std::string& path) {
+  std::string meta_path = absl::StrCat(
+      path.substr(0, path.size() - std::strlen(kGraphSuffix)), ".meta");
+  std::ifstream meta_file(meta_path);
+  XLA_CHECK(meta_file.is_open()) << "Missing graph metadata " << meta_path;
+  xla::uint64 seed = 0;
+  std::string line;
+  while (std::getline(meta_file, line)) {
+    if (absl::StartsWith(line, "seed: ")) {
+      seed = std::stoull(line.substr(std::strlen("seed: ")));
+    } else if (absl::StartsWith(line, "recipe: ")) {
+      XLA_CHECK_EQ(line.substr(std::strlen("recipe: ")),
+                   DebugUtil::kInputsRecipe)
+          << "Unsupported inputs recipe in " << meta_path;
+    }
+  }
+  return seed;
+}
+
+template <typename T, typename D>
+void FillLiteral(D distribution, std::mt19937_64* generator,
+                 xla::Literal* literal) {
+  for (auto& value : literal->data<T>()) {
+    value = static_cast<T>(static_cast<float>(distribution(*generator)));
+  }
+}
+
+// The DebugUtil::kInputsRecipe (uniform-v1) recipe: floating point values
+// within [0, 1), integer values within [0, 8) (which keeps them valid as small
+// sizes or indices), and fair coin flips for predicates.
+xla::Literal MakeInput(const xla::Shape& shape, std::mt19937_64* generator) {
+  xla::Literal literal(xla::ShapeUtil::MakeShapeWithDescendingLayout(
+      shape.element_type(), shape.dimensions()));
+  std::uniform_real_distribution<double> real(0.0, 1.0);
+  std::uniform_int_distribution<int> integer(0, 7);
+  switch (shape.element_type()) {
+    case xla::PrimitiveType::PRED:
+      FillLiteral<bool>(std::bernoulli_distribution(0.5), generator, &literal);
+      break;
+    case xla::PrimitiveType::BF16:
+      FillLiteral<xla::bfloat16>(real, generator, &literal);
+      break;
+    case xla::PrimitiveType::F16:
+      FillLiteral<xla::half>(real, generator, &literal);
+      break;
+    case xla::PrimitiveType::F32:
+      FillLiteral<float>(real, generator, &literal);
+      break;
+    case xla::PrimitiveType::F64:
+      FillLiteral<double>(real, generator, &literal);
+      break;
+    case xla::PrimitiveType::S8:
+      FillLiteral<xla::int8>(integer, generator, &literal);
+      break;
+    case xla::PrimitiveType::U8:
+      FillLiteral<xla::uint8>(integer, generator, &literal);
+      break;
+    case xla::PrimitiveType::S16:
+      FillLiteral<xla::int16>(integer, generator, &literal);
+      break;
+    case xla::PrimitiveType::U16:
+      FillLiteral<xla::uint16>(integer, generator, &literal);
+      break;
+    case xla::PrimitiveType::S32:
+      FillLiteral<xla::int32>(integer, generator, &literal);
+      break;
+    case xla::PrimitiveType::U32:
+      FillLiteral<xla::uint32>(integer, generator, &literal);
+      break;
+    case xla::PrimitiveType::S64:
+      FillLiteral<xla::int64>(integer, generator, &literal);
+      break;
+    case xla::PrimitiveType::U64:
+      FillLiteral<xla::uint64>(integer, generator, &literal);
+      break;
+    default:
+      XLA_ERROR() << "Unsupported parameter type: " << shape;
+  }
+  return literal;
+}
+
+std::vector<xla::ComputationClient::DataPtr> CreateInputs(
+    const xla::ProgramShape& program_shape, xla::uint64 seed,
+    const std::string& device) {
+  std::mt19937_64 generator(seed);
+  std::vector<xla::Literal> literals;
+  std::vector<xla::ComputationClient::TensorSource> sources;
+  for (auto& shape : program_shape.parameters()) {
+    literals.push_back(MakeInput(shape, &generator));
+  }
+  for (size_t i = 0; i < literals.size(); ++i) {
+    const xla::Literal& literal = literals[i];
+    auto populate_fn =
+        [&literal](const xla::ComputationClient::TensorSource& source,
+                   void* dest_buffer, size_t dest_buffer_size) {
+          XLA_CHECK_EQ(dest_buffer_size, literal.size_bytes())
+              << "Device buffer size mismatch for input " << literal.shape();
+          std::memcpy(dest_buffer, literal.untyped_data(), dest_buffer_size);
+        };
+    sources.emplace_back(program_shape.parameters(i), device,
+                         std::move(populate_fn));
+  }
+  return xla::ComputationClient::Get()->TransferToServer(sources);
+}
+
+void ReplayGraph(const std::string& path, const ReplayOptions& options) {
+  xla::XlaComputation computation(LoadGraph(path));
+  xla::ProgramShape program_shape =
+      ConsumeValue(computation.GetProgramShape());
+  std::vector<xla::ComputationClient::DataPtr> inputs =
+      CreateInputs(program_shape, LoadSeed(path), options.device);
+
+  std::vector<xla::ComputationClient::CompileInstance> instances;
+  instances.emplace_back(std::move(computation), options.device,
+                         std::vector<std::string>({options.device}),
+                         /*output_shape=*/nullptr);
+  xla::int64 compile_start_ns = xla::sys_util::NowNs();
+  std::vector<xla::ComputationClient::ComputationPtr> computations =
+      xla::ComputationClient::Get()->Compile(std::move(instances));
+  xla::int64 compile_ns = xla::sys_util::NowNs() - compile_start_ns;
+
+  std::vector<xla::int64> execute_ns;
+  for (xla::int64 i = 0; i < options.iterations; ++i) {
+    xla::int64 execute_start_ns = xla::sys_util::NowNs();
+    xla::ComputationClient::Get()->ExecuteComputation(
+        *computations.front(), inputs, options.device,
+        xla::ComputationClient::ExecuteComputationOptions());
+    execute_ns.push_back(xla::sys_util::NowNs() - execute_start_ns);
+  }
+  std::sort(execute_ns.begin(), execute_ns.end());
+  std::cout << path << ":\n"
+            << "  Parameters: " << program_shape.parameters_size() << "\n"
+            << "  CompileTime: " << xla::metrics::MetricFnTime(compile_ns)
+            << "\n"
+            << "  ExecuteTime: min="
+            << xla::metrics::MetricFnTime(execute_ns.front())
+            << " median="
+            << xla::metrics::MetricFnTime(execute_ns[execute_ns.size() / 2])
+            << " max=" << xla::metrics::MetricFnTime(execute_ns.back())
+            << std::endl;
+}
+
+}  // namespace
+}  // namespace torch_xla
+
+int main(int argc, char* argv[]) {
+  torch_xla::ReplayOptions options = torch_xla::ParseArguments(argc, argv);
+  for (auto& path : options.graph_paths) {
+    torch_xla::ReplayGraph(path, options);
+  }
+  return 0;
+}
@@ -5,15 +5,18 @@ BUILDDIR="$RUNDIR/build"
 BUILDTYPE="Release"
 VERB=
 FILTER=
+FILTER_PATTERN=
 BUILD_ONLY=0
 RMBUILD=1
+BENCH=0
+REPLAY=0
 LOGFILE=/tmp/pytorch_cpp_test.log
 
 if [ "$DEBUG" == "1" ]; then
   BUILDTYPE="Debug"
 fi
 
-while getopts 'VLDKBF:' OPTION
+while getopts 'VLDKBMRF:' OPTION
 do
   case $OPTION in
     V)
@@ -31,8 +34,16 @@ do
     B)
       BUILD_ONLY=1
       ;;
+    M)
+      BENCH=1
+      ;;
+    R)
+      REPLAY=1
+      BUILD_ONLY=1
+      ;;
     F)
       FILTER="--gtest_filter=$OPTARG"
+      FILTER_PATTERN="$OPTARG"
       ;;
   esac
 done
@@ -45,8 +56,16 @@ cmake "$RUNDIR" \
   -DCMAKE_BUILD_TYPE=$BUILDTYPE \
   -DPYTHON_INCLUDE_DIR=$(python -c "from distutils.sysconfig import get_python_inc; print(get_python_inc())") \
   -DPYTHON_LIBRARY=$(python -c "import distutils.sysconfig as sysconfig; print(sysconfig.get_config_var('LIBDIR') + '/' + sysconfig.get_config_var('LDLIBRARY'))")
-make -j $VERB
-if [ $BUILD_ONLY -eq 0 ]; then
+if [ $BENCH -eq 1 ]; then
+  make -j $VERB bench_ptxla
+elif [ $REPLAY -eq 1 ]; then
+  make -j $VERB replay_ptxla
+else
+  make -j $VERB
+fi
+if [ $BUILD_ONLY -eq 0 -a $BENCH -eq 1 ]; then
+  ./bench_ptxla ${FILTER_PATTERN:+"--benchmark_filter=$FILTER_PATTERN"}
+elif [ $BUILD_ONLY -eq 0 ]; then
   if [ "$LOGFILE" != "" ]; then
     ./test_ptxla ${FILTER:+"$FILTER"} 2>$LOGFILE
   else
@@ -3810,10 +3810,7 @@ TEST_F(AtenXlaTensorTest, TestNonzero) {
     AllClose(b, xla_b);
   });
 
-  if (DebugUtil::ExperimentEnabled("nonzero")) {
-    // If the nonzero support is enabled, we must not see any aten:: calls.
-    ExpectCounterNotChanged("aten::.*", cpp_test::GetIgnoredCounters());
-  }
+  ExpectCounterNotChanged("aten::.*", cpp_test::GetIgnoredCounters());
   ExpectCounterChanged("xla::nonzero", cpp_test::GetIgnoredCounters());
 }
 
@@ -3829,13 +3826,50 @@ TEST_F(AtenXlaTensorTest, TestMaskedSelect) {
     AllClose(c, xla_c);
   });
 
-  if (DebugUtil::ExperimentEnabled("masked_select")) {
-    // If the nonzero support is enabled, we must not see any aten:: calls.
-    ExpectCounterNotChanged("aten::.*", cpp_test::GetIgnoredCounters());
-  }
+  ExpectCounterNotChanged("aten::.*", cpp_test::GetIgnoredCounters());
   ExpectCounterChanged("xla::masked_select", cpp_test::GetIgnoredCounters());
 }
 
+TEST_F(AtenXlaTensorTest, TestMaskedScatter) {
+  torch::Tensor a = torch::rand({3, 5}, torch::TensorOptions(torch::kFloat));
+  torch::Tensor b =
+      torch::randint(0, 2, {5}, torch::TensorOptions(torch::kBool));
+  torch::Tensor c = torch::rand({15}, torch::TensorOptions(torch::kFloat));
+  torch::Tensor d = a.masked_scatter(b, c);
+  ForEachDevice([&](const torch::Device& device) {
+    torch::Tensor xla_a = CopyToDevice(a, device);
+    torch::Tensor xla_b = CopyToDevice(b, device);
+    torch::Tensor xla_c = CopyToDevice(c, device);
+    torch::Tensor xla_d = xla_a.masked_scatter(xla_b, xla_c);
+    AllClose(d, xla_d);
+  });
+
+  ExpectCounterNotChanged("aten::.*", cpp_test::GetIgnoredCounters());
+  ExpectCounterChanged("xla::masked_scatter_", cpp_test::GetIgnoredCounters());
+}
+
+TEST_F(AtenXlaTensorTest, TestMaskedScatterSmallSource) {
+  torch::Tensor a = torch::rand({3, 5}, torch::TensorOptions(torch::kFloat));
+  torch::Tensor b =
+      torch::tensor({1, 0, 1, 1, 0}, torch::TensorOptions(torch::kByte))
+          .to(torch::kBool);
+  // The mask selects 9 elements, so a 9 elements source fills all of them,
+  // while an 8 elements one is an error.
+  torch::Tensor c = torch::rand({9}, torch::TensorOptions(torch::kFloat));
+  torch::Tensor d = a.masked_scatter(b, c);
+  ForEachDevice([&](const torch::Device& device) {
+    torch::Tensor xla_a = CopyToDevice(a, device);
+    torch::Tensor xla_b = CopyToDevice(b, device);
+    torch::Tensor xla_c = CopyToDevice(c, device);
+    torch::Tensor xla_d = xla_a.masked_scatter(xla_b, xla_c);
+    AllClose(d, xla_d);
+    EXPECT_THROW(xla_a.masked_scatter(xla_b, xla_c.narrow(0, 0, 8)),
+                 std::exception);
+  });
+
+  ExpectCounterChanged("MaskedSourceSizeCheck", cpp_test::GetIgnoredCounters());
+}
+
 TEST_F(AtenXlaTensorTest, TestMultiIndexHeadNull) {
   for (torch::ScalarType scalar_type :
        {torch::kFloat, torch::kByte, torch::kChar, torch::kShort, torch::kInt,
@@ -4318,13 +4352,60 @@ TEST_F(AtenXlaTensorTest, TestMaskIndexPut) {
         AllEqual(result, xla_result);
       });
 
-      ExpectCounterNotChanged("aten::(?!nonzero).*",
-                              cpp_test::GetIgnoredCounters());
+      ExpectCounterNotChanged("aten::.*", cpp_test::GetIgnoredCounters());
       ExpectCounterChanged("xla::index_put_", cpp_test::GetIgnoredCounters());
     }
   }
 }
 
+TEST_F(AtenXlaTensorTest, TestMaskIndexPutRows) {
+  torch::Tensor params =
+      torch::rand({4, 3}, torch::TensorOptions(torch::kFloat));
+  torch::Tensor indices =
+      torch::tensor({1, 0, 1, 1}, torch::TensorOptions(torch::kByte))
+          .to(torch::kBool);
+  torch::Tensor values =
+      torch::rand({3, 3}, torch::TensorOptions(torch::kFloat));
+  for (bool accumulate : {false, true}) {
+    torch::Tensor result =
+        torch::index_put(params, {indices}, values, accumulate);
+    ForEachDevice([&](const torch::Device& device) {
+      torch::Tensor xla_params = CopyToDevice(params, device);
+      torch::Tensor xla_indices = CopyToDevice(indices, device);
+      torch::Tensor xla_values = CopyToDevice(values, device);
+      torch::Tensor xla_result =
+          torch::index_put(xla_params, {xla_indices}, xla_values, accumulate);
+      AllClose(result, xla_result);
+    });
+
+    ExpectCounterNotChanged("aten::.*", cpp_test::GetIgnoredCounters());
+    ExpectCounterChanged("xla::index_put_", cpp_test::GetIgnoredCounters());
+  }
+}
+
+TEST_F(AtenXlaTensorTest, TestMaskIndexPutFewerRows) {
+  torch::Tensor params =
+      torch::rand({4, 3}, torch::TensorOptions(torch::kFloat));
+  torch::Tensor indices =
+      torch::tensor({1, 0, 1, 1}, torch::TensorOptions(torch::kByte))
+          .to(torch::kBool);
+  // The mask selects 3 rows, but the values only hold 2.
+  torch::Tensor values =
+      torch::rand({2, 3}, torch::TensorOptions(torch::kFloat));
+  for (bool accumulate : {false, true}) {
+    ForEachDevice([&](const torch::Device& device) {
+      torch::Tensor xla_params = CopyToDevice(params, device);
+      torch::Tensor xla_indices = CopyToDevice(indices, device);
+      torch::Tensor xla_values = CopyToDevice(values, device);
+      EXPECT_THROW(
+          torch::index_put(xla_params, {xla_indices}, xla_values, accumulate),
+          std::exception);
+    });
+  }
+
+  ExpectCounterChanged("MaskedSourceSizeCheck", cpp_test::GetIgnoredCounters());
+}
+
 TEST_F(AtenXlaTensorTest, TestIndexPutImpl) {
   torch::Tensor indices =
       torch::randint(-3, 3, {2, 4, 3}, torch::TensorOptions(torch::kLong));
@@ -5516,6 +5597,48 @@ TEST_F(AtenXlaTensorTest, TestViewMod) {
   });
 }
 
+TEST_F(AtenXlaTensorTest, TestViewSliceUpdates) {
+  torch::Tensor source =
+      torch::rand({8, 6}, torch::TensorOptions(torch::kFloat));
+  auto update_slices = [](torch::Tensor input, const torch::Tensor& source) {
+    for (int64_t i = 0; i < source.size(0); ++i) {
+      input.select(0, i).copy_(source.select(0, i) * (i + 1));
+    }
+    input.narrow(0, 2, 4).narrow(1, 1, 3).fill_(-1.0);
+    input.select(1, 5).fill_(2.0);
+  };
+  torch::Tensor input =
+      torch::zeros({8, 6}, torch::TensorOptions(torch::kFloat));
+  torch::Tensor view = input.view({8, 6});
+  update_slices(view, source);
+  ForEachDevice([&](const torch::Device& device) {
+    torch::Tensor xla_input = CopyToDevice(
+        torch::zeros({8, 6}, torch::TensorOptions(torch::kFloat)), device);
+    torch::Tensor xla_source = CopyToDevice(source, device);
+    torch::Tensor xla_view = xla_input.view({8, 6});
+    update_slices(xla_view, xla_source);
+    // The row writes become a single scatter, while the two slice writes of
+    // different sizes are applied on their own.
+    std::string hlo_text = GetTensorHloGraph(xla_input);
+    auto count_ops = [&](const std::string& op) {
+      int count = 0;
+      for (size_t pos = hlo_text.find(op); pos != std::string::npos;
+           pos = hlo_text.find(op, pos + op.size())) {
+        ++count;
+      }
+      return count;
+    };
+    EXPECT_EQ(count_ops(" scatter("), 1);
+    EXPECT_EQ(count_ops(" dynamic-update-slice("), 2);
+    AllClose(view, xla_view);
+    AllClose(input, xla_input);
+  });
+
+  ExpectCounterChanged("ViewSliceUpdates", cpp_test::GetIgnoredCounters());
+  ExpectCounterChanged("ViewSliceUpdatesScattered",
+                       cpp_test::GetIgnoredCounters());
+}
+
 TEST_F(AtenXlaTensorTest, TestViewModComplex) {
   torch::Tensor input =
       torch::zeros({32, 20, 4, 4}, torch::TensorOptions(torch::kFloat));
@@ -6500,6 +6623,45 @@ TEST_F(AtenXlaTensorTest, TestNllLoss) {
   ExpectCounterChanged("xla::nll_loss_forward", cpp_test::GetIgnoredCounters());
 }
 
+TEST_F(AtenXlaTensorTest, TestLogSoftmaxNllLoss) {
+  int batch = 6;
+  int classes = 10;
+  for (int ignore_index : {-100, 3}) {
+    for (bool def_weight : {false, true}) {
+      torch::Tensor input =
+          torch::randn({batch, classes}, torch::TensorOptions(torch::kFloat));
+      torch::Tensor target = torch::randint(0, classes, {batch},
+                                            torch::TensorOptions(torch::kLong));
+      torch::Tensor weight;
+      if (def_weight) {
+        weight = torch::rand({classes}, torch::TensorOptions(torch::kFloat));
+      }
+      for (torch::Reduction::Reduction reduction :
+           {torch::Reduction::Mean, torch::Reduction::Sum,
+            torch::Reduction::None}) {
+        torch::Tensor output = torch::nll_loss(
+            /*self=*/torch::log_softmax(input, 1), /*target=*/target,
+            /*weight=*/weight, /*reduction=*/reduction,
+            /*ignore_index=*/ignore_index);
+        ForEachDevice([&](const torch::Device& device) {
+          torch::Tensor xla_input = CopyToDevice(input, device);
+          torch::Tensor xla_target = CopyToDevice(target, device);
+          torch::Tensor xla_weight =
+              def_weight ? CopyToDevice(weight, device) : torch::Tensor();
+          torch::Tensor xla_output = torch::nll_loss(
+              /*self=*/torch::log_softmax(xla_input, 1), /*target=*/xla_target,
+              /*weight=*/xla_weight, /*reduction=*/reduction,
+              /*ignore_index=*/ignore_index);
+          AllClose(output, xla_output);
+        });
+      }
+    }
+  }
+
+  ExpectCounterNotChanged("aten::.*", cpp_test::GetIgnoredCounters());
+  ExpectCounterChanged("FusedCrossEntropy", cpp_test::GetIgnoredCounters());
+}
+
 TEST_F(AtenXlaTensorTest, TestSmoothL1Loss) {
   torch::Tensor input =
       torch::randn({2, 4}, torch::TensorOptions(torch::kFloat));
@@ -8639,6 +8801,44 @@ TEST_F(AtenXlaTensorTest, TestNllLossBackward) {
                        cpp_test::GetIgnoredCounters());
 }
 
+TEST_F(AtenXlaTensorTest, TestLogSoftmaxNllLossBackward) {
+  int batch = 6;
+  int classes = 10;
+  for (int ignore_index : {-100, 3}) {
+    for (bool def_weight : {false, true}) {
+      torch::Tensor input = torch::randn(
+          {batch, classes},
+          torch::TensorOptions(torch::kFloat).requires_grad(true));
+      torch::Tensor target = torch::randint(0, classes, {batch},
+                                            torch::TensorOptions(torch::kLong));
+      torch::Tensor weight;
+      if (def_weight) {
+        weight = torch::rand({classes}, torch::TensorOptions(torch::kFloat));
+      }
+      for (torch::Reduction::Reduction reduction :
+           {torch::Reduction::Mean, torch::Reduction::Sum,
+            torch::Reduction::None}) {
+        auto testfn =
+            [&](const std::vector<torch::Tensor>& inputs) -> torch::Tensor {
+          return torch::nll_loss(
+              /*self=*/torch::log_softmax(inputs[0], 1), /*target=*/inputs[1],
+              /*weight=*/inputs[2], /*reduction=*/reduction,
+              /*ignore_index=*/ignore_index);
+        };
+        ForEachDevice([&](const torch::Device& device) {
+          TestBackward({input, target, weight}, device, testfn, /*rtol=*/1e-5,
+                       /*atol=*/1e-6);
+        });
+      }
+    }
+  }
+
+  ExpectCounterNotChanged("aten::(?!_local_scalar_dense).*",
+                          cpp_test::GetIgnoredCounters());
+  ExpectCounterChanged("FusedCrossEntropyBackward",
+                       cpp_test::GetIgnoredCounters());
+}
+
 TEST_F(AtenXlaTensorTest, TestSmoothL1LossBackward) {
   torch::Tensor input = torch::randn(
       {2, 4}, torch::TensorOptions(torch::kFloat).requires_grad(true));
@@ -8763,6 +8963,47 @@ TEST_F(AtenXlaTensorTest, TestBatchNorm3DBackward) {
   }
 }
 
+TEST_F(AtenXlaTensorTest, TestBatchNormAddReluBackward) {
+  double momentum = 0.1;
+  double eps = 0.5;
+  int num_features = 3;
+  auto testfn = [&](const std::vector<torch::Tensor>& inputs) -> torch::Tensor {
+    torch::Tensor output = torch::batch_norm(
+        /*input=*/inputs[0], /*weight=*/inputs[1], /*bias=*/inputs[2],
+        /*running_mean=*/inputs[3], /*running_var=*/inputs[4],
+        /*training=*/true, /*momentum=*/momentum, /*eps=*/eps,
+        /*cudnn_enabled=*/false);
+    return torch::relu(output + inputs[5]);
+  };
+  ForEachDevice([&](const torch::Device& device) {
+    torch::Tensor input =
+        torch::randn({2, num_features, 4, 4},
+                     torch::TensorOptions(torch::kFloat).requires_grad(true));
+    torch::Tensor weight =
+        torch::rand({num_features},
+                    torch::TensorOptions(torch::kFloat).requires_grad(true));
+    torch::Tensor bias =
+        torch::randn({num_features},
+                     torch::TensorOptions(torch::kFloat).requires_grad(true));
+    torch::Tensor running_mean =
+        torch::rand({num_features}, torch::TensorOptions(torch::kFloat));
+    torch::Tensor running_var =
+        torch::rand({num_features}, torch::TensorOptions(torch::kFloat));
+    torch::Tensor residual =
+        torch::randn({2, num_features, 4, 4},
+                     torch::TensorOptions(torch::kFloat).requires_grad(true));
+    TestBackward({input, weight, bias, running_mean, running_var, residual},
+                 device, testfn,
+                 /*rtol=*/1e-3, /*atol=*/1e-4);
+  });
+
+  ExpectCounterNotChanged("aten::.*", cpp_test::GetIgnoredCounters());
+  ExpectCounterChanged("xla::native_batch_norm_backward",
+                       cpp_test::GetIgnoredCounters());
+  ExpectCounterChanged("xla::threshold_backward",
+                       cpp_test::GetIgnoredCounters());
+}
+
 TEST_F(AtenXlaTensorTest, TestBCEWithLogitsBackward) {
   int batch = 10;
   int classes = 5;
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "cpp_test_util.h"
+#include "tensorflow/core/example/example.pb.h"
+#include "tensorflow/core/example/feature.pb.h"
+#include "torch_xla/csrc/example_decoder.h"
+
+namespace torch_xla {
+namespace cpp_test {
+namespace {
+
+// More than the minimum number of examples assigned to each decoding thread,
+// so that multiple ranges are decoded concurrently.
+const int64_t kNumExamples = 40;
+
+// Example i has a 2x3 "image" bytes feature with values i..i+5, a scalar
+// "label" equal to i, a "weights" float pair, and i % 6 "tokens" (with the
+// feature missing altogether when the count is zero).
+std::vector<std::string> MakeExamples() {
+  std::vector<std::string> records;
+  for (int64_t i = 0; i < kNumExamples; ++i) {
+    tensorflow::Example example;
+    auto* features = example.mutable_features()->mutable_feature();
+    std::string image;
+    for (int64_t j = 0; j < 6; ++j) {
+      image.push_back(static_cast<char>(i + j));
+    }
+    (*features)["image"].mutable_bytes_list()->add_value(image);
+    (*features)["label"].mutable_int64_list()->add_value(i);
+    auto* weights = (*features)["weights"].mutable_float_list();
+    weights->add_value(0.5 * i);
+    weights->add_value(-0.25 * i);
+    if (i % 6 > 0) {
+      auto* tokens = (*features)["tokens"].mutable_int64_list();
+      for (int64_t j = 0; j < i % 6; ++j) {
+        tokens->add_value(100 * i + j);
+      }
+    }
+    records.push_back(example.SerializeAsString());
+  }
+  return records;
+}
+
+ExampleFeatureSpec MakeSpec(const std::string& name,
+                            at::ScalarType scalar_type,
+                            std::vector<int64_t> shape, bool padded = false,
+                            double default_value = 0) {
+  ExampleFeatureSpec spec;
+  spec.name = name;
+  spec.scalar_type = scalar_type;
+  spec.shape = std::move(shape);
+  spec.padded = padded;
+  spec.default_value = default_value;
+  return spec;
+}
+
+}  // namespace
+
+TEST(ExampleDecoderTest, DecodeDense) {
+  std::vector<ExampleFeatureSpec> specs = {
+      MakeSpec("image", at::kByte, {2, 3}),
+      MakeSpec("label", at::kLong, {}),
+      MakeSpec("weights", at::kDouble, {2}),
+      MakeSpec("tokens", at::kInt, {5}, /*padded=*/true,
+               /*default_value=*/-1)};
+  DecodedExamples decoded = DecodeExamples(MakeExamples(), specs);
+  ASSERT_EQ(decoded.values.size(), specs.size());
+  ASSERT_EQ(decoded.lengths.size(), specs.size());
+
+  const at::Tensor& image = decoded.values[0];
+  EXPECT_EQ(image.scalar_type(), at::kByte);
+  EXPECT_EQ(image.sizes(), at::IntArrayRef({kNumExamples, 2, 3}));
+  const at::Tensor& label = decoded.values[1];
+  EXPECT_EQ(label.scalar_type(), at::kLong);
+  EXPECT_EQ(label.sizes(), at::IntArrayRef({kNumExamples}));
+  const at::Tensor& weights = decoded.values[2];
+  EXPECT_EQ(weights.scalar_type(), at::kDouble);
+  EXPECT_EQ(weights.sizes(), at::IntArrayRef({kNumExamples, 2}));
+  const at::Tensor& tokens = decoded.values[3];
+  EXPECT_EQ(tokens.scalar_type(), at::kInt);
+  EXPECT_EQ(tokens.sizes(), at::IntArrayRef({kNumExamples, 5}));
+
+  // Only the padded feature reports the per example lengths.
+  EXPECT_FALSE(decoded.lengths[0].defined());
+  EXPECT_FALSE(decoded.lengths[1].defined());
+  EXPECT_FALSE(decoded.lengths[2].defined());
+  const at::Tensor& tokens_lengths = decoded.lengths[3];
+  ASSERT_TRUE(tokens_lengths.defined());
+  EXPECT_EQ(tokens_lengths.scalar_type(), at::kLong);
+  EXPECT_EQ(tokens_lengths.sizes(), at::IntArrayRef({kNumExamples}));
+
+  for (int64_t i = 0; i < kNumExamples; ++i) {
+    at::Tensor expected_image =
+        at::arange(i, i + 6, at::TensorOptions(at::kByte)).view({2, 3});
+    AllEqual(image[i], expected_image);
+    EXPECT_EQ(label[i].item<int64_t>(), i);
+    EXPECT_EQ(weights[i][0].item<double>(), 0.5 * i);
+    EXPECT_EQ(weights[i][1].item<double>(), -0.25 * i);
+    int64_t num_tokens = i % 6;
+    EXPECT_EQ(tokens_lengths[i].item<int64_t>(), num_tokens);
+    for (int64_t j = 0; j < 5; ++j) {
+      EXPECT_EQ(tokens[i][j].item<int32_t>(),
+                j < num_tokens ? 100 * i + j : -1);
+    }
+  }
+}
+
+TEST(ExampleDecoderTest, DecodeErrors) {
+  std::vector<std::string> records = MakeExamples();
+  // Non padded features must be present and carry exactly the values their
+  // shape holds.
+  EXPECT_THROW(DecodeExamples(records, {MakeSpec("tokens", at::kInt, {5})}),
+               std::exception);
+  EXPECT_THROW(DecodeExamples(records, {MakeSpec("weights", at::kFloat, {3})}),
+               std::exception);
+  // Padding cannot truncate the values.
+  EXPECT_THROW(DecodeExamples(records, {MakeSpec("weights", at::kFloat, {1},
+                                                 /*padded=*/true)}),
+               std::exception);
+  EXPECT_THROW(DecodeExamples({"not an example"},
+                              {MakeSpec("label", at::kLong, {})}),
+               std::exception);
+}
+
+}  // namespace cpp_test
+}  // namespace torch_xla
@@ -68,5 +68,31 @@ TEST(OpByOpExecutorTest, TestAsyncStack) {
   });
 }
 
+TEST(OpByOpExecutorTest, TestChainedPlanCache) {
+  ForEachDevice([&](const Device& device) {
+    auto run_chain = [&](const at::Tensor& a, const at::Tensor& b) {
+      ir::Value v_a = GetTensorIrValue(a, device);
+      ir::Value v_b = GetTensorIrValue(b, device);
+      ir::Value v_c = (v_a + v_b) * v_a;
+      auto results_data =
+          OpByOpExecutor::Get()->Execute({v_c}, device.ToString(), {});
+      AllClose(Fetch(results_data).front(), (a + b) * a);
+    };
+
+    xla::int64 hits = GetCounterValue("XrtChainedPlanCacheHit");
+    xla::int64 misses = GetCounterValue("XrtChainedPlanCacheMiss");
+    run_chain(at::rand({5, 7, 2}, at::TensorOptions(at::kFloat)),
+              at::rand({5, 7, 2}, at::TensorOptions(at::kFloat)));
+    EXPECT_EQ(GetCounterValue("XrtChainedPlanCacheHit"), hits);
+    EXPECT_EQ(GetCounterValue("XrtChainedPlanCacheMiss"), misses + 1);
+    // The same chain over new device data reuses the plan, with the new data
+    // handles bound to it.
+    run_chain(at::rand({5, 7, 2}, at::TensorOptions(at::kFloat)),
+              at::rand({5, 7, 2}, at::TensorOptions(at::kFloat)));
+    EXPECT_EQ(GetCounterValue("XrtChainedPlanCacheHit"), hits + 1);
+    EXPECT_EQ(GetCounterValue("XrtChainedPlanCacheMiss"), misses + 1);
+  });
+}
+
 }  // namespace cpp_test
 }  // namespace torch_xla
@@ -1,11 +1,28 @@
 #include <ATen/ATen.h>
 #include <gtest/gtest.h>
 
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <limits>
+#include <string>
 #include <vector>
 
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 #include "cpp_test_util.h"
+#include "tensorflow/compiler/xla/client/xla_computation.h"
+#include "tensorflow/compiler/xla/service/hlo.pb.h"
+#include "tensorflow/compiler/xla/xla_client/sys_util.h"
+#include "tensorflow/compiler/xla/xla_client/util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/env.h"
 #include "torch/csrc/autograd/variable.h"
+#include "torch_xla/csrc/debug_util.h"
+#include "torch_xla/csrc/ops/device_data.h"
 #include "torch_xla/csrc/tensor.h"
 #include "torch_xla/csrc/tensor_util.h"
 #include "torch_xla_test.h"
@@ -71,6 +88,24 @@ TEST_F(TensorTest, TestConversions) {
   }
 }
 
+TEST_F(TensorTest, TestStridedHash) {
+  at::Tensor a = at::rand({5, 7, 3}, at::TensorOptions(at::kFloat));
+  std::vector<at::Tensor> strided_tensors = {
+      a.transpose(0, 2), a.permute({1, 2, 0}), a.slice(1, 1, 6, 2),
+      a.select(2, 1)};
+  // Tensors with dense innermost rows, which are hashed one row at a time.
+  at::Tensor b = at::rand({6, 4, 40}, at::TensorOptions(at::kFloat));
+  strided_tensors.push_back(b.slice(0, 1, 6, 2));
+  strided_tensors.push_back(b.slice(1, 0, 3));
+  strided_tensors.push_back(b.select(1, 2));
+  for (auto& t : strided_tensors) {
+    ASSERT_FALSE(t.is_contiguous());
+    EXPECT_EQ(TensorHash(t), TensorHash(t.contiguous()));
+  }
+  EXPECT_NE(TensorHash(a.transpose(0, 2)), TensorHash(a));
+  EXPECT_NE(TensorHash(b.slice(0, 1, 6, 2)), TensorHash(b.slice(0, 0, 5, 2)));
+}
+
 TEST_F(TensorTest, TestAdd) {
   at::Tensor a = at::rand({2, 2}, at::TensorOptions(at::kFloat));
   at::Tensor b = at::rand({2, 2}, at::TensorOptions(at::kFloat));
@@ -85,6 +120,62 @@ TEST_F(TensorTest, TestAdd) {
   });
 }
 
+TEST_F(TensorTest, TestSwapOut) {
+  at::Tensor a = at::rand({4, 3}, at::TensorOptions(at::kFloat));
+  at::Tensor b = a.add(a, 1.0);
+  at::Tensor c = b.add(a, 1.0);
+
+  ForEachDevice([&](const Device& device) {
+    XLATensor dev_a = XLATensor::Create(a, device);
+    XLATensor dev_b = XLATensor::add(dev_a, dev_a, 1.0);
+    std::vector<XLATensor> tensors({dev_b});
+    XLATensor::SyncTensorsGraph(&tensors, {}, /*wait=*/true,
+                                /*sync_xla_data=*/true);
+    EXPECT_NE(dev_b.CurrentXlaData(), nullptr);
+
+    XLATensor::SwapOutTensors(&tensors);
+    EXPECT_EQ(dev_b.CurrentXlaData(), nullptr);
+    AllClose(b, dev_b);
+
+    XLATensor dev_c = XLATensor::add(dev_b, dev_a, 1.0);
+    AllClose(c, dev_c);
+  });
+}
+
+TEST_F(TensorTest, TestSwapIn) {
+  at::Tensor a = at::rand({4, 3}, at::TensorOptions(at::kFloat));
+  at::Tensor b = at::rand({5, 2}, at::TensorOptions(at::kFloat));
+  at::Tensor c = at::rand({3}, at::TensorOptions(at::kFloat));
+
+  ForEachDevice([&](const Device& device) {
+    std::vector<XLATensor> tensors(
+        {XLATensor::Create(TensorToXlaData(a, device)),
+         XLATensor::Create(TensorToXlaData(b, device)),
+         XLATensor::Create(TensorToXlaData(c, device))});
+    XLATensor::SwapOutTensors(&tensors);
+
+    // Using a swapped out tensor uploads it on its own.
+    xla::int64 swap_ins = GetCounterValue("SwapInTensors");
+    size_t transfers = GetMetricTotalSamples("TransferToServerTime");
+    tensors[0].GetIrValue();
+    EXPECT_EQ(GetCounterValue("SwapInTensors"), swap_ins + 1);
+    EXPECT_EQ(GetMetricTotalSamples("TransferToServerTime"), transfers + 1);
+    EXPECT_NE(tensors[0].CurrentXlaData(), nullptr);
+    EXPECT_EQ(tensors[1].CurrentXlaData(), nullptr);
+
+    // The remaining ones are uploaded together, with a single transfer.
+    XLATensor::SwapInTensors(&tensors);
+    EXPECT_EQ(GetCounterValue("SwapInTensors"), swap_ins + 3);
+    EXPECT_EQ(GetMetricTotalSamples("TransferToServerTime"), transfers + 2);
+    EXPECT_NE(tensors[1].CurrentXlaData(), nullptr);
+    EXPECT_NE(tensors[2].CurrentXlaData(), nullptr);
+
+    AllClose(a, tensors[0]);
+    AllClose(b, tensors[1]);
+    AllClose(c, tensors[2]);
+  });
+}
+
 TEST_F(TensorTest, TestIntegerAdd) {
   std::vector<at::ScalarType> types(
       {at::kByte, at::kChar, at::kShort, at::kInt, at::kLong});
@@ -425,6 +516,198 @@ TEST_F(TensorTest, TestBatchNorm1D) {
   }
 }
 
+TEST_F(TensorTest, TestCopyTensorToDevice) {
+  WithAllDevices(DeviceType::CPU, [&](const std::vector<Device>& devices,
+                                      const std::vector<Device>& all_devices) {
+    at::Tensor input = at::rand({4, 3}, at::TensorOptions(at::kFloat));
+    // A tensor with device data only, and one with a pending IR computation.
+    // Neither has a host side copy which could be uploaded to the destination.
+    XLATensor xla_input = XLATensor::Create(TensorToXlaData(input, devices[0]));
+    XLATensor xla_sum = XLATensor::add(xla_input, xla_input, 1.0);
+    // CI runs with a single CPU device, where the copy to the same device
+    // still goes through the device side path.
+    std::vector<Device> dest_devices(
+        devices.begin(), devices.begin() + std::min<size_t>(devices.size(), 2));
+    std::reverse(dest_devices.begin(), dest_devices.end());
+    for (auto& device : dest_devices) {
+      xla::int64 copies = GetCounterValue("DeviceToDeviceCopies");
+      XLATensor xla_copy = xla_input.CopyTensorToDevice(device);
+      EXPECT_EQ(xla_copy.GetDevice(), device);
+      AllClose(input, xla_copy);
+      XLATensor xla_sum_copy = xla_sum.CopyTensorToDevice(device);
+      EXPECT_EQ(xla_sum_copy.GetDevice(), device);
+      AllClose(input + input, xla_sum_copy);
+      EXPECT_EQ(GetCounterValue("DeviceToDeviceCopies"), copies + 2);
+    }
+  });
+}
+
+TEST_F(TensorTest, TestConstantCache) {
+  setenv("XLA_CONSTANT_CACHE_BYTES", "16777216", /*overwrite=*/1);
+  ForEachDevice([&](const Device& device) {
+    // Two distinct host tensors with the same content, which is unlikely to be
+    // already within the cache because of other tests.
+    at::Tensor input = at::rand({7, 5}, at::TensorOptions(at::kFloat)) + 17.0;
+    at::Tensor input_copy = input.clone();
+    XLATensor xla_input = XLATensor::Create(input, device);
+    ir::Value ir_value = xla_input.GetIrValue();
+
+    xla::int64 hits = GetCounterValue("ConstantCacheHit");
+    xla::int64 misses = GetCounterValue("ConstantCacheMiss");
+    size_t transfers = GetMetricTotalSamples("TransferToServerTime");
+    size_t saved = GetMetricTotalSamples("ConstantCacheSavedBytes");
+    XLATensor xla_input_copy = XLATensor::Create(input_copy, device);
+    ir::Value ir_value_copy = xla_input_copy.GetIrValue();
+    EXPECT_EQ(GetCounterValue("ConstantCacheHit"), hits + 1);
+    EXPECT_EQ(GetCounterValue("ConstantCacheMiss"), misses);
+    EXPECT_EQ(GetMetricTotalSamples("TransferToServerTime"), transfers);
+    EXPECT_EQ(GetMetricTotalSamples("ConstantCacheSavedBytes"), saved + 1);
+
+    // Both tensors are backed by the same device data.
+    const ir::ops::DeviceData* device_data =
+        dynamic_cast<const ir::ops::DeviceData*>(ir_value.node.get());
+    const ir::ops::DeviceData* device_data_copy =
+        dynamic_cast<const ir::ops::DeviceData*>(ir_value_copy.node.get());
+    ASSERT_NE(device_data, nullptr);
+    ASSERT_NE(device_data_copy, nullptr);
+    EXPECT_EQ(device_data->data(), device_data_copy->data());
+    AllClose(input, xla_input_copy);
+
+    // A different content misses the cache and gets uploaded.
+    at::Tensor other = input + 1.0;
+    XLATensor::Create(other, device).GetIrValue();
+    EXPECT_EQ(GetCounterValue("ConstantCacheMiss"), misses + 1);
+    EXPECT_EQ(GetMetricTotalSamples("TransferToServerTime"), transfers + 1);
+  });
+  unsetenv("XLA_CONSTANT_CACHE_BYTES");
+}
+
+TEST_F(TensorTest, TestConstantCacheNaN) {
+  setenv("XLA_CONSTANT_CACHE_BYTES", "16777216", /*overwrite=*/1);
+  ForEachDevice([&](const Device& device) {
+    // Tensors holding NaNs never compare equal by value, but they still match
+    // by content. So does a non contiguous tensor with the same values.
+    at::Tensor input = at::rand({6, 4}, at::TensorOptions(at::kFloat)) + 23.0;
+    input[2][3] = std::numeric_limits<float>::quiet_NaN();
+    XLATensor::Create(input, device).GetIrValue();
+
+    xla::int64 hits = GetCounterValue("ConstantCacheHit");
+    xla::int64 misses = GetCounterValue("ConstantCacheMiss");
+    XLATensor::Create(input.clone(), device).GetIrValue();
+    XLATensor::Create(input.t().contiguous().t(), device).GetIrValue();
+    EXPECT_EQ(GetCounterValue("ConstantCacheHit"), hits + 2);
+    EXPECT_EQ(GetCounterValue("ConstantCacheMiss"), misses);
+  });
+  unsetenv("XLA_CONSTANT_CACHE_BYTES");
+}
+
+TEST_F(TensorTest, TestConstantCacheEviction) {
+  const xla::int64 kTensorBytes = 1024 * 1024;
+  const xla::int64 kCacheTensors = 4;
+  setenv("XLA_CONSTANT_CACHE_BYTES",
+         std::to_string(kCacheTensors * kTensorBytes).c_str(),
+         /*overwrite=*/1);
+  xla::int64 num_tensors = kCacheTensors + 2;
+  ForEachDevice([&](const Device& device) {
+    xla::int64 evictions = GetCounterValue("ConstantCacheEvictions");
+    at::Tensor input =
+        at::rand({kTensorBytes / 4}, at::TensorOptions(at::kFloat));
+    for (xla::int64 i = 0; i < num_tensors; ++i) {
+      XLATensor::Create(input + static_cast<double>(i), device).GetIrValue();
+    }
+    EXPECT_GT(GetCounterValue("ConstantCacheEvictions"), evictions);
+    // The oldest entry has been evicted, so it is uploaded again.
+    xla::int64 misses = GetCounterValue("ConstantCacheMiss");
+    XLATensor::Create(input.clone(), device).GetIrValue();
+    EXPECT_EQ(GetCounterValue("ConstantCacheMiss"), misses + 1);
+  });
+  unsetenv("XLA_CONSTANT_CACHE_BYTES");
+}
+
+TEST_F(TensorTest, TestConstantCacheDisabled) {
+  // The cache is off by default, and host tensors are uploaded every time.
+  if (xla::sys_util::GetEnvInt("XLA_CONSTANT_CACHE_BYTES", 0) > 0) {
+    GTEST_SKIP();
+  }
+  ForEachDevice([&](const Device& device) {
+    at::Tensor input = at::rand({7, 5}, at::TensorOptions(at::kFloat)) + 23.0;
+    xla::int64 hits = GetCounterValue("ConstantCacheHit");
+    xla::int64 misses = GetCounterValue("ConstantCacheMiss");
+    size_t transfers = GetMetricTotalSamples("TransferToServerTime");
+    XLATensor::Create(input, device).GetIrValue();
+    XLATensor::Create(input.clone(), device).GetIrValue();
+    EXPECT_EQ(GetCounterValue("ConstantCacheHit"), hits);
+    EXPECT_EQ(GetCounterValue("ConstantCacheMiss"), misses);
+    EXPECT_EQ(GetMetricTotalSamples("TransferToServerTime"), transfers + 2);
+  });
+}
+
+TEST_F(TensorTest, TestCaptureGraphs) {
+  static const char* const kGraphSuffix = ".hlo.pb";
+  std::string capture_dir = tensorflow::io::JoinPath(
+      ::testing::TempDir(), absl::StrCat("capture_graphs_", ::getpid()));
+  setenv("XLA_CAPTURE_GRAPHS_DIR", capture_dir.c_str(), /*overwrite=*/1);
+  xla::util::ExceptionCleanup remove_capture_dir(
+      [&](std::exception_ptr exptr) {
+        tensorflow::int64 undeleted_files = 0;
+        tensorflow::int64 undeleted_dirs = 0;
+        tensorflow::Env::Default()
+            ->DeleteRecursively(capture_dir, &undeleted_files, &undeleted_dirs)
+            .IgnoreError();
+      });
+  ForEachDevice([&](const Device& device) {
+    // A graph unlikely to be already compiled by other tests.
+    at::Tensor a = at::rand({3, 7, 11}, at::TensorOptions(at::kFloat));
+    at::Tensor b = at::rand({3, 7, 11}, at::TensorOptions(at::kFloat));
+    XLATensor dev_a = XLATensor::Create(a, device);
+    XLATensor dev_b = XLATensor::Create(b, device);
+    XLATensor dev_c = XLATensor::mul(XLATensor::add(dev_a, dev_b, 1.0), dev_a);
+    AllClose(a.add(b, 1.0).mul(a), dev_c);
+  });
+  unsetenv("XLA_CAPTURE_GRAPHS_DIR");
+
+  std::vector<std::string> children;
+  TF_CHECK_OK(tensorflow::Env::Default()->GetChildren(capture_dir, &children));
+  size_t num_graphs = 0;
+  for (auto& child : children) {
+    if (!absl::EndsWith(child, kGraphSuffix)) {
+      continue;
+    }
+    ++num_graphs;
+    std::string path = tensorflow::io::JoinPath(capture_dir, child);
+    std::ifstream graph_file(path, std::ios::in | std::ios::binary);
+    xla::HloModuleProto proto;
+    ASSERT_TRUE(proto.ParseFromIstream(&graph_file)) << path;
+    xla::XlaComputation computation(std::move(proto));
+    xla::ProgramShape program_shape =
+        ConsumeValue(computation.GetProgramShape());
+
+    std::string base_path =
+        path.substr(0, path.size() - std::strlen(kGraphSuffix));
+    std::ifstream meta_file(absl::StrCat(base_path, ".meta"));
+    ASSERT_TRUE(meta_file.is_open()) << base_path;
+    std::string line;
+    std::string seed;
+    std::string recipe;
+    int num_parameters = 0;
+    while (std::getline(meta_file, line)) {
+      if (absl::StartsWith(line, "seed: ")) {
+        seed = line.substr(6);
+      } else if (absl::StartsWith(line, "recipe: ")) {
+        recipe = line.substr(8);
+      } else if (absl::StartsWith(line, "parameter: ")) {
+        ++num_parameters;
+      }
+    }
+    // The graph hash names the files, and seeds the replay inputs.
+    EXPECT_TRUE(absl::EndsWith(base_path, absl::StrCat("/graph_", seed)))
+        << base_path;
+    EXPECT_EQ(recipe, DebugUtil::kInputsRecipe);
+    EXPECT_EQ(num_parameters, program_shape.parameters_size());
+  }
+  EXPECT_GT(num_graphs, 0);
+}
+
 TEST_F(TensorTest, TestConv2D) {
   int in_channels = 9;
   int out_channels = 3;
@@ -0,0 +1,211 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "cpp_test_util.h"
+#include "tensorflow/compiler/xla/xla_client/metrics.h"
+
+namespace torch_xla {
+namespace cpp_test {
+namespace {
+
+void RunThreads(int num_threads, const std::function<void(int)>& fn) {
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back(fn, i);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+}  // namespace
+
+TEST(XlaMetricsTest, HistogramBuckets) {
+  for (double value = 0; value < 1e12; value += 1 + value / 97) {
+    size_t index = xla::metrics::HistogramData::BucketIndex(value);
+    double bucket_value = xla::metrics::HistogramData::BucketValue(index);
+    EXPECT_LE(std::abs(bucket_value - std::floor(value)),
+              std::max(0.5, value / 60.0))
+        << "value=" << value;
+    if (value >= 1.0) {
+      EXPECT_GT(index, xla::metrics::HistogramData::BucketIndex(value / 2))
+          << "value=" << value;
+    }
+  }
+  EXPECT_EQ(xla::metrics::HistogramData::BucketIndex(-5.0), 0u);
+  EXPECT_EQ(xla::metrics::HistogramData::BucketIndex(1e300),
+            xla::metrics::HistogramData::BucketIndex(1e19));
+}
+
+TEST(XlaMetricsTest, HistogramPercentiles) {
+  std::mt19937_64 generator(11);
+  std::lognormal_distribution<double> distribution(12.0, 2.0);
+  xla::metrics::HistogramData histogram;
+  std::vector<double> values;
+  for (int i = 0; i < 100000; ++i) {
+    values.push_back(distribution(generator));
+    histogram.AddSample(values.back());
+  }
+  std::sort(values.begin(), values.end());
+  xla::metrics::HistogramSnapshot snapshot = histogram.Snapshot();
+  EXPECT_EQ(snapshot.count, values.size());
+  EXPECT_EQ(snapshot.min, values.front());
+  EXPECT_EQ(snapshot.max, values.back());
+  for (double fraction : {0.01, 0.1, 0.5, 0.9, 0.99, 1.0}) {
+    double exact =
+        values[static_cast<size_t>(std::ceil(fraction * values.size())) - 1];
+    EXPECT_NEAR(snapshot.Percentile(fraction), exact, exact * 0.02)
+        << "fraction=" << fraction;
+  }
+}
+
+TEST(XlaMetricsTest, ConcurrentSamples) {
+  // More threads than exclusive shards, to exercise the shared one as well.
+  const int kNumThreads = xla::metrics::HistogramData::kExclusiveShards + 4;
+  const int kNumSamples = 10000;
+  xla::metrics::MetricData data(xla::metrics::MetricFnValue, 64);
+  RunThreads(kNumThreads, [&](int thread) {
+    for (int i = 0; i < kNumSamples; ++i) {
+      data.AddSample(i, thread + 1);
+    }
+  });
+  double accumulator = 0.0;
+  size_t total_samples = 0;
+  std::vector<xla::metrics::Sample> samples =
+      data.Samples(&accumulator, &total_samples);
+  EXPECT_EQ(total_samples, static_cast<size_t>(kNumThreads * kNumSamples));
+  EXPECT_EQ(accumulator, kNumSamples * kNumThreads * (kNumThreads + 1) / 2);
+  EXPECT_EQ(samples.size(), 64u);
+  xla::metrics::HistogramSnapshot snapshot = data.Histogram();
+  EXPECT_EQ(snapshot.min, 1.0);
+  EXPECT_EQ(snapshot.max, kNumThreads);
+}
+
+TEST(XlaMetricsTest, ConcurrentReads) {
+  // Every sample is posted with a value matching its timestamp, so readers
+  // must never observe them mismatched, even while the writers run.
+  const int kNumThreads = 4;
+  const int kNumSamples = 100000;
+  xla::metrics::MetricData data(xla::metrics::MetricFnValue, 32);
+  std::atomic<bool> done(false);
+  std::thread reader([&]() {
+    while (!done.load()) {
+      for (auto& sample : data.Samples(nullptr, nullptr)) {
+        ASSERT_EQ(static_cast<double>(sample.timestamp_ns), sample.value);
+      }
+    }
+  });
+  RunThreads(kNumThreads, [&](int thread) {
+    for (int i = 0; i < kNumSamples; ++i) {
+      xla::int64 sample_id = thread * kNumSamples + i + 1;
+      data.AddSample(sample_id, sample_id);
+    }
+  });
+  done = true;
+  reader.join();
+  EXPECT_EQ(data.Samples(nullptr, nullptr).size(), 32u);
+}
+
+TEST(XlaMetricsTest, ConcurrentSlotWriters) {
+  // With a two slots buffer, writers whose positions differ by the buffer
+  // size race on the same slot all the time, and must not mix their samples.
+  const int kNumThreads = 8;
+  const int kNumSamples = 20000;
+  xla::metrics::MetricData data(xla::metrics::MetricFnValue, 2);
+  std::atomic<bool> done(false);
+  std::thread reader([&]() {
+    while (!done.load()) {
+      for (auto& sample : data.Samples(nullptr, nullptr)) {
+        ASSERT_EQ(static_cast<double>(sample.timestamp_ns), sample.value);
+      }
+    }
+  });
+  RunThreads(kNumThreads, [&](int thread) {
+    for (int i = 0; i < kNumSamples; ++i) {
+      xla::int64 sample_id = thread * kNumSamples + i + 1;
+      data.AddSample(sample_id, sample_id);
+    }
+  });
+  done = true;
+  reader.join();
+  std::vector<xla::metrics::Sample> samples = data.Samples(nullptr, nullptr);
+  EXPECT_EQ(samples.size(), 2u);
+  for (auto& sample : samples) {
+    EXPECT_EQ(static_cast<double>(sample.timestamp_ns), sample.value);
+  }
+}
+
+TEST(XlaMetricsTest, StepDeltas) {
+  xla::metrics::Counter counter("StepDeltasTestCounter");
+  xla::metrics::Metric metric("StepDeltasTestMetric");
+  counter.AddValue(3);
+  metric.AddSample(5.0);
+  xla::metrics::CaptureStepDelta();
+  std::string delta = xla::metrics::GetLastStepDeltaJson();
+  EXPECT_NE(delta.find("\"StepDeltasTestCounter\":3"), std::string::npos);
+  EXPECT_NE(delta.find("\"StepDeltasTestMetric\":{\"samples\":1"),
+            std::string::npos);
+
+  counter.AddValue(2);
+  xla::metrics::CaptureStepDelta();
+  delta = xla::metrics::GetLastStepDeltaJson();
+  EXPECT_NE(delta.find("\"StepDeltasTestCounter\":2"), std::string::npos);
+  EXPECT_EQ(delta.find("StepDeltasTestMetric"), std::string::npos);
+
+  std::string report = xla::metrics::CreateMetricReportJson();
+  EXPECT_NE(report.find("\"StepDeltasTestCounter\":5"), std::string::npos);
+  EXPECT_NE(report.find("\"StepDeltasTestMetric\":{\"total_samples\":1"),
+            std::string::npos);
+}
+
+TEST(XlaMetricsTest, JsonNonFiniteValues) {
+  xla::metrics::Metric metric("JsonNonFiniteTestMetric");
+  metric.AddSample(std::numeric_limits<double>::infinity());
+  metric.AddSample(std::numeric_limits<double>::quiet_NaN());
+  xla::metrics::CaptureStepDelta();
+  // JSON has no representation for NaN and infinite values, which are emitted
+  // as null.
+  std::string report = xla::metrics::CreateMetricReportJson();
+  EXPECT_NE(report.find("\"JsonNonFiniteTestMetric\":{\"total_samples\":2,"
+                        "\"accumulator\":null"),
+            std::string::npos);
+  EXPECT_EQ(report.find(":nan"), std::string::npos);
+  EXPECT_EQ(report.find(":inf"), std::string::npos);
+  std::string delta = xla::metrics::GetLastStepDeltaJson();
+  EXPECT_NE(delta.find("\"JsonNonFiniteTestMetric\":{\"samples\":2,"
+                       "\"accumulator\":null}"),
+            std::string::npos);
+}
+
+TEST(XlaMetricsTest, DISABLED_AddSampleBenchmark) {
+  const int kNumSamples = 2000000;
+  for (int num_threads : {1, 2, 4, 8, 32}) {
+    xla::metrics::Metric metric("AddSampleBenchmark",
+                                xla::metrics::MetricFnTime);
+    auto start = std::chrono::steady_clock::now();
+    RunThreads(num_threads, [&](int thread) {
+      for (int i = 0; i < kNumSamples; ++i) {
+        metric.AddSample(i, i % 1000);
+      }
+    });
+    double elapsed = std::chrono::duration<double, std::nano>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    // With perfect scaling, the time per sample stays constant when adding
+    // threads, as each thread posts kNumSamples samples.
+    std::cout << "Threads=" << num_threads
+              << " NsPerSample=" << elapsed / kNumSamples << std::endl;
+  }
+}
+
+}  // namespace cpp_test
+}  // namespace torch_xla
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+#include "cpp_test_util.h"
+#include "tensorflow/compiler/xla/xla_client/util.h"
+#include "tensorflow/core/lib/hash/hash.h"
+
+namespace torch_xla {
+namespace cpp_test {
+namespace {
+
+std::vector<char> RandomBytes(size_t size) {
+  std::mt19937_64 generator(size);
+  std::vector<char> data(size);
+  for (auto& value : data) {
+    value = static_cast<char>(generator());
+  }
+  return data;
+}
+
+}  // namespace
+
+TEST(XlaUtilHashTest, IncrementalTest) {
+  std::vector<char> data = RandomBytes(3000);
+  std::mt19937 generator(17);
+  for (size_t size = 0; size < data.size(); ++size) {
+    xla::uint64 hash = xla::util::FastHash64(data.data(), size, 11);
+    for (size_t max_chunk : {1, 7, 64, 300, 1000}) {
+      xla::util::FastHasher hasher(11);
+      for (size_t pos = 0; pos < size;) {
+        size_t count =
+            std::min<size_t>(size - pos, 1 + generator() % max_chunk);
+        hasher.Update(data.data() + pos, count);
+        pos += count;
+      }
+      ASSERT_EQ(hasher.Digest(), hash)
+          << "size=" << size << " max_chunk=" << max_chunk;
+    }
+  }
+}
+
+TEST(XlaUtilHashTest, CollisionTest) {
+  // Single bit flips, at every position, must all produce different hashes.
+  for (size_t size : {1, 3, 4, 8, 9, 16, 17, 64, 100, 128, 129, 256, 257, 1025,
+                      4096}) {
+    std::vector<char> data = RandomBytes(size);
+    std::unordered_set<xla::uint64> hashes;
+    hashes.insert(xla::util::FastHash64(data.data(), size, 0));
+    for (size_t bit = 0; bit < size * 8; ++bit) {
+      data[bit / 8] ^= 1 << (bit % 8);
+      hashes.insert(xla::util::FastHash64(data.data(), size, 0));
+      data[bit / 8] ^= 1 << (bit % 8);
+    }
+    EXPECT_EQ(hashes.size(), size * 8 + 1) << "size=" << size;
+  }
+  // Zero filled buffers of different sizes, and different seeds.
+  std::vector<char> zeros(2048, 0);
+  std::unordered_set<xla::uint64> hashes;
+  for (size_t size = 0; size < zeros.size(); ++size) {
+    hashes.insert(xla::util::FastHash64(zeros.data(), size, 0));
+    hashes.insert(xla::util::FastHash64(zeros.data(), size, 1));
+  }
+  EXPECT_EQ(hashes.size(), 2 * zeros.size());
+  // Sequential integers, like the ones used to hash IR node attributes.
+  hashes.clear();
+  for (xla::int64 i = 0; i < 50000; ++i) {
+    hashes.insert(xla::util::DataHash(&i, sizeof(i)));
+  }
+  EXPECT_EQ(hashes.size(), 50000);
+}
+
+// Run with --gtest_also_run_disabled_tests to get the throughput numbers.
+TEST(XlaUtilHashTest, DISABLED_Benchmark) {
+  std::vector<char> data = RandomBytes(64 * 1024 * 1024);
+  for (size_t size : {16, 64, 256, 4096, 65536, 1048576, 67108864}) {
+    size_t iterations = std::max<size_t>(1, (1 << 28) / size);
+    auto run = [&](const std::function<xla::uint64(size_t)>& fn) {
+      xla::uint64 sum = 0;
+      auto start = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < iterations; ++i) {
+        sum += fn(i);
+      }
+      std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start;
+      EXPECT_NE(sum, 0);
+      return iterations * size / elapsed.count() / 1e9;
+    };
+    double fast_rate = run([&](size_t i) {
+      return xla::util::FastHash64(data.data(), size, i);
+    });
+    double tf_rate = run([&](size_t i) {
+      return tensorflow::Hash64(data.data(), size, i);
+    });
+    std::cout << "Size " << size << ": FastHash64 " << fast_rate
+              << " GB/s, Hash64 " << tf_rate << " GB/s\n";
+  }
+}
+
+}  // namespace cpp_test
+}  // namespace torch_xla
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "cpp_test_util.h"
+#include "tensorflow/compiler/xla/xla_client/record_reader.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/io/record_writer.h"
+#include "tensorflow/core/platform/env.h"
+
+namespace torch_xla {
+namespace cpp_test {
+namespace {
+
+// Writes one TfRecord file per entry of num_records, whose records are named
+// after the file and record indices (ie, "f1-r0"). Returns the files paths.
+std::vector<std::string> WriteRecordFiles(
+    const std::string& name, const std::vector<int>& num_records) {
+  std::vector<std::string> paths;
+  for (size_t i = 0; i < num_records.size(); ++i) {
+    std::string path = tensorflow::io::JoinPath(
+        ::testing::TempDir(), absl::StrCat(name, "_", i, ".tfrecord"));
+    std::unique_ptr<tensorflow::WritableFile> file;
+    TF_CHECK_OK(tensorflow::Env::Default()->NewWritableFile(path, &file));
+    tensorflow::io::RecordWriter writer(file.get());
+    for (int j = 0; j < num_records[i]; ++j) {
+      TF_CHECK_OK(writer.WriteRecord(absl::StrCat("f", i, "-r", j)));
+    }
+    TF_CHECK_OK(writer.Close());
+    TF_CHECK_OK(file->Close());
+    paths.push_back(std::move(path));
+  }
+  return paths;
+}
+
+std::vector<std::string> ReadAll(xla::util::InterleavedRecordReader* reader) {
+  std::vector<std::string> records;
+  std::string value;
+  while (reader->Read(&value)) {
+    records.push_back(value);
+  }
+  return records;
+}
+
+}  // namespace
+
+TEST(XlaUtilRecordReaderTest, InterleaveOrder) {
+  std::vector<std::string> paths =
+      WriteRecordFiles("interleave_order", {3, 1, 4});
+  xla::util::InterleavedRecordReader::Options options;
+  options.cycle_length = 2;
+  options.block_length = 2;
+  xla::util::InterleavedRecordReader reader(paths, options);
+  // Exhausted files are replaced within their cycle slot by the next one.
+  std::vector<std::string> expected = {"f0-r0", "f0-r1", "f1-r0", "f2-r0",
+                                       "f2-r1", "f0-r2", "f2-r2", "f2-r3"};
+  EXPECT_EQ(ReadAll(&reader), expected);
+  // The end of data is sticky.
+  std::string value;
+  EXPECT_FALSE(reader.Read(&value));
+}
+
+TEST(XlaUtilRecordReaderTest, Shards) {
+  std::vector<std::string> paths = WriteRecordFiles("shards", {2, 1, 2, 3});
+  xla::util::InterleavedRecordReader::Options options;
+  options.cycle_length = 4;
+  options.num_shards = 2;
+  options.shard_ordinal = 1;
+  xla::util::InterleavedRecordReader reader(paths, options);
+  std::vector<std::string> expected = {"f1-r0", "f3-r0", "f3-r1", "f3-r2"};
+  EXPECT_EQ(ReadAll(&reader), expected);
+}
+
+TEST(XlaUtilRecordReaderTest, Readahead) {
+  std::vector<std::string> paths = WriteRecordFiles("readahead", {5, 5, 5});
+  xla::util::InterleavedRecordReader::Options options;
+  options.cycle_length = 3;
+  options.prefetch_records = 8;
+  xla::int64 prefetches = GetCounterValue("InterleavedRecordPrefetches");
+  xla::util::InterleavedRecordReader reader(paths, options);
+  // The whole initial cycle is read in background at construction, so once
+  // the small files have been buffered, no read has to wait for them.
+  while (GetCounterValue("InterleavedRecordPrefetches") < prefetches + 15) {
+    std::this_thread::yield();
+  }
+  size_t waits = GetMetricTotalSamples("InterleavedRecordReaderWait");
+  std::vector<std::string> records = ReadAll(&reader);
+  EXPECT_EQ(records.size(), 15u);
+  EXPECT_EQ(GetMetricTotalSamples("InterleavedRecordReaderWait"), waits);
+}
+
+TEST(XlaUtilRecordReaderTest, SmallPrefetchBuffer) {
+  // A buffer smaller than the files forces the background fill to stop and be
+  // rescheduled by the consumer multiple times.
+  std::vector<std::string> paths = WriteRecordFiles("small_prefetch", {50});
+  xla::util::InterleavedRecordReader::Options options;
+  options.cycle_length = 1;
+  options.prefetch_records = 2;
+  xla::util::InterleavedRecordReader reader(paths, options);
+  std::vector<std::string> records = ReadAll(&reader);
+  ASSERT_EQ(records.size(), 50u);
+  for (size_t i = 0; i < records.size(); ++i) {
+    EXPECT_EQ(records[i], absl::StrCat("f0-r", i));
+  }
+}
+
+TEST(XlaUtilRecordReaderTest, ReadBatch) {
+  std::vector<std::string> paths = WriteRecordFiles("read_batch", {3, 4});
+  xla::util::InterleavedRecordReader::Options options;
+  xla::util::InterleavedRecordReader reader(paths, options);
+  std::vector<std::string> records;
+  EXPECT_EQ(reader.ReadBatch(5, &records), 5u);
+  EXPECT_EQ(reader.ReadBatch(5, &records), 2u);
+  EXPECT_EQ(reader.ReadBatch(5, &records), 0u);
+  std::vector<std::string> expected = {"f0-r0", "f1-r0", "f0-r1", "f1-r1",
+                                       "f0-r2", "f1-r2", "f1-r3"};
+  EXPECT_EQ(records, expected);
+}
+
+}  // namespace cpp_test
+}  // namespace torch_xla
@@ -18,11 +18,13 @@ sys.argv = [sys.argv[0]] + leftovers
 import collections
 import copy
 import itertools
+import json
 import math
 from numbers import Number
 import numpy
 import random
 import re
+import subprocess
 import torch
 import torch.nn as nn
 import torch.nn.functional as F
@@ -31,6 +33,7 @@ import torch_xla
 import torch_xla.distributed.data_parallel as dp
 import torch_xla.debug.metrics as met
 import torch_xla.debug.model_comparator as mc
+import torch_xla.debug.tracer as tracer
 import torch_xla.distributed.parallel_loader as pl
 import torch_xla.utils.utils as xu
 import torch_xla.core.xla_model as xm
@@ -754,6 +757,58 @@ class TestAtenXlaTensor(XlaTestCase):
         torch.zeros(shape, device=xm.xla_device(), dtype=torch.uint8), 6, 10)
     self.assertEqual(x.device.type, 'xla')
 
+  def test_rng_state(self):
+    xla_device = xm.xla_device()
+
+    def dropout_step():
+      x = torch.ones(64, 32, device=xla_device)
+      y = F.dropout(x, p=0.5, training=True)
+      xm.mark_step()
+      return y.cpu()
+
+    xm.set_rng_state(7)
+    self.assertEqual(xm.get_rng_state(), 7)
+    y1 = dropout_step()
+    y2 = dropout_step()
+    self.assertNotEqual(xm.get_rng_state(), 7)
+    self.assertFalse(torch.equal(y1, y2))
+    compiles = met.metric_data('CompileTime')[0]
+    xm.set_rng_state(7)
+    self.assertEqual(dropout_step(), y1)
+    self.assertEqual(dropout_step(), y2)
+    # The seed is a graph input, so new seeds do not trigger new compilations.
+    self.assertEqual(met.metric_data('CompileTime')[0], compiles)
+
+  def test_rng_offsets_sync(self):
+    xla_device = xm.xla_device()
+
+    def dropout_sync():
+      x = torch.ones(48, 16, device=xla_device)
+      return F.dropout(x, p=0.5, training=True).cpu()
+
+    # Syncing through cpu() without a mark_step() restarts the random offsets,
+    # so the same random operations trace the same graph.
+    y1 = dropout_sync()
+    compiles = met.metric_data('CompileTime')[0]
+    y2 = dropout_sync()
+    y3 = dropout_sync()
+    self.assertEqual(met.metric_data('CompileTime')[0], compiles)
+    self.assertFalse(torch.equal(y1, y2))
+    self.assertFalse(torch.equal(y2, y3))
+
+  def test_sync_tensors(self):
+    xla_device = xm.xla_device()
+    x = torch.rand(4, 4).to(xla_device)
+    hidden = x * 2
+    output = hidden.sum()
+    unrelated = x + 3
+    xm.sync_tensors([output], wait=True)
+    for tensor in [output, hidden]:
+      self.assertNotIn('aten::',
+                       torch_xla._XLAC._get_xla_tensors_text([tensor]))
+    self.assertIn('aten::', torch_xla._XLAC._get_xla_tensors_text([unrelated]))
+    self.assertEqual(unrelated.cpu(), x.cpu() + 3)
+
   def test_no_storage(self):
     x = torch.randn(5, device=xm.xla_device())
     self.assertRaises(Exception, x.device)
@@ -1296,6 +1351,174 @@ class TestAtenXlaTensor(XlaTestCase):
     loaded_model = cpu_model.to(xla_device)
     self.assertEqual(model.state_dict(), loaded_model.state_dict())
 
+  def test_save_checkpoint_api(self):
+    xla_device = xm.xla_device()
+    model = XlaMNIST().to(xla_device)
+    tmpdir = xu.TmpFolder()
+    path = os.path.join(tmpdir.name, 'checkpoint')
+    # Use small batch and shard sizes, to exercise multiple batches and shards.
+    xm.save_checkpoint(
+        {
+            'model': model.state_dict(),
+            'step': 17
+        },
+        path,
+        batch_bytes=16 * 1024,
+        shard_bytes=64 * 1024)
+    self.assertTrue(os.path.exists(path + '.manifest'))
+    self.assertTrue(os.path.exists(path + '.shard-00001'))
+    data = xm.load_checkpoint(path)
+    self.assertEqual(data['step'], 17)
+    cpu_model = XlaMNIST()
+    cpu_model.load_state_dict(data['model'])
+    self.assertEqual(model.state_dict(), cpu_model.to(xla_device).state_dict())
+    data = xm.load_checkpoint(path, device=xla_device)
+    self.assertEqual(model.state_dict(), data['model'])
+
+  def test_trace(self):
+    xla_device = xm.xla_device()
+    tracer.start_trace()
+    try:
+      x = torch.rand(4, 4, device=xla_device)
+      y = x.mm(x) + 1.0
+      xm.mark_step()
+      y.cpu()
+    finally:
+      tracer.stop_trace()
+    trace = json.loads(tracer.dump_trace())
+    names = set(event['name'] for event in trace['traceEvents'])
+    self.assertIn('SyncTensorsGraph', names)
+    self.assertIn('TransferFromServer', names)
+    tracer.clear_trace()
+    self.assertEqual(json.loads(tracer.dump_trace())['traceEvents'], [])
+
+  def test_step_metrics(self):
+    xla_device = xm.xla_device()
+    met.set_step_metrics_deltas(True)
+    try:
+      x = torch.rand(4, 4, device=xla_device)
+      xm.mark_step()
+      y = x.mm(x) + 1.0
+      xm.mark_step()
+      step_metrics = met.last_step_metrics()
+    finally:
+      met.set_step_metrics_deltas(False)
+    self.assertIsNotNone(step_metrics)
+    self.assertEqual(step_metrics['counters']['MarkStep'], 1)
+    self.assertIn('CreateXlaTensor', step_metrics['counters'])
+    report = met.metrics_report_json()
+    self.assertGreater(report['counters']['MarkStep'], 1)
+    for metric in report['metrics'].values():
+      self.assertIn('99', metric['percentiles'])
+
+  def test_op_profile(self):
+    xla_device = xm.xla_device()
+    met.reset_op_profile()
+    met.set_op_profiling(True)
+    try:
+      x = torch.rand(4, 4, device=xla_device)
+      for _ in range(64):
+        x = x + 1.0
+    finally:
+      met.set_op_profiling(False)
+    report = met.op_profile_report()
+    self.assertIn('Op: xla::add', report)
+    self.assertIn('Bridge=', report)
+
+  def test_fallback_report(self):
+    xla_device = xm.xla_device()
+    met.reset_fallback_report()
+    x = torch.rand(4, 4, device=xla_device)
+    y = torch.median(x) + 1
+    self.assertEqual(y.cpu(), torch.median(x.cpu()) + 1)
+    report = met.fallback_report()
+    self.assertIn('Fallback: aten::median', report)
+    self.assertIn('test_operations.py', report)
+
+  def test_fallback_batched_uploads(self):
+    xla_device = xm.xla_device()
+    x = torch.rand(8, 6, device=xla_device)
+    xm.mark_step()
+
+    def counter(name):
+      return met.counter_value(name) or 0
+
+    queued = counter('QueuedDeviceUploads')
+    flushes = counter('QueuedDeviceUploadsFlush')
+    # Every median call is a CPU fallback with two outputs, which stay on host
+    # until the first of them is needed on device.
+    values0, indices0 = torch.median(x, dim=0)
+    values1, indices1 = torch.median(x, dim=1)
+    self.assertEqual(counter('QueuedDeviceUploads'), queued + 4)
+    self.assertEqual(counter('QueuedDeviceUploadsFlush'), flushes)
+    y = values0.sum() + values1.sum() + indices0.sum() + indices1.sum()
+    self.assertEqual(counter('QueuedDeviceUploadsFlush'), flushes + 1)
+    xm.mark_step()
+    xcpu = x.cpu()
+    self.assertEqual(
+        y.cpu(),
+        xcpu.median(dim=0)[0].sum() + xcpu.median(dim=1)[0].sum() +
+        xcpu.median(dim=0)[1].sum() + xcpu.median(dim=1)[1].sum())
+    # Tensors created out of host data elsewhere are not queued.
+    torch.ones(3, 3).to(xla_device).sum()
+    self.assertEqual(counter('QueuedDeviceUploads'), queued + 4)
+
+  def test_layouts_profile(self):
+
+    def run_profiled(code, record):
+      env = dict(os.environ)
+      env['XLA_LAYOUTS_PROFILE'] = profile_path
+      env['XLA_LAYOUTS_PROFILE_RECORD'] = '1' if record else '0'
+      script = ('import torch\n'
+                'import torch_xla\n'
+                'import torch_xla.core.xla_model as xm\n'
+                'import torch_xla.debug.metrics as met\n'
+                'device = xm.xla_device()\n') + code
+      return subprocess.check_output([sys.executable, '-c', script],
+                                     env=env).decode()
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+      profile_path = os.path.join(tmpdir, 'layouts.txt')
+      # The recording run saves the result layouts chosen by the compiler.
+      output = run_profiled(
+          'x = torch.rand(6, 10, device=device)\n'
+          'y = torch.mm(x.t(), x)\n'
+          'xm.mark_step()\n'
+          'print(met.counter_value("LayoutProfileSaves"))\n',
+          record=True)
+      self.assertGreater(int(output.split()[-1]), 0)
+      layouts = {}
+      with open(profile_path) as fd:
+        for line in fd:
+          dims, layout = line.strip().split('=')
+          layouts[dims] = [int(x) for x in layout.split(',')]
+      self.assertIn('10,10', layouts)
+      self.assertEqual(sorted(layouts['10,10']), [0, 1])
+      # A following run loads the profile, and uses the saved layout for the
+      # device data of the same shape.
+      output = run_profiled(
+          'x = torch.rand(10, 10, device=device)\n'
+          'xm.mark_step()\n'
+          'print(torch_xla._XLAC._get_xla_tensors_hlo([x]))\n',
+          record=False)
+      self.assertIn(
+          'f32[10,10]{{{}}}'.format(','.join(
+              str(x) for x in layouts['10,10'])), output)
+
+  def test_mask_indexing(self):
+    xla_device = xm.xla_device()
+    x = torch.rand(4, 3)
+    mask = x[:, 0] > 0.5
+    xla_x = x.to(xla_device)
+    xla_mask = mask.to(xla_device)
+    met.reset_fallback_report()
+    self.assertEqual(xla_x[xla_mask].cpu(), x[mask])
+    self.assertEqual(torch.nonzero(xla_mask).cpu(), torch.nonzero(mask))
+    x[mask] = 2.0
+    xla_x[xla_mask] = 2.0
+    self.assertEqual(xla_x.cpu(), x)
+    self.assertNotIn('Fallback:', met.fallback_report())
+
   def test_deepcopy(self):
     xla_device = xm.xla_device()
     x = torch.rand(5, device=xla_device)
@@ -1389,6 +1612,42 @@ class TestGeneric(XlaTestCase):
     dt = xm.send_cpu_data_to_device([t], xla_device)
     self.assertTrue(dt[0].requires_grad)
 
+  def test_get_tensors_async(self):
+    xla_device = xm.xla_device()
+    a = torch.rand(4, 3)
+    b = torch.rand(4, 3)
+    xa = a.to(xla_device)
+    xb = b.to(xla_device)
+    xc = xa * xb + 1.0
+    future = torch_xla._XLAC._xla_get_tensors_async([xc, xa, xb.sum()])
+    # Tracing can continue, while the values are fetched in background.
+    xa.add_(1.0)
+    results = future.wait()
+    self.assertEqual(len(results), 3)
+    self.assertEqual(results[0], a * b + 1.0)
+    self.assertEqual(results[1], a)
+    self.assertEqual(results[2], b.sum())
+    self.assertEqual(xa.cpu(), a + 1.0)
+
+  def test_async_step_closures(self):
+    xla_device = xm.xla_device()
+    a = torch.rand(4, 3)
+    xa = a.to(xla_device)
+    values = []
+
+    def closure(step, t):
+      self.assertEqual(t.device.type, 'cpu')
+      values.append((step, t))
+
+    for step in range(3):
+      xa = xa * 2.0
+      xm.add_step_closure(closure, args=(step, xa), run_async=True)
+      xm.mark_step()
+    xm.wait_step_closures()
+    self.assertEqual([step for step, _ in values], [0, 1, 2])
+    for step, t in values:
+      self.assertEqual(t, a * 2.0**(step + 1))
+
   def test_util_foreach_api(self):
 
     class ForTest(object):
@@ -305,6 +305,12 @@ metrics::Metric* ComputationClient::TransferFromServerMetric() {
   return metric;
 }
 
+metrics::Metric* ComputationClient::TransferToDeviceMetric() {
+  static metrics::Metric* metric =
+      new metrics::Metric("TransferToDeviceTime", metrics::MetricFnTime);
+  return metric;
+}
+
 metrics::Metric* ComputationClient::CompileMetric() {
   static metrics::Metric* metric =
       new metrics::Metric("CompileTime", metrics::MetricFnTime);
@@ -154,6 +154,13 @@ class ComputationClient {
   virtual std::vector<Literal> TransferFromServer(
       tensorflow::gtl::ArraySlice<const DataPtr> handles) = 0;
 
+  // Copies the device data behind the supplied handles to the given device,
+  // without staging it through the client host. The copies use the same shapes
+  // (layouts included) of the source data.
+  virtual std::vector<DataPtr> TransferToDevice(
+      tensorflow::gtl::ArraySlice<const DataPtr> handles,
+      const string& device) = 0;
+
   // Compiles a set of computations.
   virtual std::vector<ComputationPtr> Compile(
       std::vector<CompileInstance> instances) = 0;
@@ -254,6 +261,7 @@ class ComputationClient {
   // Metrics common to all client intrfaces.
   static metrics::Metric* TransferToServerMetric();
   static metrics::Metric* TransferFromServerMetric();
+  static metrics::Metric* TransferToDeviceMetric();
   static metrics::Metric* CompileMetric();
   static metrics::Metric* ExecuteMetric();
   static metrics::Metric* ExecuteReplicatedMetric();
@@ -1,9 +1,13 @@
 #include "tensorflow/compiler/xla/xla_client/metrics.h"
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include <map>
 #include <sstream>
+#include <thread>
 
+#include "tensorflow/compiler/xla/xla_client/sys_util.h"
 #include "tensorflow/compiler/xla/xla_client/util.h"
 #include "tensorflow/core/platform/default/logging.h"
 #include "tensorflow/core/platform/macros.h"
@@ -12,6 +16,77 @@ namespace xla {
 namespace metrics {
 namespace {
 
+// Each power of two range is split into 2^kSubBucketBits linear buckets.
+static const int kSubBucketBits = 5;
+static const uint64 kSubBuckets = 1 << kSubBucketBits;
+// Linear buckets for the [0, kSubBuckets) range, plus kSubBuckets buckets for
+// each power of two range up to 2^63.
+static const size_t kNumBuckets = kSubBuckets * (64 - kSubBucketBits);
+// The buckets of a shard are allocated on demand, in groups of kSubBuckets,
+// since a metric usually spans only a few power of two ranges.
+static const size_t kNumBucketGroups = kNumBuckets / kSubBuckets;
+// The position of a sample slot while a writer owns it.
+static const uint64 kWritingPosition = std::numeric_limits<uint64>::max();
+
+// Assigns to the calling thread one of the exclusive histogram shard slots,
+// while available, and returns it to the free pool at thread exit. Threads
+// which find no free slot get HistogramData::kExclusiveShards, which is the
+// index of the shared shard.
+class ThreadShardSlot {
+ public:
+  ThreadShardSlot() {
+    std::lock_guard<std::mutex> lock(*GetLock());
+    std::vector<size_t>* free_slots = GetFreeSlots();
+    if (!free_slots->empty()) {
+      slot_ = free_slots->back();
+      free_slots->pop_back();
+    }
+  }
+
+  ~ThreadShardSlot() {
+    if (slot_ < HistogramData::kExclusiveShards) {
+      std::lock_guard<std::mutex> lock(*GetLock());
+      GetFreeSlots()->push_back(slot_);
+    }
+  }
+
+  size_t slot() const { return slot_; }
+
+ private:
+  static std::mutex* GetLock() {
+    static std::mutex* lock = new std::mutex();
+    return lock;
+  }
+
+  static std::vector<size_t>* GetFreeSlots() {
+    static std::vector<size_t>* free_slots = []() {
+      std::vector<size_t>* slots = new std::vector<size_t>();
+      for (size_t i = HistogramData::kExclusiveShards; i > 0; --i) {
+        slots->push_back(i - 1);
+      }
+      return slots;
+    }();
+    return free_slots;
+  }
+
+  size_t slot_ = HistogramData::kExclusiveShards;
+};
+
+size_t GetThreadShardSlot() {
+  static thread_local ThreadShardSlot thread_slot;
+  return thread_slot.slot();
+}
+
+template <typename T, typename F>
+void AtomicUpdate(std::atomic<T>* target, F update_fn) {
+  T current = target->load(std::memory_order_relaxed);
+  T value;
+  while (update_fn(current, &value) &&
+         !target->compare_exchange_weak(current, value,
+                                        std::memory_order_relaxed)) {
+  }
+}
+
 class MetricsArena {
  public:
   static MetricsArena* Get();
@@ -107,12 +182,11 @@ void MetricsArena::ForEachCounter(
 
 void EmitMetricInfo(const string& name, MetricData* data,
                     std::stringstream* ss) {
-  double accumulator = 0.0;
-  size_t total_samples = 0;
-  std::vector<Sample> samples = data->Samples(&accumulator, &total_samples);
+  std::vector<Sample> samples = data->Samples(nullptr, nullptr);
+  HistogramSnapshot histogram = data->Histogram();
   (*ss) << "Metric: " << name << std::endl;
-  (*ss) << "  TotalSamples: " << total_samples << std::endl;
-  (*ss) << "  Accumulator: " << data->Repr(accumulator) << std::endl;
+  (*ss) << "  TotalSamples: " << histogram.count << std::endl;
+  (*ss) << "  Accumulator: " << data->Repr(histogram.sum) << std::endl;
   if (!samples.empty()) {
     double total = 0.0;
     for (auto& sample : samples) {
@@ -130,20 +204,21 @@ void EmitMetricInfo(const string& name, MetricData* data,
     }
   }
 
+  if (histogram.count > 0) {
+    (*ss) << "  Min: " << data->Repr(histogram.min)
+          << "; Max: " << data->Repr(histogram.max) << std::endl;
+  }
+
   const int kNumPercentiles = 9;
   static double const kPercentiles[kNumPercentiles] = {
       0.01, 0.05, 0.1, 0.2, 0.5, 0.8, 0.9, 0.95, 0.99};
-  std::sort(
-      samples.begin(), samples.end(),
-      [](const Sample& s1, const Sample& s2) { return s1.value < s2.value; });
   (*ss) << "  Percentiles: ";
   for (int i = 0; i < kNumPercentiles; ++i) {
-    size_t index = kPercentiles[i] * samples.size();
     if (i > 0) {
       (*ss) << "; ";
     }
     (*ss) << (kPercentiles[i] * 100.0)
-          << "%=" << data->Repr(samples[index].value);
+          << "%=" << data->Repr(histogram.Percentile(kPercentiles[i]));
   }
   (*ss) << std::endl;
 }
@@ -154,46 +229,395 @@ void EmitCounterInfo(const string& name, CounterData* data,
   (*ss) << "  Value: " << data->Value() << std::endl;
 }
 
+// Wraps a value to be emitted as JSON number, or as null for NaN and infinite
+// values, which JSON cannot represent.
+struct JsonDouble {
+  explicit JsonDouble(double value) : value(value) {}
+
+  double value;
+};
+
+std::ostream& operator<<(std::ostream& stream, const JsonDouble& jvalue) {
+  if (std::isfinite(jvalue.value)) {
+    return stream << jvalue.value;
+  }
+  return stream << "null";
+}
+
+void EmitMetricJson(const string& name, MetricData* data,
+                    std::stringstream* ss) {
+  const int kNumPercentiles = 5;
+  static int const kPercentiles[kNumPercentiles] = {1, 10, 50, 90, 99};
+  HistogramSnapshot histogram = data->Histogram();
+  (*ss) << util::JsonQuote(name) << ":{\"total_samples\":" << histogram.count
+        << ",\"accumulator\":" << JsonDouble(histogram.sum)
+        << ",\"min\":" << JsonDouble(histogram.min)
+        << ",\"max\":" << JsonDouble(histogram.max) << ",\"percentiles\":{";
+  for (int i = 0; i < kNumPercentiles; ++i) {
+    if (i > 0) {
+      (*ss) << ",";
+    }
+    (*ss) << "\"" << kPercentiles[i] << "\":"
+          << JsonDouble(histogram.Percentile(kPercentiles[i] / 100.0));
+  }
+  (*ss) << "}}";
+}
+
+// Keeps the counters and metrics values seen at the previous step, which are
+// needed to compute the deltas.
+class StepDeltaTracker {
+ public:
+  static StepDeltaTracker* Get() {
+    static StepDeltaTracker* tracker = new StepDeltaTracker();
+    return tracker;
+  }
+
+  void Capture() {
+    std::lock_guard<std::mutex> lock(lock_);
+    int64 now_ns = sys_util::NowNs();
+    std::stringstream ss;
+    ss.precision(15);
+    ss << "{\"step\":" << step_ << ",\"time_ns\":" << (now_ns - last_ns_)
+       << ",\"counters\":{";
+    bool first = true;
+    MetricsArena* arena = MetricsArena::Get();
+    arena->ForEachCounter([&](const string& name, CounterData* data) {
+      int64 value = data->Value();
+      int64& last_value = counters_[name];
+      if (value != last_value) {
+        ss << (first ? "" : ",") << util::JsonQuote(name) << ":"
+           << (value - last_value);
+        first = false;
+        last_value = value;
+      }
+    });
+    ss << "},\"metrics\":{";
+    first = true;
+    arena->ForEachMetric([&](const string& name, MetricData* data) {
+      MetricState state = {data->TotalSamples(), data->Accumulator()};
+      MetricState& last_state = metrics_[name];
+      if (state.count != last_state.count) {
+        ss << (first ? "" : ",") << util::JsonQuote(name)
+           << ":{\"samples\":" << (state.count - last_state.count)
+           << ",\"accumulator\":" << JsonDouble(state.sum - last_state.sum)
+           << "}";
+        first = false;
+        last_state = state;
+      }
+    });
+    ss << "}}";
+    last_json_ = ss.str();
+    last_ns_ = now_ns;
+    ++step_;
+  }
+
+  string GetLastJson() {
+    std::lock_guard<std::mutex> lock(lock_);
+    return last_json_;
+  }
+
+ private:
+  struct MetricState {
+    uint64 count = 0;
+    double sum = 0.0;
+  };
+
+  StepDeltaTracker() : last_ns_(sys_util::NowNs()) {}
+
+  std::mutex lock_;
+  int64 step_ = 0;
+  int64 last_ns_ = 0;
+  std::map<string, int64> counters_;
+  std::map<string, MetricState> metrics_;
+  string last_json_;
+};
+
+std::atomic<bool>* GetStepDeltasFlag() {
+  static std::atomic<bool>* enabled = new std::atomic<bool>(
+      sys_util::GetEnvBool("XLA_METRICS_STEP_DELTAS", false) ||
+      !sys_util::GetEnvString("XLA_METRICS_JSON_FILE", "").empty());
+  return enabled;
+}
+
 }  // namespace
 
-MetricData::MetricData(MetricReprFn repr_fn, size_t max_samples)
-    : repr_fn_(std::move(repr_fn)), samples_(max_samples) {}
+double HistogramSnapshot::Percentile(double fraction) const {
+  if (count == 0) {
+    return 0.0;
+  }
+  uint64 rank = std::max<uint64>(
+      static_cast<uint64>(std::ceil(fraction * static_cast<double>(count))), 1);
+  uint64 cumulative = 0;
+  for (size_t i = 0; i < buckets.size(); ++i) {
+    cumulative += buckets[i];
+    if (cumulative >= rank) {
+      return std::min(std::max(HistogramData::BucketValue(i), min), max);
+    }
+  }
+  return max;
+}
 
-void MetricData::AddSample(int64 timestamp_ns, double value) {
-  std::lock_guard<std::mutex> lock(lock_);
-  size_t position = count_ % samples_.size();
-  ++count_;
-  accumulator_ += value;
-  samples_[position] = Sample(timestamp_ns, value);
+struct HistogramData::Shard {
+  Shard()
+      : count(0),
+        sum(0.0),
+        min(std::numeric_limits<double>::infinity()),
+        max(-std::numeric_limits<double>::infinity()) {
+    for (auto& group : bucket_groups) {
+      group.store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  ~Shard() {
+    for (auto& group : bucket_groups) {
+      delete[] group.load(std::memory_order_relaxed);
+    }
+  }
+
+  std::atomic<uint64>& GetBucket(size_t index) {
+    std::atomic<std::atomic<uint64>*>& group =
+        bucket_groups[index / kSubBuckets];
+    std::atomic<uint64>* buckets = group.load(std::memory_order_acquire);
+    if (TF_PREDICT_FALSE(buckets == nullptr)) {
+      std::unique_ptr<std::atomic<uint64>[]> new_buckets(
+          new std::atomic<uint64>[kSubBuckets]);
+      for (size_t i = 0; i < kSubBuckets; ++i) {
+        new_buckets[i].store(0, std::memory_order_relaxed);
+      }
+      // Only the shared shard can have concurrent writers racing here.
+      if (group.compare_exchange_strong(buckets, new_buckets.get(),
+                                        std::memory_order_acq_rel)) {
+        buckets = new_buckets.release();
+      }
+    }
+    return buckets[index % kSubBuckets];
+  }
+
+  std::atomic<uint64> count;
+  std::atomic<double> sum;
+  std::atomic<double> min;
+  std::atomic<double> max;
+  std::atomic<std::atomic<uint64>*> bucket_groups[kNumBucketGroups];
+};
+
+HistogramData::HistogramData() {
+  for (auto& shard : shards_) {
+    shard.store(nullptr);
+  }
 }
 
-double MetricData::Accumulator() const {
-  std::lock_guard<std::mutex> lock(lock_);
-  return accumulator_;
+HistogramData::~HistogramData() {
+  for (auto& shard : shards_) {
+    delete shard.load();
+  }
 }
 
-size_t MetricData::TotalSamples() const {
-  std::lock_guard<std::mutex> lock(lock_);
-  return count_;
+size_t HistogramData::BucketIndex(double value) {
+  // The NaN values end up in the first bucket as well.
+  if (!(value >= 1.0)) {
+    return 0;
+  }
+  uint64 ivalue = value < 9.2e18 ? static_cast<uint64>(value)
+                                 : std::numeric_limits<int64>::max();
+  if (ivalue < kSubBuckets) {
+    return ivalue;
+  }
+  int msb = 63 - __builtin_clzll(ivalue);
+  int shift = msb - kSubBucketBits;
+  return kSubBuckets * (shift + 1) + ((ivalue >> shift) - kSubBuckets);
+}
+
+double HistogramData::BucketValue(size_t index) {
+  if (index < kSubBuckets) {
+    return static_cast<double>(index);
+  }
+  int shift = static_cast<int>(index / kSubBuckets) - 1;
+  uint64 lower = (kSubBuckets + index % kSubBuckets) << shift;
+  // Return the middle point of the [lower, lower + 2^shift) range.
+  return static_cast<double>(lower) +
+         0.5 * static_cast<double>(uint64(1) << shift);
+}
+
+HistogramData::Shard* HistogramData::GetShard(size_t index) {
+  std::atomic<Shard*>& slot = shards_[index];
+  Shard* shard = slot.load(std::memory_order_acquire);
+  if (TF_PREDICT_FALSE(shard == nullptr)) {
+    std::unique_ptr<Shard> new_shard(new Shard());
+    if (slot.compare_exchange_strong(shard, new_shard.get(),
+                                     std::memory_order_acq_rel)) {
+      shard = new_shard.release();
+    }
+  }
+  return shard;
+}
+
+void HistogramData::AddSample(double value) {
+  size_t index = GetThreadShardSlot();
+  Shard* shard = GetShard(index);
+  std::atomic<uint64>& bucket = shard->GetBucket(BucketIndex(value));
+  if (TF_PREDICT_TRUE(index < kExclusiveShards)) {
+    // This thread is the only writer of the shard, so there is no need for
+    // atomic read-modify-write operations. Readers merging the shards can
+    // observe a sample partially applied, which is fine for our purposes.
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1,
+                 std::memory_order_relaxed);
+    shard->count.store(shard->count.load(std::memory_order_relaxed) + 1,
+                       std::memory_order_relaxed);
+    shard->sum.store(shard->sum.load(std::memory_order_relaxed) + value,
+                     std::memory_order_relaxed);
+    if (value < shard->min.load(std::memory_order_relaxed)) {
+      shard->min.store(value, std::memory_order_relaxed);
+    }
+    if (value > shard->max.load(std::memory_order_relaxed)) {
+      shard->max.store(value, std::memory_order_relaxed);
+    }
+  } else {
+    bucket.fetch_add(1, std::memory_order_relaxed);
+    shard->count.fetch_add(1, std::memory_order_relaxed);
+    AtomicUpdate(&shard->sum, [value](double current, double* result) {
+      *result = current + value;
+      return true;
+    });
+    AtomicUpdate(&shard->min, [value](double current, double* result) {
+      *result = value;
+      return value < current;
+    });
+    AtomicUpdate(&shard->max, [value](double current, double* result) {
+      *result = value;
+      return value > current;
+    });
+  }
+}
+
+uint64 HistogramData::Count() const {
+  uint64 count = 0;
+  for (auto& slot : shards_) {
+    Shard* shard = slot.load(std::memory_order_acquire);
+    if (shard != nullptr) {
+      count += shard->count.load(std::memory_order_relaxed);
+    }
+  }
+  return count;
+}
+
+double HistogramData::Sum() const {
+  double sum = 0.0;
+  for (auto& slot : shards_) {
+    Shard* shard = slot.load(std::memory_order_acquire);
+    if (shard != nullptr) {
+      sum += shard->sum.load(std::memory_order_relaxed);
+    }
+  }
+  return sum;
+}
+
+HistogramSnapshot HistogramData::Snapshot() const {
+  HistogramSnapshot snapshot;
+  snapshot.buckets.resize(kNumBuckets, 0);
+  snapshot.min = std::numeric_limits<double>::infinity();
+  snapshot.max = -std::numeric_limits<double>::infinity();
+  for (auto& slot : shards_) {
+    Shard* shard = slot.load(std::memory_order_acquire);
+    if (shard == nullptr) {
+      continue;
+    }
+    snapshot.sum += shard->sum.load(std::memory_order_relaxed);
+    snapshot.min =
+        std::min(snapshot.min, shard->min.load(std::memory_order_relaxed));
+    snapshot.max =
+        std::max(snapshot.max, shard->max.load(std::memory_order_relaxed));
+    for (size_t g = 0; g < kNumBucketGroups; ++g) {
+      const std::atomic<uint64>* buckets =
+          shard->bucket_groups[g].load(std::memory_order_acquire);
+      if (buckets == nullptr) {
+        continue;
+      }
+      for (size_t i = 0; i < kSubBuckets; ++i) {
+        snapshot.buckets[g * kSubBuckets + i] +=
+            buckets[i].load(std::memory_order_relaxed);
+      }
+    }
+  }
+  for (auto bucket_count : snapshot.buckets) {
+    snapshot.count += bucket_count;
+  }
+  if (snapshot.count == 0) {
+    snapshot.min = 0.0;
+    snapshot.max = 0.0;
+  }
+  return snapshot;
+}
+
+MetricData::MetricData(MetricReprFn repr_fn, size_t max_samples)
+    : repr_fn_(std::move(repr_fn)),
+      max_samples_(max_samples),
+      samples_(new SampleSlot[max_samples]),
+      count_(0) {
+  for (size_t i = 0; i < max_samples_; ++i) {
+    samples_[i].position.store(0, std::memory_order_relaxed);
+    samples_[i].timestamp_ns.store(0, std::memory_order_relaxed);
+    samples_[i].value.store(0.0, std::memory_order_relaxed);
+  }
 }
 
+void MetricData::AddSample(int64 timestamp_ns, double value) {
+  histogram_.AddSample(value);
+  if (max_samples_ > 0) {
+    uint64 position = count_.fetch_add(1, std::memory_order_relaxed);
+    SampleSlot& slot = samples_[position % max_samples_];
+    // Sequence lock style publication: the writer claims the slot by swapping
+    // its position with kWritingPosition, and then publishes it with the (one
+    // based) position of the sample. Writers whose positions differ by
+    // max_samples_ thus never interleave their stores, and a sample which is
+    // older than the one already published in the slot is dropped.
+    uint64 slot_position = slot.position.load(std::memory_order_relaxed);
+    while (true) {
+      if (slot_position == kWritingPosition) {
+        std::this_thread::yield();
+        slot_position = slot.position.load(std::memory_order_relaxed);
+      } else if (slot_position > position) {
+        return;
+      } else if (slot.position.compare_exchange_weak(
+                     slot_position, kWritingPosition,
+                     std::memory_order_acquire, std::memory_order_relaxed)) {
+        break;
+      }
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.timestamp_ns.store(timestamp_ns, std::memory_order_relaxed);
+    slot.value.store(value, std::memory_order_relaxed);
+    slot.position.store(position + 1, std::memory_order_release);
+  }
+}
+
+double MetricData::Accumulator() const { return histogram_.Sum(); }
+
+size_t MetricData::TotalSamples() const { return histogram_.Count(); }
+
 std::vector<Sample> MetricData::Samples(double* accumulator,
                                         size_t* total_samples) const {
-  std::lock_guard<std::mutex> lock(lock_);
+  uint64 count = count_.load(std::memory_order_acquire);
+  uint64 num_samples = std::min<uint64>(count, max_samples_);
   std::vector<Sample> samples;
-  if (count_ <= samples_.size()) {
-    samples.insert(samples.end(), samples_.begin(), samples_.begin() + count_);
-  } else {
-    size_t position = count_ % samples_.size();
-    samples.insert(samples.end(), samples_.begin() + position, samples_.end());
-    samples.insert(samples.end(), samples_.begin(),
-                   samples_.begin() + position);
+  samples.reserve(num_samples);
+  for (uint64 i = count - num_samples; i < count; ++i) {
+    const SampleSlot& slot = samples_[i % max_samples_];
+    if (slot.position.load(std::memory_order_acquire) != i + 1) {
+      // Not yet published, or already overwritten by a newer sample.
+      continue;
+    }
+    Sample sample(slot.timestamp_ns.load(std::memory_order_relaxed),
+                  slot.value.load(std::memory_order_relaxed));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.position.load(std::memory_order_relaxed) == i + 1) {
+      samples.push_back(sample);
+    }
   }
   if (accumulator != nullptr) {
-    *accumulator = accumulator_;
+    *accumulator = histogram_.Sum();
   }
   if (total_samples != nullptr) {
-    *total_samples = count_;
+    *total_samples = histogram_.Count();
   }
   return samples;
 }
@@ -314,6 +738,39 @@ string CreateMetricReport() {
   return ss.str();
 }
 
+string CreateMetricReportJson() {
+  MetricsArena* arena = MetricsArena::Get();
+  std::stringstream ss;
+  ss.precision(15);
+  ss << "{\"counters\":{";
+  bool first = true;
+  arena->ForEachCounter([&](const string& name, CounterData* data) {
+    ss << (first ? "" : ",") << util::JsonQuote(name) << ":" << data->Value();
+    first = false;
+  });
+  ss << "},\"metrics\":{";
+  first = true;
+  arena->ForEachMetric([&](const string& name, MetricData* data) {
+    if (!first) {
+      ss << ",";
+    }
+    first = false;
+    EmitMetricJson(name, data, &ss);
+  });
+  ss << "}}";
+  return ss.str();
+}
+
+bool StepDeltasEnabled() {
+  return GetStepDeltasFlag()->load(std::memory_order_relaxed);
+}
+
+void SetStepDeltasEnabled(bool enabled) { GetStepDeltasFlag()->store(enabled); }
+
+void CaptureStepDelta() { StepDeltaTracker::Get()->Capture(); }
+
+string GetLastStepDeltaJson() { return StepDeltaTracker::Get()->GetLastJson(); }
+
 std::vector<string> GetMetricNames() {
   return MetricsArena::Get()->GetMetricNames();
 }
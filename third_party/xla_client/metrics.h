@@ -25,8 +25,58 @@ struct Sample {
 
 using MetricReprFn = std::function<string(double)>;
 
-// Class used to collect time-stamped numeric samples. The samples are stored in
-// a circular buffer whose size can be configured at constructor time.
+// A point in time view of the content of a HistogramData object.
+struct HistogramSnapshot {
+  // Returns the approximated value below which the given fraction (within the
+  // [0, 1] range) of the samples fall.
+  double Percentile(double fraction) const;
+
+  uint64 count = 0;
+  double sum = 0.0;
+  double min = 0.0;
+  double max = 0.0;
+  std::vector<uint64> buckets;
+};
+
+// Log-linear (HDR style) histogram of non-negative values, with a relative
+// precision of about 1.5%, and absolute precision of one unit for values lower
+// than 32. Count, sum, minimum and maximum are exact. Samples are recorded in
+// per-thread shards, so that concurrent writers never block nor share cache
+// lines, and the shards are merged on read. Threads exceeding the number of
+// exclusive shards share an additional one, updated with atomic operations.
+class HistogramData {
+ public:
+  static const size_t kExclusiveShards = 16;
+
+  HistogramData();
+
+  ~HistogramData();
+
+  void AddSample(double value);
+
+  uint64 Count() const;
+
+  double Sum() const;
+
+  HistogramSnapshot Snapshot() const;
+
+  static size_t BucketIndex(double value);
+
+  // Returns the value representative of the bucket at the given index.
+  static double BucketValue(size_t index);
+
+ private:
+  struct Shard;
+
+  Shard* GetShard(size_t index);
+
+  std::atomic<Shard*> shards_[kExclusiveShards + 1];
+};
+
+// Class used to collect time-stamped numeric samples. All the samples are
+// accounted in a HistogramData, while the most recent ones are also stored in
+// a circular buffer whose size can be configured at constructor time. Posting
+// samples never blocks.
 class MetricData {
  public:
   // Creates a new MetricData object with the internal circular buffer storing
@@ -45,16 +95,28 @@ class MetricData {
   // newer. If accumulator is not nullptr, it will receive the current value of
   // the metrics' accumulator (the sum of all posted values). If total_samples
   // is not nullptr, it will receive the count of the posted values.
+  // Note that the circular buffer is not locked, so samples concurrently
+  // posted while this API runs might be missing from the result.
   std::vector<Sample> Samples(double* accumulator, size_t* total_samples) const;
 
+  HistogramSnapshot Histogram() const { return histogram_.Snapshot(); }
+
   string Repr(double value) const { return repr_fn_(value); }
 
  private:
-  mutable std::mutex lock_;
+  struct SampleSlot {
+    // The one based position of the sample stored within the slot, zero if
+    // the slot is empty, or kWritingPosition while a writer owns it.
+    std::atomic<uint64> position;
+    std::atomic<int64> timestamp_ns;
+    std::atomic<double> value;
+  };
+
   MetricReprFn repr_fn_;
-  size_t count_ = 0;
-  std::vector<Sample> samples_;
-  double accumulator_ = 0.0;
+  HistogramData histogram_;
+  size_t max_samples_;
+  std::unique_ptr<SampleSlot[]> samples_;
+  std::atomic<uint64> count_;
 };
 
 // Counters are a very lightweight form of metrics which do not need to track
@@ -156,6 +218,27 @@ class Counter {
 // Creates a report with the current metrics statistics.
 string CreateMetricReport();
 
+// Creates a JSON report with the current counter values and metrics statistics,
+// in the {"counters": {NAME: VALUE, ...}, "metrics": {NAME: {...}, ...}} form.
+string CreateMetricReportJson();
+
+// Whether the counters and metrics deltas are captured at every step. Enabled
+// by the XLA_METRICS_STEP_DELTAS, or XLA_METRICS_JSON_FILE, environment
+// variables.
+bool StepDeltasEnabled();
+
+void SetStepDeltasEnabled(bool enabled);
+
+// Captures the changes of the counters and metrics since the previous capture.
+// Only the counters and metrics which changed are recorded, so the cost of a
+// capture is proportional to the number of registered ones, and not to the
+// number of samples they hold.
+void CaptureStepDelta();
+
+// Returns the JSON representation of the last captured step delta, or an empty
+// string if none has been captured yet.
+string GetLastStepDeltaJson();
+
 // Returns the currently registered metric names. Note that the list can grow
 // since metrics are usualy function intialized (they are static function
 // variables).
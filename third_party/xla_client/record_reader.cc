@@ -1,6 +1,14 @@
 #include "tensorflow/compiler/xla/xla_client/record_reader.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+
+#include "absl/memory/memory.h"
 #include "tensorflow/compiler/xla/xla_client/debug_macros.h"
+#include "tensorflow/compiler/xla/xla_client/metrics.h"
+#include "tensorflow/compiler/xla/xla_client/thread_pool.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/env.h"
@@ -30,5 +38,197 @@ bool RecordReader::Read(string* value) {
   return true;
 }
 
+// A file being read in background, with a bounded buffer of records ahead of
+// the consumer. The fill closure stops once the buffer is full, and it is
+// rescheduled by the consumer once the buffer drains below half capacity, so
+// no IO thread is parked on a full buffer.
+class InterleavedRecordReader::FileStream
+    : public std::enable_shared_from_this<FileStream> {
+ public:
+  FileStream(string path, const Options& options)
+      : path_(std::move(path)),
+        options_(options),
+        capacity_(std::max<size_t>(options.prefetch_records, 1)) {}
+
+  void Start() {
+    std::lock_guard<std::mutex> slock(lock_);
+    ScheduleFill();
+  }
+
+  void Close() {
+    std::lock_guard<std::mutex> slock(lock_);
+    closed_ = true;
+  }
+
+  bool Pop(string* value) {
+    std::unique_lock<std::mutex> ulock(lock_);
+    if (records_.empty() && !eof_ && exptr_ == nullptr) {
+      XLA_TIMED("InterleavedRecordReaderWait");
+      cv_.wait(ulock, [this] {
+        return !records_.empty() || eof_ || exptr_ != nullptr;
+      });
+    }
+    if (exptr_ != nullptr) {
+      std::rethrow_exception(exptr_);
+    }
+    if (records_.empty()) {
+      return false;
+    }
+    *value = std::move(records_.front());
+    records_.pop_front();
+    if (records_.size() <= capacity_ / 2) {
+      ScheduleFill();
+    }
+    return true;
+  }
+
+ private:
+  void ScheduleFill() {
+    if (running_ || eof_ || closed_ || exptr_ != nullptr) {
+      return;
+    }
+    running_ = true;
+    auto self = shared_from_this();
+    env::ScheduleIoClosure([self]() { self->Fill(); });
+  }
+
+  void Fill() {
+    try {
+      if (reader_ == nullptr) {
+        reader_ = absl::make_unique<RecordReader>(
+            path_, options_.compression, options_.buffer_size);
+      }
+      for (;;) {
+        {
+          std::lock_guard<std::mutex> slock(lock_);
+          if (closed_ || records_.size() >= capacity_) {
+            running_ = false;
+            return;
+          }
+        }
+        string value;
+        bool has_value = reader_->Read(&value);
+        std::lock_guard<std::mutex> slock(lock_);
+        if (has_value) {
+          records_.push_back(std::move(value));
+          XLA_COUNTER("InterleavedRecordPrefetches", 1);
+        } else {
+          eof_ = true;
+          running_ = false;
+        }
+        cv_.notify_all();
+        if (!has_value) {
+          return;
+        }
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> slock(lock_);
+      exptr_ = std::current_exception();
+      running_ = false;
+      cv_.notify_all();
+    }
+  }
+
+  string path_;
+  Options options_;
+  size_t capacity_;
+  // Only accessed by the fill closure, of which at most one is running.
+  std::unique_ptr<RecordReader> reader_;
+  std::mutex lock_;
+  std::condition_variable cv_;
+  std::deque<string> records_;
+  bool running_ = false;
+  bool eof_ = false;
+  bool closed_ = false;
+  std::exception_ptr exptr_;
+};
+
+InterleavedRecordReader::InterleavedRecordReader(
+    const std::vector<string>& paths, const Options& options)
+    : options_(options) {
+  XLA_CHECK_GT(options_.cycle_length, 0);
+  XLA_CHECK_GT(options_.block_length, 0);
+  XLA_CHECK_GT(options_.num_shards, 0);
+  XLA_CHECK(options_.shard_ordinal >= 0 &&
+            options_.shard_ordinal < options_.num_shards)
+      << "Invalid shard ordinal " << options_.shard_ordinal << " for "
+      << options_.num_shards << " shards";
+  for (size_t i = options_.shard_ordinal; i < paths.size();
+       i += options_.num_shards) {
+    paths_.push_back(paths[i]);
+  }
+  // Start the readahead of the whole initial cycle, so that the first reads do
+  // not pay for the sequential opening of the files.
+  for (int64 i = 0; i < options_.cycle_length; ++i) {
+    cycle_.push_back(OpenNextFile());
+  }
+}
+
+InterleavedRecordReader::~InterleavedRecordReader() {
+  // The fill closures hold a reference to their stream, and will exit on their
+  // own once they observe the closed state.
+  for (auto& stream : cycle_) {
+    if (stream != nullptr) {
+      stream->Close();
+    }
+  }
+}
+
+std::shared_ptr<InterleavedRecordReader::FileStream>
+InterleavedRecordReader::OpenNextFile() {
+  if (next_path_ >= paths_.size()) {
+    return nullptr;
+  }
+  auto stream = std::make_shared<FileStream>(paths_[next_path_], options_);
+  ++next_path_;
+  stream->Start();
+  return stream;
+}
+
+bool InterleavedRecordReader::Read(string* value) {
+  std::lock_guard<std::mutex> slock(lock_);
+  return ReadLocked(value);
+}
+
+size_t InterleavedRecordReader::ReadBatch(size_t max_records,
+                                          std::vector<string>* values) {
+  std::lock_guard<std::mutex> slock(lock_);
+  size_t count = 0;
+  for (; count < max_records; ++count) {
+    string value;
+    if (!ReadLocked(&value)) {
+      break;
+    }
+    values->push_back(std::move(value));
+  }
+  return count;
+}
+
+bool InterleavedRecordReader::ReadLocked(string* value) {
+  for (size_t empty_slots = 0; empty_slots < cycle_.size();) {
+    std::shared_ptr<FileStream>& stream = cycle_[current_];
+    if (stream != nullptr && stream->Pop(value)) {
+      block_count_ += 1;
+      if (block_count_ >= options_.block_length) {
+        current_ = (current_ + 1) % cycle_.size();
+        block_count_ = 0;
+      }
+      XLA_COUNTER("InterleavedRecordReads", 1);
+      return true;
+    }
+    // The file in the current slot is exhausted (or the slot is empty), so we
+    // replace it with the next unread file, if any.
+    stream = OpenNextFile();
+    block_count_ = 0;
+    if (stream == nullptr) {
+      current_ = (current_ + 1) % cycle_.size();
+      empty_slots += 1;
+    } else {
+      empty_slots = 0;
+    }
+  }
+  return false;
+}
+
 }  // namespace util
 }  // namespace xla
@@ -3,6 +3,7 @@
 
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include "tensorflow/compiler/xla/types.h"
 #include "tensorflow/core/lib/io/record_reader.h"
@@ -26,6 +27,53 @@ class RecordReader {
   std::unique_ptr<tensorflow::io::RecordReader> reader_;
 };
 
+// Reads records from a set of TfRecord files, interleaving cycle_length of them
+// at a time, and taking block_length consecutive records from each one in
+// turn. When a file reaches EOF, the next unread one takes its place within the
+// cycle. The output order only depends on the input files and the configuration
+// parameters. The reading and decompression of the active files happens in the
+// background on the IO thread pool, with each file keeping at most
+// prefetch_records records buffered. When num_shards is greater than one, only
+// the files whose index modulo num_shards is equal to shard_ordinal are read.
+class InterleavedRecordReader {
+ public:
+  struct Options {
+    string compression;
+    int64 buffer_size = 16 * 1024 * 1024;
+    int64 cycle_length = 8;
+    int64 block_length = 1;
+    int64 prefetch_records = 256;
+    int64 shard_ordinal = 0;
+    int64 num_shards = 1;
+  };
+
+  InterleavedRecordReader(const std::vector<string>& paths,
+                          const Options& options);
+
+  ~InterleavedRecordReader();
+
+  bool Read(string* value);
+
+  // Reads up to max_records records, appending them to values. Returns the
+  // number of records read, which is zero only on EOF.
+  size_t ReadBatch(size_t max_records, std::vector<string>* values);
+
+ private:
+  class FileStream;
+
+  std::shared_ptr<FileStream> OpenNextFile();
+
+  bool ReadLocked(string* value);
+
+  std::vector<string> paths_;
+  Options options_;
+  std::mutex lock_;
+  size_t next_path_ = 0;
+  std::vector<std::shared_ptr<FileStream>> cycle_;
+  size_t current_ = 0;
+  int64 block_count_ = 0;
+};
+
 }  // namespace util
 }  // namespace xla
 
@@ -0,0 +1,170 @@
+#include "tensorflow/compiler/xla/xla_client/tracer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#include "tensorflow/compiler/xla/xla_client/metrics.h"
+#include "tensorflow/compiler/xla/xla_client/sys_util.h"
+#include "tensorflow/compiler/xla/xla_client/util.h"
+
+namespace xla {
+namespace tracer {
+namespace {
+
+struct Event {
+  Event(const char* name, int64 start_ns, int64 end_ns, string args)
+      : name(name), start_ns(start_ns), end_ns(end_ns), args(std::move(args)) {}
+
+  const char* name;
+  int64 start_ns;
+  int64 end_ns;
+  string args;
+};
+
+struct ThreadEvents {
+  explicit ThreadEvents(int64 tid) : tid(tid) {}
+
+  int64 tid;
+  std::mutex lock;
+  std::vector<Event> events;
+};
+
+class TraceArena {
+ public:
+  static TraceArena* Get() {
+    static TraceArena* arena = new TraceArena();
+    return arena;
+  }
+
+  std::shared_ptr<ThreadEvents> RegisterThread() {
+    std::lock_guard<std::mutex> lock(lock_);
+    threads_.push_back(std::make_shared<ThreadEvents>(next_tid_));
+    ++next_tid_;
+    return threads_.back();
+  }
+
+  std::vector<std::shared_ptr<ThreadEvents>> GetThreads() {
+    std::lock_guard<std::mutex> lock(lock_);
+    return threads_;
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> lock(lock_);
+    std::vector<std::shared_ptr<ThreadEvents>> live_threads;
+    for (auto& thread_events : threads_) {
+      // The buffers of the threads which have exited are only referenced by
+      // the arena, and can be dropped.
+      if (thread_events.use_count() > 1) {
+        std::lock_guard<std::mutex> tlock(thread_events->lock);
+        thread_events->events.clear();
+        live_threads.push_back(thread_events);
+      }
+    }
+    threads_.swap(live_threads);
+  }
+
+ private:
+  std::mutex lock_;
+  int64 next_tid_ = 1;
+  std::vector<std::shared_ptr<ThreadEvents>> threads_;
+};
+
+std::atomic<bool>* GetEnabledFlag() {
+  static std::atomic<bool>* enabled =
+      new std::atomic<bool>(sys_util::GetEnvBool("XLA_TRACE", false));
+  return enabled;
+}
+
+ThreadEvents* GetThreadEvents() {
+  static thread_local std::shared_ptr<ThreadEvents> thread_events =
+      TraceArena::Get()->RegisterThread();
+  return thread_events.get();
+}
+
+void AddEvent(const char* name, int64 start_ns, int64 end_ns, string args) {
+  static const size_t kMaxThreadEvents =
+      sys_util::GetEnvInt("XLA_TRACE_MAX_EVENTS", 1000000);
+  ThreadEvents* thread_events = GetThreadEvents();
+  std::lock_guard<std::mutex> lock(thread_events->lock);
+  if (thread_events->events.size() < kMaxThreadEvents) {
+    thread_events->events.emplace_back(name, start_ns, end_ns,
+                                       std::move(args));
+  } else {
+    XLA_COUNTER("TraceDroppedEvents", 1);
+  }
+}
+
+}  // namespace
+
+bool IsEnabled() { return GetEnabledFlag()->load(std::memory_order_relaxed); }
+
+void SetEnabled(bool enabled) { GetEnabledFlag()->store(enabled); }
+
+string DumpChromeTrace() {
+  std::stringstream ss;
+  ss.precision(3);
+  ss << std::fixed << "{\"traceEvents\":[";
+  std::vector<std::shared_ptr<ThreadEvents>> threads =
+      TraceArena::Get()->GetThreads();
+  // Event timestamps are emitted relative to the oldest one, to avoid loss of
+  // precision in the microseconds values of the trace.
+  int64 base_ns = std::numeric_limits<int64>::max();
+  for (auto& thread_events : threads) {
+    std::lock_guard<std::mutex> lock(thread_events->lock);
+    for (auto& event : thread_events->events) {
+      base_ns = std::min(base_ns, event.start_ns);
+    }
+  }
+  bool first = true;
+  for (auto& thread_events : threads) {
+    std::lock_guard<std::mutex> lock(thread_events->lock);
+    for (auto& event : thread_events->events) {
+      if (!first) {
+        ss << ",";
+      }
+      first = false;
+      ss << "\n{\"name\":" << util::JsonQuote(event.name)
+         << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << thread_events->tid
+         << ",\"ts\":" << 1e-3 * (event.start_ns - base_ns)
+         << ",\"dur\":" << 1e-3 * (event.end_ns - event.start_ns)
+         << ",\"args\":{" << event.args << "}}";
+    }
+  }
+  ss << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  return ss.str();
+}
+
+void ClearEvents() { TraceArena::Get()->Clear(); }
+
+void AddCompleteEvent(const char* name, int64 start_ns, int64 end_ns) {
+  if (IsEnabled()) {
+    AddEvent(name, start_ns, end_ns, string());
+  }
+}
+
+ScopedEvent::ScopedEvent(const char* name) : name_(name) {
+  if (IsEnabled()) {
+    start_ns_ = sys_util::NowNs();
+  }
+}
+
+ScopedEvent::~ScopedEvent() {
+  if (active()) {
+    AddEvent(name_, start_ns_, sys_util::NowNs(), std::move(args_));
+  }
+}
+
+void ScopedEvent::AppendArg(const char* key, const string& value) {
+  if (!args_.empty()) {
+    args_ += ",";
+  }
+  args_ += absl::StrCat(util::JsonQuote(key), ":", util::JsonQuote(value));
+}
+
+}  // namespace tracer
+}  // namespace xla
@@ -0,0 +1,63 @@
+#ifndef TENSORFLOW_COMPILER_XLA_XLA_CLIENT_TRACER_H_
+#define TENSORFLOW_COMPILER_XLA_XLA_CLIENT_TRACER_H_
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/compiler/xla/types.h"
+
+namespace xla {
+namespace tracer {
+
+// Returns whether event tracing is enabled. Tracing can be enabled at startup
+// with the XLA_TRACE environment variable, or at runtime using the
+// SetEnabled() API.
+bool IsEnabled();
+
+void SetEnabled(bool enabled);
+
+// Returns the events collected so far, in Chrome trace JSON format, which can
+// be loaded within the chrome://tracing page or the Perfetto UI.
+string DumpChromeTrace();
+
+// Drops all the events collected so far.
+void ClearEvents();
+
+// Records a complete event with explicit start and end times, as returned by
+// the sys_util::NowNs() API. Does nothing if tracing is not enabled.
+void AddCompleteEvent(const char* name, int64 start_ns, int64 end_ns);
+
+// Records a complete event spanning the lifetime of the object, if tracing is
+// enabled at construction time. Events are buffered within per-thread
+// storage, which is only contended when dumping the trace. The name argument
+// must point to a string which outlives the object (typically a literal).
+// A typical use is as:
+//   xla::tracer::ScopedEvent trace("Compile");
+//   trace.AddArg("device", device);
+class ScopedEvent {
+ public:
+  explicit ScopedEvent(const char* name);
+
+  ~ScopedEvent();
+
+  bool active() const { return start_ns_ >= 0; }
+
+  // Adds a key/value argument to the event. The value is converted to string
+  // only if the event is active.
+  template <typename T>
+  void AddArg(const char* key, const T& value) {
+    if (active()) {
+      AppendArg(key, absl::StrCat(value));
+    }
+  }
+
+ private:
+  void AppendArg(const char* key, const string& value);
+
+  const char* name_;
+  int64 start_ns_ = -1;
+  string args_;
+};
+
+}  // namespace tracer
+}  // namespace xla
+
+#endif  // TENSORFLOW_COMPILER_XLA_XLA_CLIENT_TRACER_H_
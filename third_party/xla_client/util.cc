@@ -0,0 +1,291 @@
+#include "tensorflow/compiler/xla/xla_client/util.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace xla {
+namespace util {
+namespace {
+
+constexpr size_t kStripeSize = 64;
+constexpr size_t kStripeLanes = kStripeSize / sizeof(uint64);
+constexpr size_t kStripesPerBlock = 16;
+
+constexpr uint64 kPrime32_1 = 0x9e3779b1;
+constexpr uint64 kPrime32_2 = 0x85ebca77;
+constexpr uint64 kPrime32_3 = 0xc2b2ae3d;
+constexpr uint64 kPrime64_1 = 0x9e3779b185ebca87;
+constexpr uint64 kPrime64_2 = 0xc2b2ae3d27d4eb4f;
+constexpr uint64 kPrime64_3 = 0x165667b19e3779f9;
+constexpr uint64 kPrime64_4 = 0x85ebca77c2b2ae63;
+constexpr uint64 kPrime64_5 = 0x27d4eb2f165667c5;
+
+// Pseudo random keys, generated with splitmix64. The stripe at position N
+// within a block uses the keys [N, N + 8), and the block scramble uses the last
+// eight.
+constexpr uint64 kKeys[kStripesPerBlock + kStripeLanes] = {
+    0xe220a8397b1dcdaf, 0x6e789e6aa1b965f4, 0x06c45d188009454f,
+    0xf88bb8a8724c81ec, 0x1b39896a51a8749b, 0x53cb9f0c747ea2ea,
+    0x2c829abe1f4532e1, 0xc584133ac916ab3c, 0x3ee5789041c98ac3,
+    0xf3b8488c368cb0a6, 0x657eecdd3cb13d09, 0xc2d326e0055bdef6,
+    0x8621a03fe0bbdb7b, 0x8e1f7555983aa92f, 0xb54e0f1600cc4d19,
+    0x84bb3f97971d80ab, 0x7d29825c75521255, 0xc3cf17102b7f7f86,
+    0x3466e9a083914f64, 0xd81a8d2b5a4485ac, 0xdb01602b100b9ed7,
+    0xa9038a921825f10d, 0xedf5f1d90dca2f6a, 0x54496ad67bd2634c,
+};
+constexpr const uint64* kScrambleKeys = kKeys + kStripesPerBlock;
+constexpr const uint64* kLastStripeKeys = kKeys + 13;
+constexpr const uint64* kMergeKeys = kKeys + 11;
+
+inline uint64 Read64(const char* data) {
+  uint64 value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+inline uint64 Read32(const char* data) {
+  uint32 value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+inline uint64 Rotl64(uint64 value, int bits) {
+  return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64 Swap64(uint64 value) { return __builtin_bswap64(value); }
+
+inline uint64 Mul128Fold64(uint64 lhs, uint64 rhs) {
+  unsigned __int128 product = static_cast<unsigned __int128>(lhs) * rhs;
+  return static_cast<uint64>(product) ^ static_cast<uint64>(product >> 64);
+}
+
+inline uint64 Avalanche(uint64 hash) {
+  hash ^= hash >> 37;
+  hash *= 0x165667919e3779f9;
+  return hash ^ (hash >> 32);
+}
+
+inline uint64 Avalanche64(uint64 hash) {
+  hash ^= hash >> 33;
+  hash *= kPrime64_2;
+  hash ^= hash >> 29;
+  hash *= kPrime64_3;
+  return hash ^ (hash >> 32);
+}
+
+inline uint64 Mix16(const char* data, const uint64* keys, uint64 seed) {
+  return Mul128Fold64(Read64(data) ^ (keys[0] + seed),
+                      Read64(data + 8) ^ (keys[1] - seed));
+}
+
+uint64 HashUpTo16(const char* data, size_t size, uint64 seed) {
+  if (size > 8) {
+    uint64 low = Read64(data) ^ ((kKeys[3] ^ kKeys[4]) + seed);
+    uint64 high = Read64(data + size - 8) ^ ((kKeys[5] ^ kKeys[6]) - seed);
+    return Avalanche(size + Swap64(low) + high + Mul128Fold64(low, high));
+  }
+  if (size >= 4) {
+    uint64 value = Read32(data + size - 4) + (Read32(data) << 32);
+    uint64 hash = value ^ ((kKeys[1] ^ kKeys[2]) - seed);
+    hash ^= Rotl64(hash, 49) ^ Rotl64(hash, 24);
+    hash *= 0x9fb21c651e98df25;
+    hash ^= (hash >> 35) + size;
+    hash *= 0x9fb21c651e98df25;
+    return hash ^ (hash >> 28);
+  }
+  if (size > 0) {
+    uint64 value = (static_cast<uint64>(static_cast<uint8>(data[0])) << 16) |
+                   (static_cast<uint64>(static_cast<uint8>(data[size >> 1]))
+                    << 24) |
+                   static_cast<uint64>(static_cast<uint8>(data[size - 1])) |
+                   (static_cast<uint64>(size) << 8);
+    uint64 key = (kKeys[0] >> 32) ^ (kKeys[0] & 0xffffffff);
+    return Avalanche64(value ^ (key + seed));
+  }
+  return Avalanche64(seed ^ kKeys[0] ^ kKeys[1]);
+}
+
+uint64 HashUpTo128(const char* data, size_t size, uint64 seed) {
+  uint64 acc = size * kPrime64_1;
+  if (size > 32) {
+    if (size > 64) {
+      if (size > 96) {
+        acc += Mix16(data + 48, kKeys + 12, seed);
+        acc += Mix16(data + size - 64, kKeys + 14, seed);
+      }
+      acc += Mix16(data + 32, kKeys + 8, seed);
+      acc += Mix16(data + size - 48, kKeys + 10, seed);
+    }
+    acc += Mix16(data + 16, kKeys + 4, seed);
+    acc += Mix16(data + size - 32, kKeys + 6, seed);
+  }
+  acc += Mix16(data, kKeys, seed);
+  acc += Mix16(data + size - 16, kKeys + 2, seed);
+  return Avalanche(acc);
+}
+
+void InitAccumulators(uint64* acc) {
+  acc[0] = kPrime32_3;
+  acc[1] = kPrime64_1;
+  acc[2] = kPrime64_2;
+  acc[3] = kPrime64_3;
+  acc[4] = kPrime64_4;
+  acc[5] = kPrime32_2;
+  acc[6] = kPrime64_5;
+  acc[7] = kPrime32_1;
+}
+
+// The inner loops are written in a way that the compiler can vectorize them,
+// using 32x32->64 bits SIMD multiplies.
+inline void AccumulateStripe(uint64* acc, const char* data, const uint64* keys,
+                             uint64 seed) {
+  uint64 values[kStripeLanes];
+  std::memcpy(values, data, sizeof(values));
+  for (size_t i = 0; i < kStripeLanes; i += 2) {
+    uint64 keyed0 = values[i] ^ (keys[i] + seed);
+    uint64 keyed1 = values[i + 1] ^ (keys[i + 1] + seed);
+    acc[i] += values[i + 1] + (keyed0 & 0xffffffff) * (keyed0 >> 32);
+    acc[i + 1] += values[i] + (keyed1 & 0xffffffff) * (keyed1 >> 32);
+  }
+}
+
+inline void ScrambleAccumulators(uint64* acc) {
+  for (size_t i = 0; i < kStripeLanes; ++i) {
+    uint64 value = acc[i];
+    value ^= value >> 47;
+    value ^= kScrambleKeys[i];
+    acc[i] = value * kPrime32_1;
+  }
+}
+
+// Consumes the given number of stripes, where num_stripes is the number of
+// stripes consumed so far.
+void ConsumeStripes(uint64* acc, size_t* num_stripes, const char* data,
+                    size_t count, uint64 seed) {
+  for (size_t i = 0; i < count; ++i, data += kStripeSize) {
+    size_t block_stripe = *num_stripes % kStripesPerBlock;
+    AccumulateStripe(acc, data, kKeys + block_stripe, seed);
+    if (block_stripe == kStripesPerBlock - 1) {
+      ScrambleAccumulators(acc);
+    }
+    *num_stripes += 1;
+  }
+}
+
+uint64 MergeAccumulators(uint64* acc, const char* last_stripe, size_t size,
+                         uint64 seed) {
+  AccumulateStripe(acc, last_stripe, kLastStripeKeys, seed);
+  uint64 result = size * kPrime64_1;
+  for (size_t i = 0; i < kStripeLanes; i += 2) {
+    result +=
+        Mul128Fold64(acc[i] ^ kMergeKeys[i], acc[i + 1] ^ kMergeKeys[i + 1]);
+  }
+  return Avalanche(result);
+}
+
+}  // namespace
+
+uint64 FastHash64(const void* data, size_t size, uint64 seed) {
+  const char* cdata = static_cast<const char*>(data);
+  if (size <= 16) {
+    return HashUpTo16(cdata, size, seed);
+  }
+  if (size <= 128) {
+    return HashUpTo128(cdata, size, seed);
+  }
+  uint64 acc[kStripeLanes];
+  InitAccumulators(acc);
+  // The last stripe is always processed by MergeAccumulators(), so that the
+  // tail of the data can be handled as an overlapping full stripe.
+  size_t num_stripes = 0;
+  ConsumeStripes(acc, &num_stripes, cdata, (size - 1) / kStripeSize, seed);
+  return MergeAccumulators(acc, cdata + size - kStripeSize, size, seed);
+}
+
+FastHasher::FastHasher(uint64 seed) : seed_(seed) { InitAccumulators(acc_); }
+
+void FastHasher::Update(const void* data, size_t size) {
+  const char* cdata = static_cast<const char*>(data);
+  total_size_ += size;
+  if (buffered_ + size <= kBufferSize) {
+    std::memcpy(buffer_ + buffered_, cdata, size);
+    buffered_ += size;
+    return;
+  }
+  // Here we know we have more than kBufferSize bytes of data, but we always
+  // leave a non empty tail within the buffer, since the last stripe has to be
+  // consumed by Digest().
+  const char* last_stripe = nullptr;
+  if (buffered_ > 0) {
+    size_t count = kBufferSize - buffered_;
+    std::memcpy(buffer_ + buffered_, cdata, count);
+    cdata += count;
+    size -= count;
+    ConsumeStripes(acc_, &num_stripes_, buffer_, kBufferSize / kStripeSize,
+                   seed_);
+    last_stripe = buffer_ + kBufferSize - kStripeSize;
+  }
+  for (; size > kBufferSize; cdata += kBufferSize, size -= kBufferSize) {
+    ConsumeStripes(acc_, &num_stripes_, cdata, kBufferSize / kStripeSize,
+                   seed_);
+    last_stripe = cdata + kBufferSize - kStripeSize;
+  }
+  std::memcpy(last_stripe_, last_stripe, kStripeSize);
+  std::memcpy(buffer_, cdata, size);
+  buffered_ = size;
+}
+
+uint64 FastHasher::Digest() const {
+  if (total_size_ <= kBufferSize) {
+    return FastHash64(buffer_, total_size_, seed_);
+  }
+  uint64 acc[kStripeLanes];
+  std::copy(acc_, acc_ + kStripeLanes, acc);
+  size_t num_stripes = num_stripes_;
+  ConsumeStripes(acc, &num_stripes, buffer_, (buffered_ - 1) / kStripeSize,
+                 seed_);
+  if (buffered_ >= kStripeSize) {
+    return MergeAccumulators(acc, buffer_ + buffered_ - kStripeSize,
+                             total_size_, seed_);
+  }
+  char last_stripe[kStripeSize];
+  size_t count = kStripeSize - buffered_;
+  std::memcpy(last_stripe, last_stripe_ + buffered_, count);
+  std::memcpy(last_stripe + count, buffer_, buffered_);
+  return MergeAccumulators(acc, last_stripe, total_size_, seed_);
+}
+
+string JsonQuote(const string& value) {
+  string result = "\"";
+  for (char c : value) {
+    switch (c) {
+      case '"':
+        result += "\\\"";
+        break;
+      case '\\':
+        result += "\\\\";
+        break;
+      case '\n':
+        result += "\\n";
+        break;
+      case '\t':
+        result += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char escaped[8];
+          std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+          result += escaped;
+        } else {
+          result += c;
+        }
+    }
+  }
+  result += '"';
+  return result;
+}
+
+}  // namespace util
+}  // namespace xla
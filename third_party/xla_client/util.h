@@ -12,13 +12,52 @@
 
 #include "absl/types/optional.h"
 #include "tensorflow/compiler/xla/status.h"
+#include "tensorflow/compiler/xla/types.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/gtl/array_slice.h"
-#include "tensorflow/core/lib/hash/hash.h"
 
 namespace xla {
 namespace util {
 
+// The seed used by DataHash().
+constexpr uint64 kDataHashSeed = 0xc2b2ae3d27d4eb4f;
+
+// Fast 64 bit hash of a memory buffer. For buffers bigger than 128 bytes, the
+// data is consumed in 64 bytes stripes by eight independent accumulation lanes,
+// which the compiler can map to SIMD instructions.
+uint64 FastHash64(const void* data, size_t size, uint64 seed);
+
+// Incremental version of FastHash64(), which allows to hash data which is not
+// stored within a single contiguous buffer. Feeding the same sequence of bytes,
+// no matter how split among Update() calls, yields the same value returned by
+// FastHash64() over the concatenated data.
+class FastHasher {
+ public:
+  explicit FastHasher(uint64 seed);
+
+  void Update(const void* data, size_t size);
+
+  uint64 Digest() const;
+
+ private:
+  static constexpr size_t kStripeSize = 64;
+  static constexpr size_t kBufferSize = 4 * kStripeSize;
+
+  uint64 seed_ = 0;
+  uint64 acc_[8];
+  size_t num_stripes_ = 0;
+  size_t total_size_ = 0;
+  size_t buffered_ = 0;
+  char buffer_[kBufferSize];
+  // The last stripe consumed out of the buffer, which is needed by Digest()
+  // when the final data left within the buffer is smaller than a stripe.
+  char last_stripe_[kStripeSize];
+};
+
+// Returns the value as a JSON string literal, escaping the characters which
+// need to.
+string JsonQuote(const string& value);
+
 template <typename F>
 Status CheckedCall(const F& fn) {
   try {
@@ -130,7 +169,7 @@ struct PartialHasher {
         pos = end - N;
       }
     }
-    return tensorflow::Hash64(data.data() + pos, end - pos, 17);
+    return FastHash64(data.data() + pos, end - pos, 17);
   }
 
   P policy;
@@ -236,8 +275,7 @@ T Multiply(const S& input) {
 }
 
 static inline size_t DataHash(const void* data, size_t size) {
-  return tensorflow::Hash64(reinterpret_cast<const char*>(data), size,
-                            0xc2b2ae3d27d4eb4f);
+  return FastHash64(data, size, kDataHashSeed);
 }
 
 static inline size_t StringHash(const char* data) {
@@ -9,12 +9,15 @@
 
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
 #include "tensorflow/cc/ops/const_op.h"
+#include "tensorflow/compiler/xla/layout_util.h"
 #include "tensorflow/compiler/xla/shape_util.h"
 #include "tensorflow/compiler/xla/util.h"
 #include "tensorflow/compiler/xla/xla_client/multi_wait.h"
 #include "tensorflow/compiler/xla/xla_client/sys_util.h"
 #include "tensorflow/compiler/xla/xla_client/thread_pool.h"
+#include "tensorflow/compiler/xla/xla_client/tracer.h"
 #include "tensorflow/compiler/xla/xla_client/unique.h"
 #include "tensorflow/compiler/xla/xla_client/util.h"
 #include "tensorflow/compiler/xla/xla_client/xla_util.h"
@@ -182,6 +185,15 @@ void MaybeSaveLongCompileHlo(double compile_time,
   }
 }
 
+// The compiled program shape is only fetched back when the caller left the
+// result layouts for the compiler to choose (which the layouts profile
+// recording does), as other compilations get back the layouts they passed in.
+bool HasCompilerChosenLayouts(
+    const ComputationClient::CompileInstance& instance) {
+  return instance.output_shape != nullptr &&
+         !LayoutUtil::HasLayout(*instance.output_shape);
+}
+
 }  // namespace
 
 void XrtComputationClient::XrtData::Assign(const Data& data) {
@@ -196,6 +208,8 @@ XrtComputationClient::XrtComputationClient(
     std::unique_ptr<tensorflow::tpu::TopologyProto> topology_proto)
     : options_(std::move(options)),
       compilation_cache_(sys_util::GetEnvInt("XLA_COMPILATION_CACHE_SIZE", 64)),
+      chained_plan_cache_(
+          sys_util::GetEnvInt("XRT_CHAINED_PLAN_CACHE_SIZE", 256)),
       rng_seed_(0x5a2d296e9) {
   tensorflow::ConfigProto config = CreateConfigProto(options_);
   session_cache_ = absl::make_unique<XrtSessionCache>(
@@ -236,6 +250,8 @@ ComputationClient::DataPtr XrtComputationClient::CreateDataPlaceholder(
 std::vector<ComputationClient::DataPtr> XrtComputationClient::TransferToServer(
     tensorflow::gtl::ArraySlice<const TensorSource> tensors) {
   metrics::TimedSection timed(TransferToServerMetric());
+  tracer::ScopedEvent trace("TransferToServer");
+  trace.AddArg("count", tensors.size());
 
   std::mutex lock;
   XrtSessionCache::SessionMap session_map;
@@ -298,6 +314,8 @@ std::vector<ComputationClient::DataPtr> XrtComputationClient::TransferToServer(
 std::vector<Literal> XrtComputationClient::TransferFromServer(
     tensorflow::gtl::ArraySlice<const DataPtr> handles) {
   metrics::TimedSection timed(TransferFromServerMetric());
+  tracer::ScopedEvent trace("TransferFromServer");
+  trace.AddArg("count", handles.size());
 
   XrtSessionCache::SessionMap session_map;
   std::map<XrtSession*, SessionWork> session_work_map;
@@ -340,6 +358,8 @@ std::vector<Literal> XrtComputationClient::TransferFromServer(
 std::vector<ComputationClient::ComputationPtr> XrtComputationClient::Compile(
     std::vector<CompileInstance> instances) {
   metrics::TimedSection timed(CompileMetric());
+  tracer::ScopedEvent trace("Compile");
+  trace.AddArg("count", instances.size());
 
   std::mutex lock;
   util::MultiWait mwait(instances.size());
@@ -377,6 +397,9 @@ std::vector<ComputationClient::ComputationPtr> XrtComputationClient::Compile(
           session_work->feed_inputs.insert(
               {cached_node.holders[0], cache_keys[i].serialized_computation});
           session_work->outputs_handles.push_back(cached_node.outputs[0]);
+          if (HasCompilerChosenLayouts(instance)) {
+            session_work->outputs_handles.push_back(cached_node.outputs[1]);
+          }
           session_work->index_mapping.push_back(i);
         }
       } else {
@@ -405,12 +428,21 @@ std::vector<ComputationClient::ComputationPtr> XrtComputationClient::Compile(
       for (auto li : session_work.index_mapping) {
         CompileInstance* instance = &instances[li];
         MaybeSaveLongCompileHlo(compile_time, instance->computation);
+        int64 handle = outputs[output_index].scalar<int64>()();
+        ++output_index;
+        if (HasCompilerChosenLayouts(*instance)) {
+          // The program shape of the compiled executable carries the layouts
+          // chosen by the compiler for the ones left unspecified.
+          ProgramShapeProto compiled_program_shape;
+          XLA_CHECK(compiled_program_shape.ParseFromString(
+              outputs[output_index].scalar<string>()()));
+          program_shapes[li] = ProgramShape(compiled_program_shape);
+          ++output_index;
+        }
         results[li] = std::make_shared<XrtComputation>(
             this, std::move(instance->computation), program_shapes[li],
-            std::move(instance->devices),
-            outputs[output_index].scalar<int64>()(),
+            std::move(instance->devices), handle,
             instance->compilation_device);
-        ++output_index;
 
         compilation_cache_.Add(std::move(cache_keys[li]), results[li]);
         CreateCompileHandlesCounter()->AddValue(1);
@@ -440,6 +472,8 @@ XrtComputationClient::ExecuteComputation(
     tensorflow::gtl::ArraySlice<const DataPtr> arguments, const string& device,
     const ExecuteComputationOptions& options) {
   metrics::TimedSection timed(ExecuteMetric());
+  tracer::ScopedEvent trace("ExecuteComputation");
+  trace.AddArg("device", device);
 
   XrtSessionCache::SessionMap session_map;
   string effective_device = GetEffectiveDevice(device);
@@ -468,6 +502,10 @@ XrtComputationClient::ExecuteReplicated(
     tensorflow::gtl::ArraySlice<const string> devices,
     const ExecuteReplicatedOptions& options) {
   metrics::TimedSection timed(ExecuteReplicatedMetric());
+  tracer::ScopedEvent trace("ExecuteReplicated");
+  if (trace.active()) {
+    trace.AddArg("devices", absl::StrJoin(devices, ","));
+  }
 
   XrtSessionCache::SessionMap session_map;
   tensorflow::ClientSession::FeedType feed_inputs;
@@ -548,6 +586,10 @@ XrtComputationClient::ExecuteParallel(
     tensorflow::gtl::ArraySlice<const string> devices,
     const ExecuteParallelOptions& options) {
   metrics::TimedSection timed(ExecuteParallelMetric());
+  tracer::ScopedEvent trace("ExecuteParallel");
+  if (trace.active()) {
+    trace.AddArg("devices", absl::StrJoin(devices, ","));
+  }
 
   XrtSessionCache::SessionMap session_map;
   tensorflow::ClientSession::FeedType feed_inputs;
@@ -566,33 +608,61 @@ std::vector<ComputationClient::DataPtr> XrtComputationClient::ExecuteChained(
                     : ExecuteChainedXrt(ops, device);
 }
 
-std::vector<ComputationClient::DataPtr> XrtComputationClient::ExecuteChainedXrt(
+std::shared_ptr<XrtComputationClient::ChainedPlan>
+XrtComputationClient::GetChainedPlan(
     tensorflow::gtl::ArraySlice<const ExecuteChainedOp> ops,
     const string& device) {
-  metrics::TimedSection timed(ExecuteChainedMetric());
-
-  XrtSessionCache::SessionMap session_map;
-  string effective_device = GetEffectiveDevice(device);
-  const string& xrt_device = TorchDeviceToXrtDevice(effective_device);
-  tensorflow::ClientSession::FeedType feed_inputs;
-  XrtSession* session =
-      GetSessionForXrtDevice(session_cache_.get(), xrt_device, &session_map);
-  tensorflow::Scope device_scope = session->root()->WithDevice(xrt_device);
+  ChainedPlanKey key;
+  key.device = device;
+  key.rng_seed = rng_seed_;
+  // Every operation is encoded as a tag telling apart the device data ones,
+  // followed by the computation handle and inputs, if any, and the outputs.
+  // Lists are prefixed by their size, so different chains cannot end up with
+  // the same encoding.
+  std::vector<int64>& structure = key.structure;
+  for (auto& op : ops) {
+    if (op.device_data != nullptr) {
+      structure.push_back(0);
+    } else {
+      const XrtComputation& xrt_computation =
+          dynamic_cast<const XrtComputation&>(*op.computation);
+      structure.push_back(1);
+      structure.push_back(xrt_computation.get_handle());
+      structure.push_back(op.inputs.size());
+      for (auto& input : op.inputs) {
+        structure.push_back(input.op_index);
+        structure.push_back(input.output_index.value_or(-1));
+      }
+    }
+    structure.push_back(op.outputs.size());
+    for (auto& output : op.outputs) {
+      structure.push_back(output.result_index);
+      structure.push_back(output.output_index.value_or(-1));
+    }
+  }
+  std::shared_ptr<ChainedPlan> chained_plan = chained_plan_cache_.Get(key);
+  if (chained_plan != nullptr) {
+    XLA_COUNTER("XrtChainedPlanCacheHit", 1);
+    return chained_plan;
+  }
+  XLA_COUNTER("XrtChainedPlanCacheMiss", 1);
 
+  chained_plan = std::make_shared<ChainedPlan>();
   xrt::XRTChainedExecuteConfig config;
   config.set_core_index_in_replica(0);
-  config.set_rng_seed(rng_seed_);
+  config.set_rng_seed(key.rng_seed);
+  chained_plan->serialized_config = config.SerializeAsString();
 
-  xrt::XRTChainedExecutePlan plan;
-  std::vector<xla::Shape> result_shapes;
+  std::vector<Shape>& result_shapes = chained_plan->result_shapes;
   for (size_t i = 0; i < ops.size(); ++i) {
     const ExecuteChainedOp& op = ops[i];
-    xrt::XRTChainedExecuteOp* plan_op = plan.add_ops();
+    xrt::XRTChainedExecuteOp* plan_op = chained_plan->plan.add_ops();
     const xla::Shape* op_shape = nullptr;
     if (op.device_data != nullptr) {
       const XrtData& xrt_data = dynamic_cast<const XrtData&>(*op.device_data);
       op_shape = &xrt_data.shape();
       plan_op->set_data_handle(xrt_data.get_handle());
+      chained_plan->data_ops.push_back(i);
     } else {
       const XrtComputation& xrt_computation =
           dynamic_cast<const XrtComputation&>(*op.computation);
@@ -625,11 +695,52 @@ std::vector<ComputationClient::DataPtr> XrtComputationClient::ExecuteChainedXrt(
       }
     }
   }
+  return chained_plan_cache_.Add(std::move(key), std::move(chained_plan));
+}
+
+std::vector<ComputationClient::DataPtr> XrtComputationClient::ExecuteChainedXrt(
+    tensorflow::gtl::ArraySlice<const ExecuteChainedOp> ops,
+    const string& device) {
+  metrics::TimedSection timed(ExecuteChainedMetric());
+  tracer::ScopedEvent trace("ExecuteChained");
+  trace.AddArg("device", device);
+
+  XrtSessionCache::SessionMap session_map;
+  string effective_device = GetEffectiveDevice(device);
+  const string& xrt_device = TorchDeviceToXrtDevice(effective_device);
+  tensorflow::ClientSession::FeedType feed_inputs;
+  XrtSession* session =
+      GetSessionForXrtDevice(session_cache_.get(), xrt_device, &session_map);
+  tensorflow::Scope device_scope = session->root()->WithDevice(xrt_device);
+
+  std::shared_ptr<ChainedPlan> chained_plan =
+      GetChainedPlan(ops, effective_device);
+  std::vector<xla::Shape> result_shapes = chained_plan->result_shapes;
+  string serialized_plan;
+  {
+    std::lock_guard<std::mutex> lock(chained_plan->lock);
+    for (size_t op_index : chained_plan->data_ops) {
+      const ExecuteChainedOp& op = ops[op_index];
+      const XrtData& xrt_data = dynamic_cast<const XrtData&>(*op.device_data);
+      chained_plan->plan.mutable_ops(op_index)->set_data_handle(
+          xrt_data.get_handle());
+      // Device data shapes are not part of the cache key, so the results
+      // coming straight from data inputs need to be refreshed.
+      for (auto& output : op.outputs) {
+        result_shapes[output.result_index] =
+            output.output_index ? ShapeUtil::GetTupleElementShape(
+                                      xrt_data.shape(), *output.output_index)
+                                : xrt_data.shape();
+      }
+    }
+    serialized_plan = chained_plan->plan.SerializeAsString();
+  }
 
   const XrtSession::CachedNode& cached_node =
       GetExecuteChainedNode(session, device_scope, effective_device);
-  feed_inputs.insert({cached_node.holders[0], plan.SerializeAsString()});
-  feed_inputs.insert({cached_node.holders[1], config.SerializeAsString()});
+  feed_inputs.insert({cached_node.holders[0], std::move(serialized_plan)});
+  feed_inputs.insert(
+      {cached_node.holders[1], chained_plan->serialized_config});
 
   std::vector<tensorflow::Tensor> outputs;
   util::CheckComputationStatus(
@@ -653,6 +764,8 @@ XrtComputationClient::ExecuteChainedSplit(
     tensorflow::gtl::ArraySlice<const ExecuteChainedOp> ops,
     const string& device) {
   metrics::TimedSection timed(ExecuteChainedMetric());
+  tracer::ScopedEvent trace("ExecuteChained");
+  trace.AddArg("device", device);
 
   std::vector<int64> uses(ops.size(), 0);
   for (auto& op : ops) {
@@ -725,6 +838,7 @@ std::vector<std::vector<ComputationClient::DataPtr>>
 XrtComputationClient::DeconstructTuple(
     tensorflow::gtl::ArraySlice<const DataPtr> tuples) {
   metrics::TimedSection timed(DeconstructTupleMetric());
+  tracer::ScopedEvent trace("DeconstructTuple");
 
   XrtSessionCache::SessionMap session_map;
   std::map<XrtSession*, SessionWork> session_work_map;
@@ -944,6 +1058,9 @@ void XrtComputationClient::ReleaseHandles(
   }
   if (!released_handles.empty()) {
     metrics::TimedSection timed(timed_metric);
+    tracer::ScopedEvent trace("ReleaseHandles");
+    trace.AddArg("metric", timed_metric->Name());
+    trace.AddArg("count", released_handles.size());
 
     XrtSessionCache::SessionMap session_map;
     std::map<XrtSession*, std::vector<DeviceHandle>> session_handles_map;
@@ -1240,6 +1357,48 @@ std::vector<string> XrtComputationClient::GetAllDevices() const {
   return devices;
 }
 
+std::vector<ComputationClient::DataPtr> XrtComputationClient::TransferToDevice(
+    tensorflow::gtl::ArraySlice<const DataPtr> handles, const string& device) {
+  metrics::TimedSection timed(TransferToDeviceMetric());
+  tracer::ScopedEvent trace("TransferToDevice");
+  trace.AddArg("count", handles.size());
+
+  XrtSessionCache::SessionMap session_map;
+  string effective_device = GetEffectiveDevice(device);
+  const string& xrt_device = TorchDeviceToXrtDevice(effective_device);
+  // The session targets the destination worker. When the source data lives on
+  // a different worker, the TF runtime moves it between the two workers.
+  XrtSession* session =
+      GetSessionForXrtDevice(session_cache_.get(), xrt_device, &session_map);
+  tensorflow::Scope device_scope = session->root()->WithDevice(xrt_device);
+  tensorflow::ClientSession::FeedType feed_inputs;
+  std::vector<tensorflow::Output> outputs_handles;
+  for (auto& handle : handles) {
+    const XrtData& xrt_data = dynamic_cast<const XrtData&>(*handle);
+    tensorflow::Scope source_scope = session->root()->WithDevice(
+        TorchDeviceToXrtDevice(xrt_data.device()));
+    const XrtSession::CachedNode& cached_node =
+        GetTransferNode(session, source_scope, xrt_data.device(), device_scope,
+                        effective_device, xrt_data.shape());
+    feed_inputs.insert({cached_node.holders[0], xrt_data.get_handle()});
+    outputs_handles.push_back(cached_node.outputs[0]);
+  }
+
+  std::vector<tensorflow::Tensor> outputs;
+  XLA_CHECK_OK(
+      session->session()->Run(feed_inputs, outputs_handles, &outputs));
+  XLA_CHECK_EQ(outputs.size(), handles.size());
+
+  std::vector<DataPtr> results;
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    results.push_back(std::make_shared<XrtData>(
+        this, effective_device, handles[i]->shape(),
+        outputs[i].scalar<int64>()()));
+  }
+  CreateDataHandlesCounter()->AddValue(results.size());
+  return results;
+}
+
 void XrtComputationClient::SetReplicationDevices(std::vector<string> devices) {
   g_replication_devices = std::move(devices);
 }
@@ -1294,9 +1453,11 @@ const XrtSession::CachedNode& XrtComputationClient::GetCompileNode(
     XLA_COUNTER("XrtCompile_Empty", 1);
     std::vector<tensorflow::ops::Placeholder> holders(
         {tensorflow::ops::Placeholder(scope, tensorflow::DT_STRING)});
-    cache->Add(std::make_shared<XrtSession::CachedNode>(
-        tensorflow::ops::XRTCompile(scope, holders[0]).handle,
-        std::move(holders)));
+    tensorflow::ops::XRTCompile compile(scope, holders[0]);
+    std::vector<tensorflow::Output> outputs({compile.handle,
+                                             compile.program_shape});
+    cache->Add(std::make_shared<XrtSession::CachedNode>(std::move(outputs),
+                                                        std::move(holders)));
   }
   return cache->Get();
 }
@@ -1388,6 +1549,35 @@ const XrtSession::CachedNode& XrtComputationClient::GetAllocateNode(
   return cache->Get();
 }
 
+const XrtSession::CachedNode& XrtComputationClient::GetTransferNode(
+    XrtSession* session, const tensorflow::Scope& source_scope,
+    const string& source_device, const tensorflow::Scope& scope,
+    const string& device, const Shape& shape) const {
+  // Both the source device and the shape are baked into the graph, so they need
+  // to be part of the key.
+  std::stringstream ss;
+  ss << "XRTTransfer(" << source_device << ", " << shape << ")";
+  XrtSession::NodeCache* cache =
+      session->GetNodeCache(XrtSession::GetCacheKey(ss.str(), device));
+  if (cache->Empty()) {
+    XLA_COUNTER("XRTTransfer_Empty", 1);
+    tensorflow::TensorShape tensor_shape(shape.dimensions());
+    std::vector<int> layout(shape.layout().minor_to_major().begin(),
+                            shape.layout().minor_to_major().end());
+    std::vector<tensorflow::ops::Placeholder> holders(
+        {tensorflow::ops::Placeholder(source_scope, tensorflow::DT_INT64)});
+    tensorflow::ops::XRTReadToTensor read(
+        source_scope, holders[0], {XlaTypeToDataType(shape.element_type())});
+    tensorflow::ops::XRTAllocateFromTensor::Attrs alloc_attrs =
+        tensorflow::ops::XRTAllocateFromTensor::Layouts(layout);
+    cache->Add(std::make_shared<XrtSession::CachedNode>(
+        tensorflow::ops::XRTAllocateFromTensor(scope, {read.tensors[0]},
+                                               {tensor_shape}, alloc_attrs),
+        std::move(holders)));
+  }
+  return cache->Get();
+}
+
 const XrtSession::CachedNode&
 XrtComputationClient::GetReleaseAllocationHandleNode(
     XrtSession* session, const tensorflow::Scope& scope,
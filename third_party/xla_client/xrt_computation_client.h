@@ -138,6 +138,10 @@ class XrtComputationClient : public ComputationClient {
   std::vector<Literal> TransferFromServer(
       tensorflow::gtl::ArraySlice<const DataPtr> handles) override;
 
+  std::vector<DataPtr> TransferToDevice(
+      tensorflow::gtl::ArraySlice<const DataPtr> handles,
+      const string& device) override;
+
   std::vector<ComputationPtr> Compile(
       std::vector<CompileInstance> instances) override;
 
@@ -191,8 +195,8 @@ class XrtComputationClient : public ComputationClient {
     struct Hash {
       size_t operator()(const CompilationCacheKey& entry) const {
         util::PartialHasher<string, 4096> hasher;
-        return tensorflow::Hash64(entry.domain.data(), entry.domain.size(),
-                                  hasher(entry.serialized_computation));
+        return util::FastHash64(entry.domain.data(), entry.domain.size(),
+                                hasher(entry.serialized_computation));
       }
     };
 
@@ -211,6 +215,39 @@ class XrtComputationClient : public ComputationClient {
     string serialized_computation;
   };
 
+  // The key of the chained plans cache. It captures the structure of the chain
+  // (the computation handles and the input and output wiring of the operations)
+  // but not the device data handles, which get rebound at every execution.
+  struct ChainedPlanKey {
+    struct Hash {
+      size_t operator()(const ChainedPlanKey& entry) const {
+        return util::MHash(entry.device, entry.rng_seed, entry.structure);
+      }
+    };
+
+    bool operator==(const ChainedPlanKey& rhs) const {
+      return device == rhs.device && rng_seed == rhs.rng_seed &&
+             structure == rhs.structure;
+    }
+
+    string device;
+    size_t rng_seed = 0;
+    std::vector<int64> structure;
+  };
+
+  // The XRTChainedExecutePlan (and its associated data) cached for a given
+  // sequence of chained operations. The plans only differ by the handles of
+  // their device data operations, which are rebound at every execution.
+  struct ChainedPlan {
+    // Serializes the access to the plan, as executions rebind its data handles.
+    std::mutex lock;
+    xrt::XRTChainedExecutePlan plan;
+    string serialized_config;
+    // The indices of the plan operations which are device data inputs.
+    std::vector<size_t> data_ops;
+    std::vector<Shape> result_shapes;
+  };
+
   // When we split a batch operation into per-session batches, we use this data
   // structure to collect the per-session work.
   struct SessionWork {
@@ -305,6 +342,12 @@ class XrtComputationClient : public ComputationClient {
 
   void InitSession(XrtSession* session) const;
 
+  // Retrieves the cached XRTChainedExecutePlan for the given operations,
+  // creating it if not present within the cache.
+  std::shared_ptr<ChainedPlan> GetChainedPlan(
+      tensorflow::gtl::ArraySlice<const ExecuteChainedOp> ops,
+      const string& device);
+
   // Implement the chained execution using the XRTExecuteChained op support.
   std::vector<DataPtr> ExecuteChainedXrt(
       tensorflow::gtl::ArraySlice<const ExecuteChainedOp> ops,
@@ -384,6 +427,21 @@ class XrtComputationClient : public ComputationClient {
                                                 const string& device,
                                                 const Shape& shape) const;
 
+  // Creates an XRT graph which copies a device allocation with the given shape
+  // from the source_scope device to the scope one, with the data flowing among
+  // the TF workers:
+  //
+  //  XRTAllocateFromTensor(
+  //    XRTReadToTensor(holders[0])
+  //  )
+  //
+  // With:
+  //  holders[0] = The source handle place-holder (DT_INT64)
+  const XrtSession::CachedNode& GetTransferNode(
+      XrtSession* session, const tensorflow::Scope& source_scope,
+      const string& source_device, const tensorflow::Scope& scope,
+      const string& device, const Shape& shape) const;
+
   // Creates an XRTReleaseAllocationHandle node:
   //
   //  XRTReleaseAllocationHandle(
@@ -461,6 +519,8 @@ class XrtComputationClient : public ComputationClient {
   std::unique_ptr<util::TriggeredTask> triggered_task_;
   util::Cache<CompilationCacheKey, Computation, CompilationCacheKey::Hash>
       compilation_cache_;
+  util::Cache<ChainedPlanKey, ChainedPlan, ChainedPlanKey::Hash>
+      chained_plan_cache_;
   std::atomic<size_t> rng_seed_;
   // Access to the following members must be done while holding lock_.
   // XRT thread safety semantics.
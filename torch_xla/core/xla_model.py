@@ -366,7 +366,81 @@ def all_reduce(reduce_type, inputs, scale=1.0, groups=[]):
       reduce_type, inputs, _get_all_reduce_token(), scale, groups)
 
 
-def add_step_closure(closure, args=()):
+class _AsyncStepClosureRunner(object):
+
+  def __init__(self):
+    self._queue = kq.Queue(
+        maxsize=xu.getenv_as('XLA_ASYNC_STEP_CLOSURES_QUEUE', int, 64))
+    self._lock = threading.Lock()
+    self._done_cv = threading.Condition(self._lock)
+    self._pending = 0
+    self._error = None
+    self._thread = threading.Thread(target=self._run)
+    self._thread.daemon = True
+    self._thread.start()
+
+  def _raise_error(self):
+    error, self._error = self._error, None
+    if error is not None:
+      raise error
+
+  def schedule(self, closures):
+
+    def select_fn(v):
+      return type(v) == torch.Tensor and is_xla_tensor(v)
+
+    with self._lock:
+      self._raise_error()
+    tensors = []
+    xu.for_each_instance([args for _, args in closures], select_fn,
+                         tensors.append)
+    # All the XLA tensors captured by the step closures are fetched with a
+    # single asynchronous operation, which waits for the step execution to
+    # complete within the C++ thread pool.
+    future = None
+    if tensors:
+      future = torch_xla._XLAC._xla_get_tensors_async(tensors)
+    with self._lock:
+      self._pending += 1
+    self._queue.put((future, closures, select_fn))
+
+  def wait(self):
+    with self._lock:
+      while self._pending > 0:
+        self._done_cv.wait()
+      self._raise_error()
+
+  def _run(self):
+    while True:
+      future, closures, select_fn = self._queue.get()
+      try:
+        cpu_tensors = iter(future.wait() if future is not None else [])
+        for closure, args in closures:
+          cpu_args = xu.for_each_instance_rewrite(args, select_fn,
+                                                  lambda x: next(cpu_tensors))
+          closure(*cpu_args)
+      except Exception as e:
+        with self._lock:
+          if self._error is None:
+            self._error = e
+      with self._lock:
+        self._pending -= 1
+        self._done_cv.notify_all()
+
+
+_ASYNC_STEP_CLOSURE_RUNNER = None
+_ASYNC_STEP_CLOSURE_RUNNER_LOCK = threading.Lock()
+
+
+def _get_async_step_closure_runner():
+  global _ASYNC_STEP_CLOSURE_RUNNER
+  with _ASYNC_STEP_CLOSURE_RUNNER_LOCK:
+    if _ASYNC_STEP_CLOSURE_RUNNER is None:
+      _ASYNC_STEP_CLOSURE_RUNNER = _AsyncStepClosureRunner()
+    return _ASYNC_STEP_CLOSURE_RUNNER
+
+
+def add_step_closure(closure, args=(), run_async=False):
   """Adds a closure to the list of the ones to be run at the end of the step.
 
   Many times during model training there is the need to print/report (print to
@@ -383,16 +457,29 @@ def add_step_closure(closure, args=()):
   Step closures will be run sequentially in the order they have been queued.
   Note that even though using this API the execution will be optimized, it is
   advised to throttle the printing/reporting events once every N steps.
+  If `run_async` is True, the closure will be run on a background thread once
+  the step execution completes, and the XLA tensors within `args` will be
+  replaced with their PyTorch CPU counterparts. This frees the training loop
+  from waiting for the step results, and asynchronous closures are still run in
+  the order they have been queued. Exceptions raised by asynchronous closures
+  are re-raised from the following `mark_step()` or `wait_step_closures()`
+  call.
 
   Args:
     closure (callable): The function to be called.
     args (tuple): The arguments to be passed to the closure.
+    run_async (bool, optional): Whether the closure should be run in background.
+      Default: False
   """
-  step_closures = getattr(_TLS, 'step_closures', None)
+  attr = 'async_step_closures' if run_async else 'step_closures'
+  step_closures = getattr(_TLS, attr, None)
   if step_closures is None:
     step_closures = []
-    _TLS.step_closures = step_closures
-  step_closures.append(lambda a=args: closure(*a))
+    setattr(_TLS, attr, step_closures)
+  if run_async:
+    step_closures.append((closure, args))
+  else:
+    step_closures.append(lambda a=args: closure(*a))
 
 
 def _run_step_closures():
@@ -401,6 +488,19 @@ def _run_step_closures():
     _TLS.step_closures = []
     for closure in step_closures:
       closure()
+  async_step_closures = getattr(_TLS, 'async_step_closures', None)
+  if async_step_closures:
+    _TLS.async_step_closures = []
+    _get_async_step_closure_runner().schedule(async_step_closures)
+
+
+def wait_step_closures():
+  """Waits for all the asynchronous step closures queued so far to complete.
+
+  Raises the exception thrown by an asynchronous step closure, if any.
+  """
+  if _ASYNC_STEP_CLOSURE_RUNNER is not None:
+    _ASYNC_STEP_CLOSURE_RUNNER.wait()
 
 
 def mark_step():
@@ -415,6 +515,24 @@ def mark_step():
   _TLS.all_reduce_token = None
 
 
+def sync_tensors(tensors, wait=False):
+  """Runs the pending computations needed by the given tensors.
+
+  Unlike `mark_step()`, only the graph needed to compute the given tensors is
+  compiled and executed. The live tensors whose pending computations are part of
+  such graph get materialized as well, while the pending computations of all the
+  other live tensors are left untouched, to be run at the next step marker.
+
+  Args:
+    tensors (torch.Tensor...): The XLA tensors to be synced. They must all be on
+      the same device.
+    wait (bool, optional): Whether the call should wait for the computation to
+      complete on device.
+      Default: False
+  """
+  torch_xla._XLAC._xla_sync_tensors_closure(tensors, devices=[], wait=wait)
+
+
 def wait_device_ops(devices=[]):
   """Waits for all the async operations on the given devices to complete.
 
@@ -425,6 +543,34 @@ def wait_device_ops(devices=[]):
   torch_xla._XLAC._xla_wait_device_ops(devices=devices)
 
 
+def set_rng_state(seed, device=None):
+  """Sets the random number generator state of the XLA devices.
+
+  The random operations executed on the devices are a function of the seed and
+  of their order within the step, so setting the same seed replays the same
+  random values.
+
+  Args:
+    seed (integer): The seed to be set.
+    device (string, optional): The device whose seed needs to be set. If
+      missing, the seed of all the devices is set.
+  """
+  torch_xla._XLAC._xla_set_rng_seed(seed, str(device) if device else '')
+
+
+def get_rng_state(device=None):
+  """Gets the random number generator state of an XLA device.
+
+  Args:
+    device (string, optional): The device whose seed needs to be retrieved. If
+      missing, the default device is used.
+
+  Returns:
+    The seed the device is using for the current step.
+  """
+  return torch_xla._XLAC._xla_get_rng_seed(str(device) if device else '')
+
+
 def optimizer_step(optimizer, barrier=False, optimizer_args={}):
   """Run the provided optimizer step and issue the XLA device step computation.
 
@@ -493,6 +639,87 @@ def save(data, file_or_path, master_only=True):
     torch.save(cpu_data, file_or_path)
 
 
+class _CheckpointTensor(object):
+
+  def __init__(self, index, requires_grad):
+    self.index = index
+    self.requires_grad = requires_grad
+
+
+def save_checkpoint(data,
+                    path,
+                    master_only=True,
+                    batch_bytes=256 * 1024 * 1024,
+                    shard_bytes=1024 * 1024 * 1024):
+  """Saves the input data into a sharded checkpoint.
+
+  Differently from `save()`, the content of the XLA tensors is streamed to a
+  set of shard files, fetching the device data in batches of `batch_bytes`
+  bytes, without ever holding a full host copy of the tensors. The rest of the
+  data is saved with `torch.save()` into `path`, while the tensors content is
+  stored into `path.shard-NNNNN` files, described by the `path.manifest` file.
+
+  Args:
+    data: The input data to be saved. Any nested combination of Python objects
+      (list, tuples, sets, dicts, ...).
+    path: The destination path of the checkpoint.
+    master_only (bool): Whether only the master device should save the data. If
+      False, the `path` argument should be a different path for each of the
+      ordinals taking part to the replication.
+      Default: True
+    batch_bytes (int): The maximum amount of tensor data fetched from the
+      devices in a single batch.
+      Default: 256MB
+    shard_bytes (int): The size after which a new shard file is started.
+      Default: 1GB
+  """
+
+  def select_fn(v):
+    return type(v) == torch.Tensor and is_xla_tensor(v)
+
+  tensors = []
+
+  def convert_fn(value):
+    tensors.append(value)
+    return _CheckpointTensor(len(tensors) - 1, value.requires_grad)
+
+  skeleton = xu.for_each_instance_rewrite(data, select_fn, convert_fn)
+  if not master_only or is_master_ordinal():
+    torch_xla._XLAC._xla_write_checkpoint(
+        path, tensors, batch_bytes=batch_bytes, shard_bytes=shard_bytes)
+    torch.save(skeleton, path)
+  else:
+    torch_xla._XLAC._xla_sync_multi(
+        tensors, devices=[], wait=True, sync_xla_data=True)
+
+
+def load_checkpoint(path, device=None):
+  """Loads data saved with the `save_checkpoint()` API.
+
+  Args:
+    path: The path of the checkpoint.
+    device (string or torch.device, optional): If specified, the device where
+      the tensors should be loaded. Otherwise the tensors will be loaded on the
+      PyTorch CPU device.
+
+  Returns:
+    The loaded data.
+  """
+  skeleton = torch.load(path)
+  if device is not None:
+    # The shard files are memory mapped and uploaded straight to the device,
+    # without materializing the tensors in host memory first.
+    tensors = torch_xla._XLAC._xla_read_checkpoint_to_device(path, str(device))
+  else:
+    tensors = torch_xla._XLAC._xla_read_checkpoint(path)
+
+  def convert_fn(value):
+    return tensors[value.index].requires_grad_(value.requires_grad)
+
+  return xu.for_each_instance_rewrite(
+      skeleton, lambda x: isinstance(x, _CheckpointTensor), convert_fn)
+
+
 def send_cpu_data_to_device(data, device):
 
   def convert_fn(tensors):
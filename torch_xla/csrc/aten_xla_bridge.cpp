@@ -8,6 +8,7 @@
 #include "tensorflow/compiler/xla/xla_client/computation_client.h"
 #include "tensorflow/compiler/xla/xla_client/debug_macros.h"
 #include "torch_xla/csrc/device.h"
+#include "torch_xla/csrc/op_profiler.h"
 #include "torch_xla/csrc/tensor_impl.h"
 #include "torch_xla/csrc/torch_util.h"
 
@@ -46,9 +47,16 @@ AtenXlaDeviceMapper* AtenXlaDeviceMapper::Get() {
   return device_mapper;
 }
 
+void ProfileTransfer(const at::Tensor& tensor) {
+  if (OpProfiler::IsProfiling() && tensor.defined()) {
+    OpProfiler::AddTransferBytes(tensor.nbytes());
+  }
+}
+
 }  // namespace
 
 c10::optional<XLATensor> TryGetXlaTensor(const at::Tensor& tensor) {
+  XLA_OP_PROFILE_PHASE(OpProfiler::kBridge);
   XLATensorImpl* impl =
       dynamic_cast<XLATensorImpl*>(tensor.unsafeGetTensorImpl());
   if (impl == nullptr) {
@@ -58,6 +66,7 @@ c10::optional<XLATensor> TryGetXlaTensor(const at::Tensor& tensor) {
 }
 
 XLATensor GetXlaTensor(const at::Tensor& tensor) {
+  XLA_OP_PROFILE_PHASE(OpProfiler::kBridge);
   auto xtensor = TryGetXlaTensor(tensor);
   XLA_CHECK(xtensor) << "Input tensor is not an XLA tensor: "
                      << tensor.toString();
@@ -74,6 +83,7 @@ void ReplaceXlaTensor(const at::Tensor& tensor, XLATensor new_xla_tensor) {
 
 std::vector<XLATensor> GetXlaTensors(
     tensorflow::gtl::ArraySlice<const at::Tensor> tensors) {
+  XLA_OP_PROFILE_PHASE(OpProfiler::kBridge);
   std::vector<XLATensor> xla_tensors;
   xla_tensors.reserve(tensors.size());
   for (const auto& tensor : tensors) {
@@ -83,11 +93,16 @@ std::vector<XLATensor> GetXlaTensors(
 }
 
 XLATensor GetOrCreateXlaTensor(const at::Tensor& tensor, const Device& device) {
+  XLA_OP_PROFILE_PHASE(OpProfiler::kBridge);
   if (!tensor.defined()) {
     return XLATensor();
   }
   auto xtensor = TryGetXlaTensor(tensor);
-  return xtensor ? *xtensor : XLATensor::Create(tensor, device);
+  if (xtensor) {
+    return *xtensor;
+  }
+  ProfileTransfer(tensor);
+  return XLATensor::Create(tensor, device);
 }
 
 std::vector<at::Tensor> XlaCreateTensorList(const at::TensorList& tensors) {
@@ -114,6 +129,7 @@ std::vector<at::Tensor> XlaCreateTensorList(const at::TensorList& tensors) {
   for (size_t i = 0, defined_pos = 0; i < tensors.size(); ++i) {
     if (to_translate[i]) {
       aten_xla_tensors[i] = std::move(defined_aten_xla_tensors[defined_pos++]);
+      ProfileTransfer(aten_xla_tensors[i]);
     }
   }
   return aten_xla_tensors;
@@ -126,7 +142,9 @@ void XlaUpdateTensors(
   for (auto index : indices) {
     auto xtensor = TryGetXlaTensor(dest_xla_tensors.at(index));
     if (xtensor) {
+      ProfileTransfer(source_cpu_tensors.at(index));
       xtensor->UpdateFromTensor(source_cpu_tensors.at(index));
+      xtensor->QueueDeviceUpload();
     } else {
       dest_xla_tensors.at(index).copy_(source_cpu_tensors.at(index));
     }
@@ -206,6 +224,7 @@ at::Tensor XlaToAtenTensor(XLATensor xla_tensor,
 }
 
 at::Tensor AtenFromXlaTensor(XLATensor xla_tensor) {
+  XLA_OP_PROFILE_PHASE(OpProfiler::kBridge);
   return xla_tensor.is_null() ? at::Tensor()
                               : at::Tensor(c10::make_intrusive<XLATensorImpl>(
                                     std::move(xla_tensor)));
@@ -239,5 +258,26 @@ std::vector<at::Tensor> CreateXlaTensors(const std::vector<at::Tensor>& tensors,
   return xtensors;
 }
 
+at::Tensor CreateFallbackXlaTensor(at::Tensor tensor,
+                                   const c10::optional<Device>& device) {
+  if (tensor.defined() && device) {
+    ProfileTransfer(tensor);
+    XLATensor xla_tensor = XLATensor::Create(std::move(tensor), *device);
+    xla_tensor.QueueDeviceUpload();
+    tensor = AtenFromXlaTensor(xla_tensor);
+  }
+  return tensor;
+}
+
+std::vector<at::Tensor> CreateFallbackXlaTensors(
+    const std::vector<at::Tensor>& tensors,
+    const c10::optional<Device>& device) {
+  std::vector<at::Tensor> xtensors;
+  for (auto& tensor : tensors) {
+    xtensors.push_back(CreateFallbackXlaTensor(tensor, device));
+  }
+  return xtensors;
+}
+
 }  // namespace bridge
 }  // namespace torch_xla
@@ -75,5 +75,15 @@ at::Tensor CreateXlaTensor(at::Tensor tensor,
 std::vector<at::Tensor> CreateXlaTensors(const std::vector<at::Tensor>& tensors,
                                          const c10::optional<Device>& device);
 
+// Like CreateXlaTensor(), for the results of the CPU fallback operations. The
+// upload of the data is queued, see XLATensor::QueueDeviceUpload(), so that
+// the results of a run of fallbacks reach the device with a single transfer.
+at::Tensor CreateFallbackXlaTensor(at::Tensor tensor,
+                                   const c10::optional<Device>& device);
+
+std::vector<at::Tensor> CreateFallbackXlaTensors(
+    const std::vector<at::Tensor>& tensors,
+    const c10::optional<Device>& device);
+
 }  // namespace bridge
 }  // namespace torch_xla
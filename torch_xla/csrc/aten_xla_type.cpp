@@ -13,6 +13,7 @@
 #include "torch_xla/csrc/debug_util.h"
 #include "torch_xla/csrc/device.h"
 #include "torch_xla/csrc/helpers.h"
+#include "torch_xla/csrc/op_profiler.h"
 #include "torch_xla/csrc/ops/as_strided.h"
 #include "torch_xla/csrc/ops/einsum.h"
 #include "torch_xla/csrc/ops/index_ops.h"
@@ -90,6 +91,44 @@ std::tuple<XLATensor, XLATensor> GetPromotedXlaTensorsForBinaryOp(
   return std::make_tuple(tensor1, tensor2);
 }
 
+// Only the XLA TPU backend for now implements the dynamic dimension setting,
+// and its use is opt-in.
+bool UseDynamicShape(const XLATensor& tensor, const std::string& name) {
+  return DebugUtil::ExperimentEnabled(name) &&
+         tensor.GetDevice().hw_type == DeviceType::TPU;
+}
+
+// Turns the padded result of an operation with data dependent output shape,
+// into one with the valid elements only. The padded result and its count are
+// computed with a single device execution, and only the count is fetched to
+// host, as an ATen tensor needs a concrete shape.
+XLATensor GetValidPaddedResult(std::tuple<XLATensor, XLATensor> result) {
+  std::vector<XLATensor> tensors = {std::get<0>(result), std::get<1>(result)};
+  XLATensor::SyncTensorsGraph(&tensors, /*devices=*/{}, /*wait=*/true,
+                              /*sync_xla_data=*/false);
+  XLA_COUNTER("PaddedResultCountFetch", 1);
+  xla::int64 count = tensors[1].ToTensor().item().toLong();
+  return XLATensor::slice(tensors[0], /*dim=*/0, /*start=*/0, /*end=*/count,
+                          /*step=*/1);
+}
+
+// Masked updates copy the source elements, in order, into the input elements
+// selected by the mask, so the source must hold at least as many elements as
+// the selected ones. Their count is data dependent, so it is fetched to host,
+// and this is only needed when the source is smaller than the input.
+void CheckMaskedSourceSize(const XLATensor& expanded_mask,
+                           xla::int64 source_elements) {
+  XLA_COUNTER("MaskedSourceSizeCheck", 1);
+  XLATensor count = XLATensor::sum(
+      expanded_mask,
+      xla::util::Iota<xla::int64>(expanded_mask.shape().get().rank()),
+      /*keep_reduced_dimensions=*/false, at::ScalarType::Long);
+  xla::int64 selected_elements = count.ToTensor().item().toLong();
+  XLA_CHECK_LE(selected_elements, source_elements)
+      << "The mask selects " << selected_elements
+      << " elements, but the source only holds " << source_elements;
+}
+
 void AtenInitialize() {
   TF_VLOG(1) << "PyTorch GIT revision: " << TORCH_GITREV;
   TF_VLOG(1) << "XLA GIT revision: " << XLA_GITREV;
@@ -101,34 +140,34 @@ void AtenInitialize() {
 }  // namespace
 
 at::Tensor AtenXlaType::__and__(const at::Tensor& self, at::Scalar other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::__and__(bridge::GetXlaTensor(self), other));
 }
 
 at::Tensor AtenXlaType::__and__(const at::Tensor& self,
                                 const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::__and__(
       bridge::GetXlaTensor(self), bridge::GetXlaTensor(other)));
 }
 
 at::Tensor& AtenXlaType::__iand__(at::Tensor& self, at::Scalar other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::__iand__(self_tensor, other);
   return self;
 }
 
 at::Tensor& AtenXlaType::__iand__(at::Tensor& self, const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::__iand__(self_tensor, bridge::GetXlaTensor(other));
   return self;
 }
 
 at::Tensor& AtenXlaType::__ilshift__(at::Tensor& self, at::Scalar other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::__ilshift__(self_tensor, other);
   return self;
@@ -136,28 +175,28 @@ at::Tensor& AtenXlaType::__ilshift__(at::Tensor& self, at::Scalar other) {
 
 at::Tensor& AtenXlaType::__ilshift__(at::Tensor& self,
                                      const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::__ilshift__(self_tensor, bridge::GetXlaTensor(other));
   return self;
 }
 
 at::Tensor& AtenXlaType::__ior__(at::Tensor& self, at::Scalar other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::__ior__(self_tensor, other);
   return self;
 }
 
 at::Tensor& AtenXlaType::__ior__(at::Tensor& self, const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::__ior__(self_tensor, bridge::GetXlaTensor(other));
   return self;
 }
 
 at::Tensor& AtenXlaType::__irshift__(at::Tensor& self, at::Scalar other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::__irshift__(self_tensor, other);
   return self;
@@ -165,54 +204,54 @@ at::Tensor& AtenXlaType::__irshift__(at::Tensor& self, at::Scalar other) {
 
 at::Tensor& AtenXlaType::__irshift__(at::Tensor& self,
                                      const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::__irshift__(self_tensor, bridge::GetXlaTensor(other));
   return self;
 }
 
 at::Tensor AtenXlaType::__lshift__(const at::Tensor& self, at::Scalar other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::__lshift__(bridge::GetXlaTensor(self), other));
 }
 
 at::Tensor AtenXlaType::__lshift__(const at::Tensor& self,
                                    const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::__lshift__(
       bridge::GetXlaTensor(self), bridge::GetXlaTensor(other)));
 }
 
 at::Tensor AtenXlaType::__or__(const at::Tensor& self, at::Scalar other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::__or__(bridge::GetXlaTensor(self), other));
 }
 
 at::Tensor AtenXlaType::__or__(const at::Tensor& self,
                                const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::__or__(
       bridge::GetXlaTensor(self), bridge::GetXlaTensor(other)));
 }
 
 at::Tensor AtenXlaType::__rshift__(const at::Tensor& self, at::Scalar other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::__rshift__(bridge::GetXlaTensor(self), other));
 }
 
 at::Tensor AtenXlaType::__rshift__(const at::Tensor& self,
                                    const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::__rshift__(
       bridge::GetXlaTensor(self), bridge::GetXlaTensor(other)));
 }
 
 at::Tensor AtenXlaType::_adaptive_avg_pool2d(const at::Tensor& self,
                                              at::IntArrayRef output_size) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   auto output_size_list = XlaHelpers::I64List(output_size);
   if (!IsSupportedAdaptiveAvgPool2d(XlaHelpers::I64List(self.sizes()),
                                     output_size_list)) {
@@ -224,7 +263,7 @@ at::Tensor AtenXlaType::_adaptive_avg_pool2d(const at::Tensor& self,
 
 at::Tensor AtenXlaType::_adaptive_avg_pool2d_backward(
     const at::Tensor& grad_output, const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   int64_t rank = grad_output.dim();
   std::vector<xla::int64> output_size{grad_output.size(rank - 2),
                                       grad_output.size(rank - 1)};
@@ -238,7 +277,7 @@ at::Tensor AtenXlaType::_adaptive_avg_pool2d_backward(
 
 at::Tensor& AtenXlaType::bitwise_not_out(at::Tensor& out,
                                          const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor out_tensor = bridge::GetXlaTensor(out);
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::bitwise_not_out(out_tensor, self_tensor);
@@ -248,7 +287,7 @@ at::Tensor& AtenXlaType::bitwise_not_out(at::Tensor& out,
 at::Tensor& AtenXlaType::bitwise_xor_out(at::Tensor& out,
                                          const at::Tensor& self,
                                          at::Scalar other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor out_tensor = bridge::GetXlaTensor(out);
   XLATensor::bitwise_xor_out(out_tensor, bridge::GetXlaTensor(self), other);
   return out;
@@ -257,7 +296,7 @@ at::Tensor& AtenXlaType::bitwise_xor_out(at::Tensor& out,
 at::Tensor& AtenXlaType::bitwise_xor_out(at::Tensor& out,
                                          const at::Tensor& self,
                                          const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor out_tensor = bridge::GetXlaTensor(out);
   XLATensor::bitwise_xor_out(out_tensor, bridge::GetXlaTensor(self),
                              bridge::GetXlaTensor(other));
@@ -266,7 +305,7 @@ at::Tensor& AtenXlaType::bitwise_xor_out(at::Tensor& out,
 
 at::Tensor AtenXlaType::_copy_from(const at::Tensor& self,
                                    const at::Tensor& dst, bool non_blocking) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   copy_(const_cast<at::Tensor&>(dst), self, non_blocking);
   return dst;
 }
@@ -275,13 +314,13 @@ at::Tensor& AtenXlaType::_index_put_impl_(at::Tensor& self,
                                           at::TensorList indices,
                                           const at::Tensor& values,
                                           bool accumulate, bool /* unsafe */) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return index_put_(self, indices, values, accumulate);
 }
 
 at::Tensor AtenXlaType::_log_softmax(const at::Tensor& self, int64_t dim,
                                      bool /* half_to_float */) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::log_softmax(bridge::GetXlaTensor(self), dim, c10::nullopt));
 }
@@ -289,7 +328,7 @@ at::Tensor AtenXlaType::_log_softmax(const at::Tensor& self, int64_t dim,
 at::Tensor AtenXlaType::_log_softmax_backward_data(
     const at::Tensor& grad_output, const at::Tensor& output, int64_t dim,
     const at::Tensor& /* self */) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::log_softmax_backward(
       bridge::GetXlaTensor(grad_output), bridge::GetXlaTensor(output), dim));
 }
@@ -297,7 +336,7 @@ at::Tensor AtenXlaType::_log_softmax_backward_data(
 at::Tensor AtenXlaType::_s_where(const at::Tensor& condition,
                                  const at::Tensor& self,
                                  const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::where(
       bridge::GetXlaTensor(condition), bridge::GetXlaTensor(self),
       bridge::GetXlaTensor(other)));
@@ -305,7 +344,7 @@ at::Tensor AtenXlaType::_s_where(const at::Tensor& condition,
 
 at::Tensor AtenXlaType::_softmax(const at::Tensor& self, int64_t dim,
                                  bool /* half_to_float */) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::softmax(bridge::GetXlaTensor(self), dim, c10::nullopt));
 }
@@ -314,7 +353,7 @@ at::Tensor AtenXlaType::_softmax_backward_data(const at::Tensor& grad_output,
                                                const at::Tensor& output,
                                                int64_t dim,
                                                const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::softmax_backward(
       bridge::GetXlaTensor(grad_output), bridge::GetXlaTensor(output), dim));
 }
@@ -325,36 +364,36 @@ at::Tensor AtenXlaType::_trilinear(const at::Tensor& i1, const at::Tensor& i2,
                                    at::IntArrayRef expand2,
                                    at::IntArrayRef expand3,
                                    at::IntArrayRef sumdim, int64_t unroll_dim) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return at::native::_trilinear(i1, i2, i3, expand1, expand2, expand3, sumdim,
                                 unroll_dim);
 }
 
 at::Tensor AtenXlaType::_unsafe_view(const at::Tensor& self,
                                      at::IntArrayRef size) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return view(self, size);
 }
 
 at::Tensor AtenXlaType::abs(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::abs(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor& AtenXlaType::abs_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::abs_(self_tensor);
   return self;
 }
 
 at::Tensor AtenXlaType::acos(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::acos(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor& AtenXlaType::acos_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::acos_(self_tensor);
   return self;
@@ -362,7 +401,7 @@ at::Tensor& AtenXlaType::acos_(at::Tensor& self) {
 
 at::Tensor AtenXlaType::add(const at::Tensor& self, const at::Tensor& other,
                             at::Scalar alpha) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   auto xlatensors = GetPromotedXlaTensorsForBinaryOp(self, other);
   return bridge::AtenFromXlaTensor(
       XLATensor::add(std::get<0>(xlatensors), std::get<1>(xlatensors), alpha));
@@ -370,14 +409,14 @@ at::Tensor AtenXlaType::add(const at::Tensor& self, const at::Tensor& other,
 
 at::Tensor AtenXlaType::add(const at::Tensor& self, at::Scalar other,
                             at::Scalar alpha) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::add(bridge::GetXlaTensor(self), other, alpha));
 }
 
 at::Tensor& AtenXlaType::add_(at::Tensor& self, const at::Tensor& other,
                               at::Scalar alpha) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::add_(self_tensor,
                   bridge::GetOrCreateXlaTensor(other, self_tensor.GetDevice()),
@@ -387,7 +426,7 @@ at::Tensor& AtenXlaType::add_(at::Tensor& self, const at::Tensor& other,
 
 at::Tensor& AtenXlaType::add_(at::Tensor& self, at::Scalar other,
                               at::Scalar alpha) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::add_(self_tensor, other, alpha);
   return self;
@@ -396,7 +435,7 @@ at::Tensor& AtenXlaType::add_(at::Tensor& self, at::Scalar other,
 at::Tensor AtenXlaType::addcdiv(const at::Tensor& self,
                                 const at::Tensor& tensor1,
                                 const at::Tensor& tensor2, at::Scalar value) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::addcdiv(
       bridge::GetXlaTensor(self), value, bridge::GetXlaTensor(tensor1),
       bridge::GetXlaTensor(tensor2)));
@@ -404,7 +443,7 @@ at::Tensor AtenXlaType::addcdiv(const at::Tensor& self,
 
 at::Tensor& AtenXlaType::addcdiv_(at::Tensor& self, const at::Tensor& tensor1,
                                   const at::Tensor& tensor2, at::Scalar value) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::addcdiv_(self_tensor, value, bridge::GetXlaTensor(tensor1),
                       bridge::GetXlaTensor(tensor2));
@@ -414,7 +453,7 @@ at::Tensor& AtenXlaType::addcdiv_(at::Tensor& self, const at::Tensor& tensor1,
 at::Tensor AtenXlaType::addcmul(const at::Tensor& self,
                                 const at::Tensor& tensor1,
                                 const at::Tensor& tensor2, at::Scalar value) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::addcmul(
       bridge::GetXlaTensor(self), value, bridge::GetXlaTensor(tensor1),
       bridge::GetXlaTensor(tensor2)));
@@ -422,7 +461,7 @@ at::Tensor AtenXlaType::addcmul(const at::Tensor& self,
 
 at::Tensor& AtenXlaType::addcmul_(at::Tensor& self, const at::Tensor& tensor1,
                                   const at::Tensor& tensor2, at::Scalar value) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::addcmul_(self_tensor, value, bridge::GetXlaTensor(tensor1),
                       bridge::GetXlaTensor(tensor2));
@@ -432,7 +471,7 @@ at::Tensor& AtenXlaType::addcmul_(at::Tensor& self, const at::Tensor& tensor1,
 at::Tensor AtenXlaType::addmm(const at::Tensor& self, const at::Tensor& mat1,
                               const at::Tensor& mat2, at::Scalar beta,
                               at::Scalar alpha) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   // xla::dot doesn't support integer types.
   if (beta.to<double>() != 1 || alpha.to<double>() != 1 ||
       !at::native::is_floating_point(self) ||
@@ -447,12 +486,12 @@ at::Tensor AtenXlaType::addmm(const at::Tensor& self, const at::Tensor& mat1,
 }
 
 at::Tensor AtenXlaType::alias(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return self;
 }
 
 at::Tensor AtenXlaType::all(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   return bridge::AtenFromXlaTensor(XLATensor::all(
       self_tensor,
@@ -461,13 +500,13 @@ at::Tensor AtenXlaType::all(const at::Tensor& self) {
 }
 
 at::Tensor AtenXlaType::all(const at::Tensor& self, int64_t dim, bool keepdim) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::all(bridge::GetXlaTensor(self), {dim}, keepdim));
 }
 
 at::Tensor AtenXlaType::any(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   return bridge::AtenFromXlaTensor(XLATensor::any(
       self_tensor,
@@ -476,14 +515,14 @@ at::Tensor AtenXlaType::any(const at::Tensor& self) {
 }
 
 at::Tensor AtenXlaType::any(const at::Tensor& self, int64_t dim, bool keepdim) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::any(bridge::GetXlaTensor(self), {dim}, keepdim));
 }
 
 at::Tensor& AtenXlaType::arange_out(at::Tensor& out, at::Scalar start,
                                     at::Scalar end, at::Scalar step) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor out_tensor = bridge::GetXlaTensor(out);
   XLATensor::arange_out(out_tensor, start, end, step, out.scalar_type());
   return out;
@@ -492,7 +531,7 @@ at::Tensor& AtenXlaType::arange_out(at::Tensor& out, at::Scalar start,
 at::Tensor AtenXlaType::as_strided(const at::Tensor& self, at::IntArrayRef size,
                                    at::IntArrayRef stride,
                                    c10::optional<int64_t> storage_offset) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   auto xsize = XlaHelpers::I64List(size);
   if (!ir::ops::AsStrided::StrideIsSupported(xsize,
                                              XlaHelpers::I64List(stride))) {
@@ -506,7 +545,7 @@ at::Tensor AtenXlaType::as_strided(const at::Tensor& self, at::IntArrayRef size,
 at::Tensor& AtenXlaType::as_strided_(at::Tensor& self, at::IntArrayRef size,
                                      at::IntArrayRef stride,
                                      c10::optional<int64_t> storage_offset) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   auto xsize = XlaHelpers::I64List(size);
   if (!ir::ops::AsStrided::StrideIsSupported(xsize,
                                              XlaHelpers::I64List(stride))) {
@@ -519,37 +558,37 @@ at::Tensor& AtenXlaType::as_strided_(at::Tensor& self, at::IntArrayRef size,
 }
 
 at::Tensor AtenXlaType::asin(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::asin(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor& AtenXlaType::asin_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::asin_(self_tensor);
   return self;
 }
 
 at::Tensor AtenXlaType::atan(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::atan(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor AtenXlaType::atan2(const at::Tensor& self, const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::atan2(
       bridge::GetXlaTensor(self), bridge::GetXlaTensor(other)));
 }
 
 at::Tensor& AtenXlaType::atan2_(at::Tensor& self, const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::atan2_(self_tensor, bridge::GetXlaTensor(other));
   return self;
 }
 
 at::Tensor& AtenXlaType::atan_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::atan_(self_tensor);
   return self;
@@ -561,7 +600,7 @@ at::Tensor AtenXlaType::avg_pool2d(const at::Tensor& self,
                                    at::IntArrayRef padding, bool ceil_mode,
                                    bool count_include_pad,
                                    c10::optional<int64_t> divisor_override) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   if ((ceil_mode && count_include_pad) || divisor_override) {
     return AtenXlaTypeDefault::avg_pool2d(self, kernel_size, stride, padding,
                                           ceil_mode, count_include_pad,
@@ -578,7 +617,7 @@ at::Tensor AtenXlaType::avg_pool2d_backward(
     at::IntArrayRef kernel_size, at::IntArrayRef stride,
     at::IntArrayRef padding, bool ceil_mode, bool count_include_pad,
     c10::optional<int64_t> divisor_override) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   if ((ceil_mode && count_include_pad) || divisor_override) {
     return AtenXlaTypeDefault::avg_pool2d_backward(
         grad_output, self, kernel_size, stride, padding, ceil_mode,
@@ -597,7 +636,7 @@ at::Tensor AtenXlaType::avg_pool3d(const at::Tensor& self,
                                    at::IntArrayRef padding, bool ceil_mode,
                                    bool count_include_pad,
                                    c10::optional<int64_t> divisor_override) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   if ((ceil_mode && count_include_pad) || divisor_override) {
     return AtenXlaTypeDefault::avg_pool3d(self, kernel_size, stride, padding,
                                           ceil_mode, count_include_pad,
@@ -614,7 +653,7 @@ at::Tensor AtenXlaType::avg_pool3d_backward(
     at::IntArrayRef kernel_size, at::IntArrayRef stride,
     at::IntArrayRef padding, bool ceil_mode, bool count_include_pad,
     c10::optional<int64_t> divisor_override) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   if ((ceil_mode && count_include_pad) || divisor_override) {
     return AtenXlaTypeDefault::avg_pool3d_backward(
         grad_output, self, kernel_size, stride, padding, ceil_mode,
@@ -629,7 +668,7 @@ at::Tensor AtenXlaType::avg_pool3d_backward(
 
 at::Tensor AtenXlaType::bernoulli(const at::Tensor& self,
                                   at::Generator* generator) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   if (generator != nullptr) {
     return AtenXlaTypeDefault::bernoulli(self, generator);
   }
@@ -639,7 +678,7 @@ at::Tensor AtenXlaType::bernoulli(const at::Tensor& self,
 
 at::Tensor& AtenXlaType::bernoulli_(at::Tensor& self, double p,
                                     at::Generator* generator) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   if (generator != nullptr) {
     return AtenXlaTypeDefault::bernoulli_(self, p, generator);
   }
@@ -650,7 +689,7 @@ at::Tensor& AtenXlaType::bernoulli_(at::Tensor& self, double p,
 
 at::Tensor& AtenXlaType::bernoulli_(at::Tensor& self, const at::Tensor& p,
                                     at::Generator* generator) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   if (generator != nullptr) {
     return AtenXlaTypeDefault::bernoulli_(self, p, generator);
   }
@@ -663,7 +702,7 @@ at::Tensor AtenXlaType::binary_cross_entropy(const at::Tensor& self,
                                              const at::Tensor& target,
                                              const at::Tensor& weight,
                                              int64_t reduction) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor weight_tensor =
       bridge::GetOrCreateXlaTensor(weight, self_tensor.GetDevice());
@@ -674,7 +713,7 @@ at::Tensor AtenXlaType::binary_cross_entropy(const at::Tensor& self,
 at::Tensor AtenXlaType::binary_cross_entropy_backward(
     const at::Tensor& grad_output, const at::Tensor& self,
     const at::Tensor& target, const at::Tensor& weight, int64_t reduction) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor weight_tensor =
       bridge::GetOrCreateXlaTensor(weight, self_tensor.GetDevice());
@@ -686,13 +725,13 @@ at::Tensor AtenXlaType::binary_cross_entropy_backward(
 at::Tensor AtenXlaType::binary_cross_entropy_with_logits(
     const at::Tensor& self, const at::Tensor& target, const at::Tensor& weight,
     const at::Tensor& pos_weight, int64_t reduction) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return at::native::binary_cross_entropy_with_logits(self, target, weight,
                                                       pos_weight, reduction);
 }
 
 at::Tensor AtenXlaType::bmm(const at::Tensor& self, const at::Tensor& mat2) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   // xla::dot doesn't support integer types.
   if (!at::native::is_floating_point(self) ||
       !at::native::is_floating_point(mat2)) {
@@ -703,25 +742,25 @@ at::Tensor AtenXlaType::bmm(const at::Tensor& self, const at::Tensor& mat2) {
 }
 
 at::Tensor AtenXlaType::cat(at::TensorList tensors, int64_t dim) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::cat(bridge::GetXlaTensors(tensors), dim));
 }
 
 at::Tensor AtenXlaType::ceil(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::ceil(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor& AtenXlaType::ceil_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::ceil_(self_tensor);
   return self;
 }
 
 at::Tensor AtenXlaType::cholesky(const at::Tensor& self, bool upper) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::cholesky(bridge::GetXlaTensor(self), upper));
 }
@@ -729,40 +768,40 @@ at::Tensor AtenXlaType::cholesky(const at::Tensor& self, bool upper) {
 at::Tensor AtenXlaType::clamp(const at::Tensor& self,
                               c10::optional<at::Scalar> min,
                               c10::optional<at::Scalar> max) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::clamp(bridge::GetXlaTensor(self), min, max));
 }
 
 at::Tensor& AtenXlaType::clamp_(at::Tensor& self, c10::optional<at::Scalar> min,
                                 c10::optional<at::Scalar> max) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::clamp_(self_tensor, min, max);
   return self;
 }
 
 at::Tensor AtenXlaType::clamp_max(const at::Tensor& self, at::Scalar max) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::clamp(bridge::GetXlaTensor(self), c10::nullopt, max));
 }
 
 at::Tensor& AtenXlaType::clamp_max_(at::Tensor& self, at::Scalar max) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::clamp_(self_tensor, c10::nullopt, max);
   return self;
 }
 
 at::Tensor AtenXlaType::clamp_min(const at::Tensor& self, at::Scalar min) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::clamp(bridge::GetXlaTensor(self), min, c10::nullopt));
 }
 
 at::Tensor& AtenXlaType::clamp_min_(at::Tensor& self, at::Scalar min) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::clamp_(self_tensor, min, c10::nullopt);
   return self;
@@ -771,14 +810,14 @@ at::Tensor& AtenXlaType::clamp_min_(at::Tensor& self, at::Scalar min) {
 at::Tensor AtenXlaType::clone(
     const at::Tensor& self,
     c10::optional<at::MemoryFormat> /* memory_format */) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::clone(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor AtenXlaType::constant_pad_nd(const at::Tensor& self,
                                         at::IntArrayRef pad, at::Scalar value) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::constant_pad_nd(
       bridge::GetXlaTensor(self), XlaHelpers::I64List(pad), value));
 }
@@ -788,7 +827,7 @@ at::Tensor AtenXlaType::convolution_overrideable(
     const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias,
     at::IntArrayRef stride, at::IntArrayRef padding, at::IntArrayRef dilation,
     bool transposed, at::IntArrayRef output_padding, int64_t groups) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   if (bias.defined()) {
     return bridge::AtenFromXlaTensor(XLATensor::convolution_overrideable(
         bridge::GetXlaTensor(input), bridge::GetXlaTensor(weight),
@@ -811,7 +850,7 @@ AtenXlaType::convolution_backward_overrideable(
     const at::Tensor& weight, at::IntArrayRef stride, at::IntArrayRef padding,
     at::IntArrayRef dilation, bool transposed, at::IntArrayRef output_padding,
     int64_t groups, std::array<bool, 3> output_mask) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   auto gradients = XLATensor::convolution_backward_overrideable(
       bridge::GetXlaTensor(grad_output), bridge::GetXlaTensor(input),
       bridge::GetXlaTensor(weight), XlaHelpers::I64List(stride),
@@ -828,7 +867,7 @@ AtenXlaType::convolution_backward_overrideable(
 
 at::Tensor& AtenXlaType::copy_(at::Tensor& self, const at::Tensor& src,
                                bool non_blocking) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   auto self_tensor = bridge::TryGetXlaTensor(self);
   auto src_tensor = bridge::TryGetXlaTensor(src);
   if (!src_tensor) {
@@ -851,24 +890,24 @@ at::Tensor& AtenXlaType::copy_(at::Tensor& self, const at::Tensor& src,
 }
 
 at::Tensor AtenXlaType::cos(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::cos(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor& AtenXlaType::cos_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::cos_(self_tensor);
   return self;
 }
 
 at::Tensor AtenXlaType::cosh(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::cosh(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor& AtenXlaType::cosh_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::cosh_(self_tensor);
   return self;
@@ -876,7 +915,7 @@ at::Tensor& AtenXlaType::cosh_(at::Tensor& self) {
 
 at::Tensor AtenXlaType::cross(const at::Tensor& self, const at::Tensor& other,
                               c10::optional<int64_t> dim) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::cross(bridge::GetXlaTensor(self), bridge::GetXlaTensor(other),
                        XlaHelpers::I64Optional(dim)));
@@ -884,7 +923,7 @@ at::Tensor AtenXlaType::cross(const at::Tensor& self, const at::Tensor& other,
 
 at::Tensor AtenXlaType::cumprod(const at::Tensor& self, int64_t dim,
                                 c10::optional<at::ScalarType> dtype) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   if (IsOperationOnType(dtype, self_tensor.dtype(), at::ScalarType::Long)) {
     // XLA reduce-window does not support S64 mode.
@@ -895,7 +934,7 @@ at::Tensor AtenXlaType::cumprod(const at::Tensor& self, int64_t dim,
 
 at::Tensor AtenXlaType::cumsum(const at::Tensor& self, int64_t dim,
                                c10::optional<at::ScalarType> dtype) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   if (IsOperationOnType(dtype, self_tensor.dtype(), at::ScalarType::Long)) {
     // XLA reduce-window does not support S64 mode.
@@ -905,33 +944,33 @@ at::Tensor AtenXlaType::cumsum(const at::Tensor& self, int64_t dim,
 }
 
 at::Tensor AtenXlaType::diag(const at::Tensor& self, int64_t diagonal) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::diag(bridge::GetXlaTensor(self), diagonal));
 }
 
 at::Tensor AtenXlaType::diagonal(const at::Tensor& self, int64_t offset,
                                  int64_t dim1, int64_t dim2) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::diagonal(bridge::GetXlaTensor(self), offset, dim1, dim2));
 }
 
 at::Tensor AtenXlaType::div(const at::Tensor& self, const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   auto xlatensors = GetPromotedXlaTensorsForBinaryOp(self, other);
   return bridge::AtenFromXlaTensor(
       XLATensor::div(std::get<0>(xlatensors), std::get<1>(xlatensors)));
 }
 
 at::Tensor AtenXlaType::div(const at::Tensor& self, at::Scalar other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::div(bridge::GetXlaTensor(self), other));
 }
 
 at::Tensor& AtenXlaType::div_(at::Tensor& self, const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::div_(self_tensor,
                   bridge::GetOrCreateXlaTensor(other, self_tensor.GetDevice()));
@@ -939,14 +978,14 @@ at::Tensor& AtenXlaType::div_(at::Tensor& self, const at::Tensor& other) {
 }
 
 at::Tensor& AtenXlaType::div_(at::Tensor& self, at::Scalar other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::div_(self_tensor, other);
   return self;
 }
 
 at::Tensor AtenXlaType::dot(const at::Tensor& self, const at::Tensor& tensor) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLA_CHECK_EQ(self.dim(), 1)
       << "dot: Expected 1-D argument self, but got " << self.dim() << "-D";
   XLA_CHECK_EQ(tensor.dim(), 1)
@@ -961,7 +1000,7 @@ at::Tensor AtenXlaType::dot(const at::Tensor& self, const at::Tensor& tensor) {
 }
 
 at::Tensor AtenXlaType::einsum(std::string equation, at::TensorList tensors) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   if (tensors.size() != 2 ||
       !ir::ops::Einsum::SupportsEquation(equation, tensors[0].dim(),
                                          tensors[1].dim())) {
@@ -973,14 +1012,14 @@ at::Tensor AtenXlaType::einsum(std::string equation, at::TensorList tensors) {
 
 at::Tensor AtenXlaType::elu(const at::Tensor& self, at::Scalar alpha,
                             at::Scalar scale, at::Scalar input_scale) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::elu(bridge::GetXlaTensor(self), alpha, scale, input_scale));
 }
 
 at::Tensor& AtenXlaType::elu_(at::Tensor& self, at::Scalar alpha,
                               at::Scalar scale, at::Scalar input_scale) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::elu_(self_tensor, alpha, scale, input_scale);
   return self;
@@ -990,7 +1029,7 @@ at::Tensor AtenXlaType::elu_backward(const at::Tensor& grad_output,
                                      at::Scalar alpha, at::Scalar scale,
                                      at::Scalar input_scale,
                                      const at::Tensor& output) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::elu_backward(bridge::GetXlaTensor(grad_output), alpha, scale,
                               input_scale, bridge::GetXlaTensor(output)));
@@ -1000,7 +1039,7 @@ at::Tensor AtenXlaType::embedding(const at::Tensor& weight,
                                   const at::Tensor& indices,
                                   int64_t padding_idx, bool scale_grad_by_freq,
                                   bool sparse) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   // TODO: for now route to native, which dispatches supported XLA operations.
   // We need to make use of the TPU embedding core here eventually.
   return at::native::embedding(weight, indices, padding_idx, scale_grad_by_freq,
@@ -1012,7 +1051,7 @@ at::Tensor AtenXlaType::embedding_dense_backward(const at::Tensor& grad_output,
                                                  int64_t num_weights,
                                                  int64_t padding_idx,
                                                  bool scale_grad_by_freq) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::embedding_dense_backward(
       bridge::GetXlaTensor(grad_output), bridge::GetXlaTensor(indices),
       num_weights, padding_idx, scale_grad_by_freq));
@@ -1021,7 +1060,7 @@ at::Tensor AtenXlaType::embedding_dense_backward(const at::Tensor& grad_output,
 at::Tensor AtenXlaType::empty(
     at::IntArrayRef size, const at::TensorOptions& options,
     c10::optional<at::MemoryFormat> /* memory_format */) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   // PT empty*() are optimizations to avoid initializing the data when it is
   // known it will be completely rewritten. But since for us doing a zero*()
   // does not actually end up doing any memory initialization, we use that and
@@ -1036,81 +1075,81 @@ at::Tensor AtenXlaType::empty(
 at::Tensor AtenXlaType::empty_strided(at::IntArrayRef size,
                                       at::IntArrayRef stride,
                                       const at::TensorOptions& options) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   at::Tensor t = empty(size, options, c10::nullopt);
   return as_strided(t, size, stride, /*storage_offset=*/0);
 }
 
 at::Tensor AtenXlaType::eq(const at::Tensor& self, at::Scalar other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::eq(bridge::GetXlaTensor(self), other));
 }
 
 at::Tensor AtenXlaType::eq(const at::Tensor& self, const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::eq(bridge::GetXlaTensor(self), bridge::GetXlaTensor(other)));
 }
 
 at::Tensor& AtenXlaType::eq_(at::Tensor& self, at::Scalar other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::eq_(self_tensor, other);
   return self;
 }
 
 at::Tensor& AtenXlaType::eq_(at::Tensor& self, const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::eq_(self_tensor, bridge::GetXlaTensor(other));
   return self;
 }
 
 at::Tensor AtenXlaType::erf(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::erf(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor& AtenXlaType::erf_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::erf_(self_tensor);
   return self;
 }
 
 at::Tensor AtenXlaType::erfc(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::erfc(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor& AtenXlaType::erfc_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::erfc_(self_tensor);
   return self;
 }
 
 at::Tensor AtenXlaType::erfinv(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::erfinv(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor& AtenXlaType::erfinv_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::erfinv_(self_tensor);
   return self;
 }
 
 at::Tensor AtenXlaType::exp(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::exp(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor& AtenXlaType::exp_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::exp_(self_tensor);
   return self;
@@ -1118,47 +1157,47 @@ at::Tensor& AtenXlaType::exp_(at::Tensor& self) {
 
 at::Tensor AtenXlaType::expand(const at::Tensor& self, at::IntArrayRef size,
                                bool implicit) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::expand(
       bridge::GetXlaTensor(self), xla::util::ToVector<xla::int64>(size)));
 }
 
 at::Tensor AtenXlaType::expm1(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::expm1(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor& AtenXlaType::expm1_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::expm1_(self_tensor);
   return self;
 }
 
 at::Tensor& AtenXlaType::eye_out(at::Tensor& out, int64_t n) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor out_tensor = bridge::GetXlaTensor(out);
   XLATensor::eye_out(out_tensor, n, n);
   return out;
 }
 
 at::Tensor& AtenXlaType::eye_out(at::Tensor& out, int64_t n, int64_t m) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor out_tensor = bridge::GetXlaTensor(out);
   XLATensor::eye_out(out_tensor, n, m);
   return out;
 }
 
 at::Tensor& AtenXlaType::fill_(at::Tensor& self, at::Scalar value) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::fill_(self_tensor, value);
   return self;
 }
 
 at::Tensor& AtenXlaType::fill_(at::Tensor& self, const at::Tensor& value) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLA_CHECK_EQ(value.dim(), 0) << "fill_ only supports a 0-dimensional "
                                << "value tensor, but got tensor "
                                << "with " << value.dim() << " dimension(s).";
@@ -1166,57 +1205,57 @@ at::Tensor& AtenXlaType::fill_(at::Tensor& self, const at::Tensor& value) {
 }
 
 at::Tensor AtenXlaType::flip(const at::Tensor& self, at::IntArrayRef dims) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::flip(bridge::GetXlaTensor(self), XlaHelpers::I64List(dims)));
 }
 
 at::Tensor AtenXlaType::floor(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::floor(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor& AtenXlaType::floor_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::floor_(self_tensor);
   return self;
 }
 
 at::Tensor AtenXlaType::fmod(const at::Tensor& self, const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::fmod(bridge::GetXlaTensor(self), bridge::GetXlaTensor(other)));
 }
 
 at::Tensor AtenXlaType::fmod(const at::Tensor& self, at::Scalar other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::fmod(bridge::GetXlaTensor(self), other));
 }
 
 at::Tensor& AtenXlaType::fmod_(at::Tensor& self, const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::fmod_(self_tensor, bridge::GetXlaTensor(other));
   return self;
 }
 
 at::Tensor& AtenXlaType::fmod_(at::Tensor& self, at::Scalar other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::fmod_(self_tensor, other);
   return self;
 }
 
 at::Tensor AtenXlaType::frac(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::frac(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor& AtenXlaType::frac_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::frac_(self_tensor);
   return self;
@@ -1225,77 +1264,77 @@ at::Tensor& AtenXlaType::frac_(at::Tensor& self) {
 at::Tensor AtenXlaType::gather(const at::Tensor& self, int64_t dim,
                                const at::Tensor& index,
                                bool /* sparse_grad */) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::gather(
       bridge::GetXlaTensor(self), dim, bridge::GetXlaTensor(index)));
 }
 
 at::Tensor AtenXlaType::ge(const at::Tensor& self, at::Scalar other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::ge(bridge::GetXlaTensor(self), other));
 }
 
 at::Tensor AtenXlaType::ge(const at::Tensor& self, const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::ge(bridge::GetXlaTensor(self), bridge::GetXlaTensor(other)));
 }
 
 at::Tensor& AtenXlaType::ge_(at::Tensor& self, at::Scalar other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::ge_(self_tensor, other);
   return self;
 }
 
 at::Tensor& AtenXlaType::ge_(at::Tensor& self, const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::ge_(self_tensor, bridge::GetXlaTensor(other));
   return self;
 }
 
 at::Tensor AtenXlaType::gelu(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::gelu(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor AtenXlaType::gelu_backward(const at::Tensor& grad,
                                       const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::gelu_backward(
       bridge::GetXlaTensor(grad), bridge::GetXlaTensor(self)));
 }
 
 at::Tensor AtenXlaType::gt(const at::Tensor& self, at::Scalar other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::gt(bridge::GetXlaTensor(self), other));
 }
 
 at::Tensor AtenXlaType::gt(const at::Tensor& self, const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::gt(bridge::GetXlaTensor(self), bridge::GetXlaTensor(other)));
 }
 
 at::Tensor& AtenXlaType::gt_(at::Tensor& self, at::Scalar other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::gt_(self_tensor, other);
   return self;
 }
 
 at::Tensor& AtenXlaType::gt_(at::Tensor& self, const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::gt_(self_tensor, bridge::GetXlaTensor(other));
   return self;
 }
 
 at::Tensor AtenXlaType::hardshrink(const at::Tensor& self, at::Scalar lambda) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::hardshrink(bridge::GetXlaTensor(self), lambda));
 }
@@ -1303,21 +1342,21 @@ at::Tensor AtenXlaType::hardshrink(const at::Tensor& self, at::Scalar lambda) {
 at::Tensor AtenXlaType::hardshrink_backward(const at::Tensor& grad_out,
                                             const at::Tensor& self,
                                             at::Scalar lambda) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::hardshrink_backward(
       bridge::GetXlaTensor(grad_out), bridge::GetXlaTensor(self), lambda));
 }
 
 at::Tensor AtenXlaType::hardtanh(const at::Tensor& self, at::Scalar min_val,
                                  at::Scalar max_val) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::clamp(bridge::GetXlaTensor(self), min_val, max_val));
 }
 
 at::Tensor& AtenXlaType::hardtanh_(at::Tensor& self, at::Scalar min_val,
                                    at::Scalar max_val) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::clamp_(self_tensor, min_val, max_val);
   return self;
@@ -1327,14 +1366,14 @@ at::Tensor AtenXlaType::hardtanh_backward(const at::Tensor& grad_output,
                                           const at::Tensor& self,
                                           at::Scalar min_val,
                                           at::Scalar max_val) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::hardtanh_backward(
       bridge::GetXlaTensor(grad_output), bridge::GetXlaTensor(self), min_val,
       max_val));
 }
 
 at::Tensor AtenXlaType::index(const at::Tensor& self, at::TensorList indices) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   CanonicalIndexInfo canonical_index_info =
       GetCanonicalIndexInfo(self, indices);
   return bridge::AtenFromXlaTensor(
@@ -1346,7 +1385,7 @@ at::Tensor AtenXlaType::index(const at::Tensor& self, at::TensorList indices) {
 at::Tensor& AtenXlaType::index_add_(at::Tensor& self, int64_t dim,
                                     const at::Tensor& index,
                                     const at::Tensor& source) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::index_add_(self_tensor, dim, bridge::GetXlaTensor(index),
                         bridge::GetXlaTensor(source));
@@ -1356,7 +1395,7 @@ at::Tensor& AtenXlaType::index_add_(at::Tensor& self, int64_t dim,
 at::Tensor& AtenXlaType::index_copy_(at::Tensor& self, int64_t dim,
                                      const at::Tensor& index,
                                      const at::Tensor& source) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::index_copy_(self_tensor, dim, bridge::GetXlaTensor(index),
                          bridge::GetXlaTensor(source));
@@ -1366,7 +1405,7 @@ at::Tensor& AtenXlaType::index_copy_(at::Tensor& self, int64_t dim,
 at::Tensor& AtenXlaType::index_fill_(at::Tensor& self, int64_t dim,
                                      const at::Tensor& index,
                                      at::Scalar value) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::index_fill_(self_tensor, dim, bridge::GetXlaTensor(index), value);
   return self;
@@ -1375,7 +1414,7 @@ at::Tensor& AtenXlaType::index_fill_(at::Tensor& self, int64_t dim,
 at::Tensor& AtenXlaType::index_fill_(at::Tensor& self, int64_t dim,
                                      const at::Tensor& index,
                                      const at::Tensor& value) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::index_fill_(self_tensor, dim, bridge::GetXlaTensor(index),
                          bridge::GetXlaTensor(value));
@@ -1384,7 +1423,34 @@ at::Tensor& AtenXlaType::index_fill_(at::Tensor& self, int64_t dim,
 
 at::Tensor& AtenXlaType::index_put_(at::Tensor& self, at::TensorList indices,
                                     const at::Tensor& values, bool accumulate) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
+  if (indices.size() == 1 && indices[0].defined() &&
+      (indices[0].scalar_type() == at::kBool ||
+       indices[0].scalar_type() == at::kByte)) {
+    // Boolean mask updates do not need the mask to be expanded into indices,
+    // which would have a data dependent shape.
+    XLATensor self_tensor = bridge::GetXlaTensor(self);
+    XLATensor mask_tensor =
+        bridge::GetOrCreateXlaTensor(indices[0], self_tensor.GetDevice());
+    int64_t trailing_rank = self.dim() - indices[0].dim();
+    if (values.dim() > trailing_rank &&
+        (values.dim() != trailing_rank + 1 || values.size(0) != 1) &&
+        values.numel() < self.numel()) {
+      // The values hold one row per selected position.
+      std::vector<xla::int64> mask_dims =
+          XlaHelpers::I64List(indices[0].sizes());
+      mask_dims.resize(self.dim(), 1);
+      CheckMaskedSourceSize(
+          XLATensor::expand(XLATensor::view(mask_tensor, mask_dims),
+                            XlaHelpers::I64List(self.sizes())),
+          values.numel());
+    }
+    XLATensor::index_put_(
+        self_tensor, mask_tensor,
+        bridge::GetOrCreateXlaTensor(values, self_tensor.GetDevice()),
+        accumulate);
+    return self;
+  }
   CanonicalIndexInfo canonical_index_info =
       GetCanonicalIndexInfo(self, indices);
   XLATensor self_tensor = bridge::GetXlaTensor(self);
@@ -1398,14 +1464,14 @@ at::Tensor& AtenXlaType::index_put_(at::Tensor& self, at::TensorList indices,
 
 at::Tensor AtenXlaType::index_select(const at::Tensor& self, int64_t dim,
                                      const at::Tensor& index) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::index_select(
       bridge::GetXlaTensor(self), dim, bridge::GetXlaTensor(index)));
 }
 
 at::Tensor AtenXlaType::kl_div(const at::Tensor& self, const at::Tensor& target,
                                int64_t reduction) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return at::native::kl_div(self, target, reduction);
 }
 
@@ -1413,7 +1479,7 @@ at::Tensor AtenXlaType::kl_div_backward(const at::Tensor& grad_output,
                                         const at::Tensor& self,
                                         const at::Tensor& target,
                                         int64_t reduction) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::kl_div_backward(
       bridge::GetXlaTensor(grad_output), bridge::GetXlaTensor(self),
       bridge::GetXlaTensor(target), reduction));
@@ -1422,7 +1488,7 @@ at::Tensor AtenXlaType::kl_div_backward(const at::Tensor& grad_output,
 std::tuple<at::Tensor, at::Tensor> AtenXlaType::kthvalue(const at::Tensor& self,
                                                          int64_t k, int64_t dim,
                                                          bool keepdim) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   auto results =
       XLATensor::kthvalue(bridge::GetXlaTensor(self), k, dim, keepdim);
   return std::make_tuple(bridge::AtenFromXlaTensor(std::get<0>(results)),
@@ -1431,7 +1497,7 @@ std::tuple<at::Tensor, at::Tensor> AtenXlaType::kthvalue(const at::Tensor& self,
 
 at::Tensor AtenXlaType::l1_loss(const at::Tensor& self,
                                 const at::Tensor& target, int64_t reduction) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::l1_loss(
       bridge::GetXlaTensor(self), bridge::GetXlaTensor(target), reduction));
 }
@@ -1440,33 +1506,33 @@ at::Tensor AtenXlaType::l1_loss_backward(const at::Tensor& grad_output,
                                          const at::Tensor& self,
                                          const at::Tensor& target,
                                          int64_t reduction) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::l1_loss_backward(
       bridge::GetXlaTensor(grad_output), bridge::GetXlaTensor(self),
       bridge::GetXlaTensor(target), reduction));
 }
 
 at::Tensor AtenXlaType::le(const at::Tensor& self, at::Scalar other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::le(bridge::GetXlaTensor(self), other));
 }
 
 at::Tensor AtenXlaType::le(const at::Tensor& self, const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::le(bridge::GetXlaTensor(self), bridge::GetXlaTensor(other)));
 }
 
 at::Tensor& AtenXlaType::le_(at::Tensor& self, at::Scalar other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::le_(self_tensor, other);
   return self;
 }
 
 at::Tensor& AtenXlaType::le_(at::Tensor& self, const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::le_(self_tensor, bridge::GetXlaTensor(other));
   return self;
@@ -1474,14 +1540,14 @@ at::Tensor& AtenXlaType::le_(at::Tensor& self, const at::Tensor& other) {
 
 at::Tensor AtenXlaType::leaky_relu(const at::Tensor& self,
                                    at::Scalar negative_slope) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::leaky_relu(
       bridge::GetXlaTensor(self), negative_slope.to<double>()));
 }
 
 at::Tensor& AtenXlaType::leaky_relu_(at::Tensor& self,
                                      at::Scalar negative_slope) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::leaky_relu_(self_tensor, negative_slope.to<double>());
   return self;
@@ -1490,58 +1556,58 @@ at::Tensor& AtenXlaType::leaky_relu_(at::Tensor& self,
 at::Tensor AtenXlaType::leaky_relu_backward(const at::Tensor& grad_output,
                                             const at::Tensor& self,
                                             at::Scalar negative_slope) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::leaky_relu_backward(
       bridge::GetXlaTensor(grad_output), bridge::GetXlaTensor(self),
       negative_slope.to<double>()));
 }
 
 at::Tensor AtenXlaType::log(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::log(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor AtenXlaType::log10(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::log_base(
       bridge::GetXlaTensor(self), ir::OpKind(at::aten::log10), 10.0));
 }
 
 at::Tensor& AtenXlaType::log10_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::log_base_(self_tensor, ir::OpKind(at::aten::log10), 10.0);
   return self;
 }
 
 at::Tensor AtenXlaType::log1p(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::log1p(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor& AtenXlaType::log1p_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::log1p_(self_tensor);
   return self;
 }
 
 at::Tensor AtenXlaType::log2(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::log_base(
       bridge::GetXlaTensor(self), ir::OpKind(at::aten::log2), 2.0));
 }
 
 at::Tensor& AtenXlaType::log2_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::log_base_(self_tensor, ir::OpKind(at::aten::log2), 2.0);
   return self;
 }
 
 at::Tensor& AtenXlaType::log_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::log_(self_tensor);
   return self;
@@ -1550,7 +1616,7 @@ at::Tensor& AtenXlaType::log_(at::Tensor& self) {
 at::Tensor AtenXlaType::log_sigmoid_backward(const at::Tensor& grad_output,
                                              const at::Tensor& self,
                                              const at::Tensor& buffer) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::log_sigmoid_backward(
       bridge::GetXlaTensor(grad_output), bridge::GetXlaTensor(self),
       bridge::GetXlaTensor(buffer)));
@@ -1558,7 +1624,7 @@ at::Tensor AtenXlaType::log_sigmoid_backward(const at::Tensor& grad_output,
 
 std::tuple<at::Tensor, at::Tensor> AtenXlaType::log_sigmoid_forward(
     const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   auto result_tuple =
       XLATensor::log_sigmoid_forward(bridge::GetXlaTensor(self));
   return std::make_tuple(bridge::AtenFromXlaTensor(std::get<0>(result_tuple)),
@@ -1566,32 +1632,32 @@ std::tuple<at::Tensor, at::Tensor> AtenXlaType::log_sigmoid_forward(
 }
 
 at::Tensor AtenXlaType::logdet(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::logdet(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor AtenXlaType::lt(const at::Tensor& self, at::Scalar other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::lt(bridge::GetXlaTensor(self), other));
 }
 
 at::Tensor AtenXlaType::lt(const at::Tensor& self, const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::lt(bridge::GetXlaTensor(self), bridge::GetXlaTensor(other)));
 }
 
 at::Tensor& AtenXlaType::lt_(at::Tensor& self, at::Scalar other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::lt_(self_tensor, other);
   return self;
 }
 
 at::Tensor& AtenXlaType::lt_(at::Tensor& self, const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::lt_(self_tensor, bridge::GetXlaTensor(other));
   return self;
@@ -1599,7 +1665,7 @@ at::Tensor& AtenXlaType::lt_(at::Tensor& self, const at::Tensor& other) {
 
 at::Tensor& AtenXlaType::masked_fill_(at::Tensor& self, const at::Tensor& mask,
                                       at::Scalar value) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::masked_fill_(self_tensor, bridge::GetXlaTensor(mask), value);
   return self;
@@ -1607,42 +1673,54 @@ at::Tensor& AtenXlaType::masked_fill_(at::Tensor& self, const at::Tensor& mask,
 
 at::Tensor& AtenXlaType::masked_fill_(at::Tensor& self, const at::Tensor& mask,
                                       const at::Tensor& value) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLA_CHECK_EQ(value.dim(), 0) << "masked_fill_ only supports a 0-dimensional "
                                << "value tensor, but got tensor "
                                << "with " << value.dim() << " dimension(s).";
   return masked_fill_(self, mask, value.item());
 }
 
+at::Tensor& AtenXlaType::masked_scatter_(at::Tensor& self,
+                                         const at::Tensor& mask,
+                                         const at::Tensor& source) {
+  XLA_FN_PROFILE("xla::");
+  XLATensor self_tensor = bridge::GetXlaTensor(self);
+  XLATensor mask_tensor = bridge::GetXlaTensor(mask);
+  if (source.numel() < self.numel()) {
+    CheckMaskedSourceSize(
+        XLATensor::expand(mask_tensor, XlaHelpers::I64List(self.sizes())),
+        source.numel());
+  }
+  XLATensor::masked_scatter_(self_tensor, mask_tensor,
+                             bridge::GetXlaTensor(source));
+  return self;
+}
+
 at::Tensor AtenXlaType::masked_select(const at::Tensor& self,
                                       const at::Tensor& mask) {
-  XLA_FN_COUNTER("xla::");
-  XLATensor self_tensor = bridge::GetXlaTensor(self);
-  // Initially make XLA handled masked_select() handling experimental, and
-  // opt-in. Only the XLA TPU backend for now implements the dynamic dimension
-  // setting required by the masked_select implementation.
-  if (!DebugUtil::ExperimentEnabled("masked_select") ||
-      self_tensor.GetDevice().hw_type != DeviceType::TPU) {
-    return AtenXlaTypeDefault::masked_select(self, mask);
-  }
+  XLA_FN_PROFILE("xla::");
+  XLATensor self_tensor = bridge::GetXlaTensor(self);
+  bool dynamic = UseDynamicShape(self_tensor, "masked_select");
+  auto result = XLATensor::masked_select(
+      self_tensor, bridge::GetXlaTensor(mask), dynamic);
   return bridge::AtenFromXlaTensor(
-      XLATensor::masked_select(self_tensor, bridge::GetXlaTensor(mask)));
+      dynamic ? std::get<0>(result) : GetValidPaddedResult(result));
 }
 
 at::Tensor AtenXlaType::max(const at::Tensor& self, const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::max(bridge::GetXlaTensor(self), bridge::GetXlaTensor(other)));
 }
 
 at::Tensor AtenXlaType::max(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::max(bridge::GetXlaTensor(self)));
 }
 
 std::tuple<at::Tensor, at::Tensor> AtenXlaType::max(const at::Tensor& self,
                                                     int64_t dim, bool keepdim) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   auto outputs = XLATensor::max(bridge::GetXlaTensor(self), dim, keepdim);
   return std::make_tuple(bridge::AtenFromXlaTensor(std::get<0>(outputs)),
                          bridge::AtenFromXlaTensor(std::get<1>(outputs)));
@@ -1651,7 +1729,7 @@ std::tuple<at::Tensor, at::Tensor> AtenXlaType::max(const at::Tensor& self,
 std::tuple<at::Tensor&, at::Tensor&> AtenXlaType::max_out(
     at::Tensor& max, at::Tensor& max_values, const at::Tensor& self,
     int64_t dim, bool keepdim) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor max_tensor = bridge::GetXlaTensor(max);
   XLATensor max_values_tensor = bridge::GetXlaTensor(max_values);
   XLATensor::max_out(max_tensor, max_values_tensor, bridge::GetXlaTensor(self),
@@ -1662,7 +1740,7 @@ std::tuple<at::Tensor&, at::Tensor&> AtenXlaType::max_out(
 std::tuple<at::Tensor, at::Tensor> AtenXlaType::max_pool2d_with_indices(
     const at::Tensor& self, at::IntArrayRef kernel_size, at::IntArrayRef stride,
     at::IntArrayRef padding, at::IntArrayRef dilation, bool ceil_mode) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   // Lowering when ceil_mode or dilation is set not supported yet.
   if (IsNonTrivialDilation(dilation)) {
     return AtenXlaTypeDefault::max_pool2d_with_indices(
@@ -1692,7 +1770,7 @@ at::Tensor AtenXlaType::max_pool2d_with_indices_backward(
     at::IntArrayRef kernel_size, at::IntArrayRef stride,
     at::IntArrayRef padding, at::IntArrayRef dilation, bool ceil_mode,
     const at::Tensor& indices) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   // Lowering when ceil_mode or dilation is set not supported yet.
   if (IsNonTrivialDilation(dilation)) {
     return AtenXlaTypeDefault::max_pool2d_with_indices_backward(
@@ -1710,7 +1788,7 @@ at::Tensor AtenXlaType::max_pool3d_with_indices_backward(
     at::IntArrayRef kernel_size, at::IntArrayRef stride,
     at::IntArrayRef padding, at::IntArrayRef dilation, bool ceil_mode,
     const at::Tensor& indices) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   // Lowering when ceil_mode or dilation is set not supported yet.
   if (IsNonTrivialDilation(dilation)) {
     return AtenXlaTypeDefault::max_pool3d_with_indices_backward(
@@ -1726,7 +1804,7 @@ at::Tensor AtenXlaType::max_pool3d_with_indices_backward(
 std::tuple<at::Tensor, at::Tensor> AtenXlaType::max_pool3d_with_indices(
     const at::Tensor& self, at::IntArrayRef kernel_size, at::IntArrayRef stride,
     at::IntArrayRef padding, at::IntArrayRef dilation, bool ceil_mode) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   // Lowering when ceil_mode or dilation is set not supported yet.
   if (IsNonTrivialDilation(dilation)) {
     return AtenXlaTypeDefault::max_pool3d_with_indices(
@@ -1753,7 +1831,7 @@ std::tuple<at::Tensor, at::Tensor> AtenXlaType::max_pool3d_with_indices(
 
 at::Tensor AtenXlaType::mean(const at::Tensor& self,
                              c10::optional<at::ScalarType> dtype) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   return bridge::AtenFromXlaTensor(XLATensor::mean(
       self_tensor,
@@ -1764,26 +1842,26 @@ at::Tensor AtenXlaType::mean(const at::Tensor& self,
 at::Tensor AtenXlaType::mean(const at::Tensor& self, at::IntArrayRef dim,
                              bool keepdim,
                              c10::optional<at::ScalarType> dtype) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::mean(
       bridge::GetXlaTensor(self), xla::util::ToVector<xla::int64>(dim),
       /*keep_reduced_dimensions*/ keepdim, dtype));
 }
 
 at::Tensor AtenXlaType::min(const at::Tensor& self, const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::min(bridge::GetXlaTensor(self), bridge::GetXlaTensor(other)));
 }
 
 at::Tensor AtenXlaType::min(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::min(bridge::GetXlaTensor(self)));
 }
 
 std::tuple<at::Tensor, at::Tensor> AtenXlaType::min(const at::Tensor& self,
                                                     int64_t dim, bool keepdim) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   auto outputs = XLATensor::min(bridge::GetXlaTensor(self), dim, keepdim);
   return std::make_tuple(bridge::AtenFromXlaTensor(std::get<0>(outputs)),
                          bridge::AtenFromXlaTensor(std::get<1>(outputs)));
@@ -1792,7 +1870,7 @@ std::tuple<at::Tensor, at::Tensor> AtenXlaType::min(const at::Tensor& self,
 std::tuple<at::Tensor&, at::Tensor&> AtenXlaType::min_out(
     at::Tensor& min, at::Tensor& min_indices, const at::Tensor& self,
     int64_t dim, bool keepdim) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor min_tensor = bridge::GetXlaTensor(min);
   XLATensor min_indices_tensor = bridge::GetXlaTensor(min_indices);
   XLATensor::min_out(min_tensor, min_indices_tensor, bridge::GetXlaTensor(self),
@@ -1801,7 +1879,7 @@ std::tuple<at::Tensor&, at::Tensor&> AtenXlaType::min_out(
 }
 
 at::Tensor AtenXlaType::mm(const at::Tensor& self, const at::Tensor& mat2) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   // xla::dot doesn't support integer types.
   if (!at::native::is_floating_point(self) ||
       !at::native::is_floating_point(mat2)) {
@@ -1814,7 +1892,7 @@ at::Tensor AtenXlaType::mm(const at::Tensor& self, const at::Tensor& mat2) {
 
 at::Tensor AtenXlaType::mse_loss(const at::Tensor& self,
                                  const at::Tensor& target, int64_t reduction) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::mse_loss(
       bridge::GetXlaTensor(self), bridge::GetXlaTensor(target), reduction));
 }
@@ -1823,27 +1901,27 @@ at::Tensor AtenXlaType::mse_loss_backward(const at::Tensor& grad_output,
                                           const at::Tensor& self,
                                           const at::Tensor& target,
                                           int64_t reduction) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::mse_loss_backward(
       bridge::GetXlaTensor(grad_output), bridge::GetXlaTensor(self),
       bridge::GetXlaTensor(target), reduction));
 }
 
 at::Tensor AtenXlaType::mul(const at::Tensor& self, const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   auto xlatensors = GetPromotedXlaTensorsForBinaryOp(self, other);
   return bridge::AtenFromXlaTensor(
       XLATensor::mul(std::get<0>(xlatensors), std::get<1>(xlatensors)));
 }
 
 at::Tensor AtenXlaType::mul(const at::Tensor& self, at::Scalar other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::mul(bridge::GetXlaTensor(self), other));
 }
 
 at::Tensor& AtenXlaType::mul_(at::Tensor& self, const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::mul_(self_tensor,
                   bridge::GetOrCreateXlaTensor(other, self_tensor.GetDevice()));
@@ -1851,14 +1929,14 @@ at::Tensor& AtenXlaType::mul_(at::Tensor& self, const at::Tensor& other) {
 }
 
 at::Tensor& AtenXlaType::mul_(at::Tensor& self, at::Scalar other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::mul_(self_tensor, other);
   return self;
 }
 
 at::Tensor AtenXlaType::mv(const at::Tensor& self, const at::Tensor& vec) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   // xla::dot doesn't support integer types.
   if (!at::native::is_floating_point(self) ||
       !at::native::is_floating_point(vec)) {
@@ -1870,7 +1948,7 @@ at::Tensor AtenXlaType::mv(const at::Tensor& self, const at::Tensor& vec) {
 
 at::Tensor& AtenXlaType::mv_out(at::Tensor& out, const at::Tensor& self,
                                 const at::Tensor& vec) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   // xla::dot doesn't support integer types.
   if (!at::native::is_floating_point(self) ||
       !at::native::is_floating_point(vec)) {
@@ -1884,7 +1962,7 @@ at::Tensor& AtenXlaType::mv_out(at::Tensor& out, const at::Tensor& self,
 
 at::Tensor AtenXlaType::narrow_copy(const at::Tensor& self, int64_t dim,
                                     int64_t start, int64_t length) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return at::native::narrow_copy_dense(self, dim, start, length);
 }
 
@@ -1892,7 +1970,7 @@ std::tuple<at::Tensor, at::Tensor, at::Tensor> AtenXlaType::native_batch_norm(
     const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias,
     const at::Tensor& running_mean, const at::Tensor& running_var,
     bool training, double momentum, double eps) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor input_tensor = bridge::GetXlaTensor(input);
   const Device& device = input_tensor.GetDevice();
   XLATensor running_mean_tensor =
@@ -1915,7 +1993,7 @@ AtenXlaType::native_batch_norm_backward(
     const at::Tensor& running_var, const at::Tensor& save_mean,
     const at::Tensor& save_invstd, bool train, double eps,
     std::array<bool, 3> output_mask) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor grad_out_tensor = bridge::GetXlaTensor(grad_out);
   const Device& device = grad_out_tensor.GetDevice();
   auto gradients = XLATensor::native_batch_norm_backward(
@@ -1936,7 +2014,7 @@ AtenXlaType::native_batch_norm_backward(
 std::tuple<at::Tensor, at::Tensor, at::Tensor> AtenXlaType::native_layer_norm(
     const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias,
     int64_t M, int64_t N, double eps) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   auto input_shape = input.sizes();
   at::Tensor input_reshaped = input.view({1, M, -1});
   // Unlike Batch Normalization, which applies scalar scale and bias for each
@@ -1963,7 +2041,7 @@ AtenXlaType::native_layer_norm_backward(
     const at::Tensor& grad_out, const at::Tensor& input, const at::Tensor& mean,
     const at::Tensor& rstd, const at::Tensor& weight, int64_t M, int64_t N,
     std::array<bool, 3> output_mask) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   at::Tensor grad_input = grad_out;
   if (weight.defined()) {
     grad_input = grad_input.mul(weight);
@@ -1985,33 +2063,33 @@ AtenXlaType::native_layer_norm_backward(
 }
 
 at::Tensor AtenXlaType::ne(const at::Tensor& self, at::Scalar other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::ne(bridge::GetXlaTensor(self), other));
 }
 
 at::Tensor AtenXlaType::ne(const at::Tensor& self, const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::ne(bridge::GetXlaTensor(self), bridge::GetXlaTensor(other)));
 }
 
 at::Tensor& AtenXlaType::ne_(at::Tensor& self, at::Scalar other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::ne_(self_tensor, other);
   return self;
 }
 
 at::Tensor& AtenXlaType::ne_(at::Tensor& self, const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::ne_(self_tensor, bridge::GetXlaTensor(other));
   return self;
 }
 
 at::Tensor AtenXlaType::neg(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLA_CHECK(self.scalar_type() != at::kBool)
       << "Negation, the `-` operator, on a bool tensor is not supported. If "
          "you are trying to invert a mask, use the `~` or `logical_not()` "
@@ -2020,7 +2098,7 @@ at::Tensor AtenXlaType::neg(const at::Tensor& self) {
 }
 
 at::Tensor& AtenXlaType::neg_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::neg_(self_tensor);
   return self;
@@ -2030,7 +2108,7 @@ at::Tensor AtenXlaType::nll_loss_backward(
     const at::Tensor& grad_output, const at::Tensor& self,
     const at::Tensor& target, const at::Tensor& weight, int64_t reduction,
     int64_t ignore_index, const at::Tensor& total_weight) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor weight_tensor =
       bridge::GetOrCreateXlaTensor(weight, self_tensor.GetDevice());
@@ -2048,7 +2126,7 @@ at::Tensor AtenXlaType::nll_loss_backward(
 std::tuple<at::Tensor, at::Tensor> AtenXlaType::nll_loss_forward(
     const at::Tensor& self, const at::Tensor& target, const at::Tensor& weight,
     int64_t reduction, int64_t ignore_index) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   at::Tensor total_weight = at::ones({}, at::TensorOptions(self.dtype()));
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   return std::make_tuple(
@@ -2060,22 +2138,18 @@ std::tuple<at::Tensor, at::Tensor> AtenXlaType::nll_loss_forward(
 }
 
 at::Tensor AtenXlaType::nonzero(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
-  XLATensor self_tensor = bridge::GetXlaTensor(self);
-  // Initially make XLA handled nonzero() handling experimental, and opt-in.
-  // Only the XLA TPU backend for now implements the dynamic dimension setting
-  // required by the nonzero implementation.
-  if (!DebugUtil::ExperimentEnabled("nonzero") ||
-      self_tensor.GetDevice().hw_type != DeviceType::TPU) {
-    return AtenXlaTypeDefault::nonzero(self);
-  }
-  return bridge::AtenFromXlaTensor(XLATensor::nonzero(self_tensor));
+  XLA_FN_PROFILE("xla::");
+  XLATensor self_tensor = bridge::GetXlaTensor(self);
+  bool dynamic = UseDynamicShape(self_tensor, "nonzero");
+  auto result = XLATensor::nonzero(self_tensor, dynamic);
+  return bridge::AtenFromXlaTensor(
+      dynamic ? std::get<0>(result) : GetValidPaddedResult(result));
 }
 
 at::Tensor AtenXlaType::norm(const at::Tensor& self,
                              c10::optional<at::Scalar> p,
                              at::ScalarType dtype) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   // If p==0 it is a torch.nonzero(), which is not lowered to XLA due to dynamic
   // shapes issue.
   if (p.has_value() && p->toDouble() == 0) {
@@ -2086,7 +2160,7 @@ at::Tensor AtenXlaType::norm(const at::Tensor& self,
 }
 
 at::Tensor AtenXlaType::norm(const at::Tensor& self, at::Scalar p) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   // If p==0 it is a torch.nonzero(), which is not lowered to XLA due to dynamic
   // shapes issue.
   if (p.toDouble() == 0) {
@@ -2099,7 +2173,7 @@ at::Tensor AtenXlaType::norm(const at::Tensor& self, at::Scalar p) {
 at::Tensor AtenXlaType::norm(const at::Tensor& self,
                              c10::optional<at::Scalar> p, at::IntArrayRef dim,
                              bool keepdim, at::ScalarType dtype) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   // If p==0 it is a torch.nonzero(), which is not lowered to XLA due to dynamic
   // shapes issue.
   if (p.has_value() && p->toDouble() == 0) {
@@ -2112,7 +2186,7 @@ at::Tensor AtenXlaType::norm(const at::Tensor& self,
 at::Tensor AtenXlaType::norm(const at::Tensor& self,
                              c10::optional<at::Scalar> p, at::IntArrayRef dim,
                              bool keepdim) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   // If p==0 it is a torch.nonzero(), which is not lowered to XLA due to dynamic
   // shapes issue.
   if (p.has_value() && p->toDouble() == 0) {
@@ -2123,13 +2197,13 @@ at::Tensor AtenXlaType::norm(const at::Tensor& self,
 }
 
 at::Tensor AtenXlaType::permute(const at::Tensor& self, at::IntArrayRef dims) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::permute(
       bridge::GetXlaTensor(self), XlaHelpers::I64List(dims)));
 }
 
 at::Tensor AtenXlaType::pow(const at::Tensor& self, at::Scalar exponent) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   // xla::Pow() doesn't support integer types.
   if (!at::native::is_floating_point(self)) {
     return AtenXlaTypeDefault::pow(self, exponent);
@@ -2140,7 +2214,7 @@ at::Tensor AtenXlaType::pow(const at::Tensor& self, at::Scalar exponent) {
 
 at::Tensor AtenXlaType::pow(const at::Tensor& self,
                             const at::Tensor& exponent) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   // xla::Pow() doesn't support integer types.
   if (!at::native::is_floating_point(self)) {
     return AtenXlaTypeDefault::pow(self, exponent);
@@ -2150,7 +2224,7 @@ at::Tensor AtenXlaType::pow(const at::Tensor& self,
 }
 
 at::Tensor AtenXlaType::pow(at::Scalar self, const at::Tensor& exponent) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   // xla::Pow() doesn't support integer types.
   if (!self.isFloatingPoint()) {
     return AtenXlaTypeDefault::pow(self, exponent);
@@ -2160,7 +2234,7 @@ at::Tensor AtenXlaType::pow(at::Scalar self, const at::Tensor& exponent) {
 }
 
 at::Tensor& AtenXlaType::pow_(at::Tensor& self, at::Scalar exponent) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   // xla::Pow() doesn't support integer types.
   if (!at::native::is_floating_point(self)) {
     return AtenXlaTypeDefault::pow_(self, exponent);
@@ -2171,7 +2245,7 @@ at::Tensor& AtenXlaType::pow_(at::Tensor& self, at::Scalar exponent) {
 }
 
 at::Tensor& AtenXlaType::pow_(at::Tensor& self, const at::Tensor& exponent) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   // xla::Pow() doesn't support integer types.
   if (!at::native::is_floating_point(self)) {
     return AtenXlaTypeDefault::pow_(self, exponent);
@@ -2183,7 +2257,7 @@ at::Tensor& AtenXlaType::pow_(at::Tensor& self, const at::Tensor& exponent) {
 
 at::Tensor AtenXlaType::prod(const at::Tensor& self,
                              c10::optional<at::ScalarType> dtype) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   return bridge::AtenFromXlaTensor(XLATensor::prod(
       self_tensor,
@@ -2193,7 +2267,7 @@ at::Tensor AtenXlaType::prod(const at::Tensor& self,
 
 at::Tensor AtenXlaType::prod(const at::Tensor& self, int64_t dim, bool keepdim,
                              c10::optional<at::ScalarType> dtype) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::prod(bridge::GetXlaTensor(self), {dim}, keepdim, dtype));
 }
@@ -2208,7 +2282,7 @@ at::Tensor& AtenXlaType::put_(at::Tensor& self, const at::Tensor& index,
 
 std::tuple<at::Tensor, at::Tensor> AtenXlaType::qr(const at::Tensor& self,
                                                    bool some) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   auto results = XLATensor::qr(bridge::GetXlaTensor(self), some);
   return std::make_tuple(bridge::AtenFromXlaTensor(std::get<0>(results)),
                          bridge::AtenFromXlaTensor(std::get<1>(results)));
@@ -2216,7 +2290,7 @@ std::tuple<at::Tensor, at::Tensor> AtenXlaType::qr(const at::Tensor& self,
 
 at::Tensor& AtenXlaType::randperm_out(at::Tensor& out, int64_t n,
                                       at::Generator* generator) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   if (generator != nullptr) {
     return AtenXlaTypeDefault::randperm_out(out, n, generator);
   }
@@ -2226,13 +2300,13 @@ at::Tensor& AtenXlaType::randperm_out(at::Tensor& out, int64_t n,
 }
 
 at::Tensor AtenXlaType::reciprocal(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::reciprocal(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor& AtenXlaType::reciprocal_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::reciprocal_(self_tensor);
   return self;
@@ -2240,7 +2314,7 @@ at::Tensor& AtenXlaType::reciprocal_(at::Tensor& self) {
 
 at::Tensor AtenXlaType::reflection_pad2d(const at::Tensor& self,
                                          at::IntArrayRef padding) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::reflection_pad2d(
       bridge::GetXlaTensor(self), xla::util::ToVector<xla::int64>(padding)));
 }
@@ -2248,19 +2322,19 @@ at::Tensor AtenXlaType::reflection_pad2d(const at::Tensor& self,
 at::Tensor AtenXlaType::reflection_pad2d_backward(const at::Tensor& grad_output,
                                                   const at::Tensor& self,
                                                   at::IntArrayRef padding) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::reflection_pad2d_backward(
       bridge::GetXlaTensor(grad_output), bridge::GetXlaTensor(self),
       xla::util::ToVector<xla::int64>(padding)));
 }
 
 at::Tensor AtenXlaType::relu(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::relu(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor& AtenXlaType::relu_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::relu_(self_tensor);
   return self;
@@ -2268,26 +2342,26 @@ at::Tensor& AtenXlaType::relu_(at::Tensor& self) {
 
 at::Tensor AtenXlaType::remainder(const at::Tensor& self,
                                   const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::remainder(
       bridge::GetXlaTensor(self), bridge::GetXlaTensor(other)));
 }
 
 at::Tensor AtenXlaType::remainder(const at::Tensor& self, at::Scalar other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::remainder(bridge::GetXlaTensor(self), other));
 }
 
 at::Tensor& AtenXlaType::remainder_(at::Tensor& self, const at::Tensor& other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::remainder_(self_tensor, bridge::GetXlaTensor(other));
   return self;
 }
 
 at::Tensor& AtenXlaType::remainder_(at::Tensor& self, at::Scalar other) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::remainder_(self_tensor, other);
   return self;
@@ -2295,7 +2369,7 @@ at::Tensor& AtenXlaType::remainder_(at::Tensor& self, at::Scalar other) {
 
 at::Tensor AtenXlaType::repeat(const at::Tensor& self,
                                at::IntArrayRef repeats) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::repeat(
       bridge::GetXlaTensor(self), XlaHelpers::I64List(repeats)));
 }
@@ -2303,7 +2377,7 @@ at::Tensor AtenXlaType::repeat(const at::Tensor& self,
 at::Tensor& AtenXlaType::resize_(
     at::Tensor& self, at::IntArrayRef size,
     c10::optional<at::MemoryFormat> /* memory_format */) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::resize_(self_tensor, XlaHelpers::I64List(size));
   return self;
@@ -2314,7 +2388,7 @@ at::Tensor AtenXlaType::rrelu_with_noise(const at::Tensor& self,
                                          at::Scalar lower, at::Scalar upper,
                                          bool training,
                                          at::Generator* generator) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   if (generator != nullptr) {
     // The fallback path for rrelu_with_noise when training=true is wrong
     XLA_CHECK_EQ(training, false);
@@ -2332,7 +2406,7 @@ at::Tensor AtenXlaType::rrelu_with_noise_backward(const at::Tensor& grad_output,
                                                   at::Scalar lower,
                                                   at::Scalar upper,
                                                   bool training) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor noise_tensor = bridge::GetXlaTensor(noise);
   return bridge::AtenFromXlaTensor(XLATensor::rrelu_with_noise_backward(
       bridge::GetXlaTensor(grad_output), bridge::GetXlaTensor(self),
@@ -2340,13 +2414,13 @@ at::Tensor AtenXlaType::rrelu_with_noise_backward(const at::Tensor& grad_output,
 }
 
 at::Tensor AtenXlaType::rsqrt(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::rsqrt(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor& AtenXlaType::rsqrt_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::rsqrt_(self_tensor);
   return self;
@@ -2354,7 +2428,7 @@ at::Tensor& AtenXlaType::rsqrt_(at::Tensor& self) {
 
 at::Tensor AtenXlaType::rsub(const at::Tensor& self, const at::Tensor& other,
                              at::Scalar alpha) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   CheckSubOperandTypes(self.scalar_type(), other.scalar_type());
   auto xlatensors = GetPromotedXlaTensorsForBinaryOp(self, other);
   return bridge::AtenFromXlaTensor(
@@ -2363,7 +2437,7 @@ at::Tensor AtenXlaType::rsub(const at::Tensor& self, const at::Tensor& other,
 
 at::Tensor AtenXlaType::rsub(const at::Tensor& self, at::Scalar other,
                              at::Scalar alpha) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   CheckSubOperandTypes(self.scalar_type(), GetScalarType(other));
   return bridge::AtenFromXlaTensor(
       XLATensor::rsub(bridge::GetXlaTensor(self), other, alpha));
@@ -2372,7 +2446,7 @@ at::Tensor AtenXlaType::rsub(const at::Tensor& self, at::Scalar other,
 at::Tensor& AtenXlaType::scatter_(at::Tensor& self, int64_t dim,
                                   const at::Tensor& index,
                                   const at::Tensor& src) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::scatter_(self_tensor, dim, bridge::GetXlaTensor(index),
                       bridge::GetXlaTensor(src));
@@ -2381,7 +2455,7 @@ at::Tensor& AtenXlaType::scatter_(at::Tensor& self, int64_t dim,
 
 at::Tensor& AtenXlaType::scatter_(at::Tensor& self, int64_t dim,
                                   const at::Tensor& index, at::Scalar value) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::scatter_(self_tensor, dim, bridge::GetXlaTensor(index), value);
   return self;
@@ -2390,7 +2464,7 @@ at::Tensor& AtenXlaType::scatter_(at::Tensor& self, int64_t dim,
 at::Tensor& AtenXlaType::scatter_add_(at::Tensor& self, int64_t dim,
                                       const at::Tensor& index,
                                       const at::Tensor& src) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::scatter_add_(self_tensor, dim, bridge::GetXlaTensor(index),
                           bridge::GetXlaTensor(src));
@@ -2399,19 +2473,19 @@ at::Tensor& AtenXlaType::scatter_add_(at::Tensor& self, int64_t dim,
 
 at::Tensor AtenXlaType::select(const at::Tensor& self, int64_t dim,
                                int64_t index) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::select(bridge::GetXlaTensor(self), dim, index));
 }
 
 at::Tensor AtenXlaType::sigmoid(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::sigmoid(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor& AtenXlaType::sigmoid_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::sigmoid_(self_tensor);
   return self;
@@ -2419,42 +2493,42 @@ at::Tensor& AtenXlaType::sigmoid_(at::Tensor& self) {
 
 at::Tensor AtenXlaType::sigmoid_backward(const at::Tensor& grad_output,
                                          const at::Tensor& output) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::sigmoid_backward(
       bridge::GetXlaTensor(grad_output), bridge::GetXlaTensor(output)));
 }
 
 at::Tensor AtenXlaType::sign(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::sign(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor& AtenXlaType::sign_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::sign_(self_tensor);
   return self;
 }
 
 at::Tensor AtenXlaType::sin(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::sin(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor& AtenXlaType::sin_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::sin_(self_tensor);
   return self;
 }
 
 at::Tensor AtenXlaType::sinh(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::sinh(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor& AtenXlaType::sinh_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::sinh_(self_tensor);
   return self;
@@ -2462,7 +2536,7 @@ at::Tensor& AtenXlaType::sinh_(at::Tensor& self) {
 
 at::Tensor AtenXlaType::slice(const at::Tensor& self, int64_t dim,
                               int64_t start, int64_t end, int64_t step) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::slice(bridge::GetXlaTensor(self), dim, start, end, step));
 }
@@ -2470,7 +2544,7 @@ at::Tensor AtenXlaType::slice(const at::Tensor& self, int64_t dim,
 at::Tensor AtenXlaType::smooth_l1_loss(const at::Tensor& self,
                                        const at::Tensor& target,
                                        int64_t reduction) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::smooth_l1_loss(
       bridge::GetXlaTensor(self), bridge::GetXlaTensor(target), reduction));
 }
@@ -2479,7 +2553,7 @@ at::Tensor AtenXlaType::smooth_l1_loss_backward(const at::Tensor& grad_output,
                                                 const at::Tensor& self,
                                                 const at::Tensor& target,
                                                 int64_t reduction) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::smooth_l1_loss_backward(
       bridge::GetXlaTensor(grad_output), bridge::GetXlaTensor(self),
       bridge::GetXlaTensor(target), reduction));
@@ -2487,7 +2561,7 @@ at::Tensor AtenXlaType::smooth_l1_loss_backward(const at::Tensor& grad_output,
 
 at::Tensor AtenXlaType::softplus(const at::Tensor& self, at::Scalar beta,
                                  at::Scalar threshold) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::softplus(bridge::GetXlaTensor(self), beta, threshold));
 }
@@ -2496,14 +2570,14 @@ at::Tensor AtenXlaType::softplus_backward(const at::Tensor& grad_output,
                                           const at::Tensor& self,
                                           at::Scalar beta, at::Scalar threshold,
                                           const at::Tensor& output) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::softplus_backward(
       bridge::GetXlaTensor(grad_output), bridge::GetXlaTensor(self), beta,
       threshold, bridge::GetXlaTensor(output)));
 }
 
 at::Tensor AtenXlaType::softshrink(const at::Tensor& self, at::Scalar lambda) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::softshrink(bridge::GetXlaTensor(self), lambda));
 }
@@ -2511,7 +2585,7 @@ at::Tensor AtenXlaType::softshrink(const at::Tensor& self, at::Scalar lambda) {
 at::Tensor AtenXlaType::softshrink_backward(const at::Tensor& grad_out,
                                             const at::Tensor& self,
                                             at::Scalar lambda) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::softshrink_backward(
       bridge::GetXlaTensor(grad_out), bridge::GetXlaTensor(self), lambda));
 }
@@ -2519,7 +2593,7 @@ at::Tensor AtenXlaType::softshrink_backward(const at::Tensor& grad_out,
 std::tuple<at::Tensor, at::Tensor> AtenXlaType::sort(const at::Tensor& self,
                                                      int64_t dim,
                                                      bool descending) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   auto results = XLATensor::topk(bridge::GetXlaTensor(self), self.size(dim),
                                  dim, descending, true);
   return std::make_tuple(bridge::AtenFromXlaTensor(std::get<0>(results)),
@@ -2528,7 +2602,7 @@ std::tuple<at::Tensor, at::Tensor> AtenXlaType::sort(const at::Tensor& self,
 
 std::vector<at::Tensor> AtenXlaType::split(const at::Tensor& self,
                                            int64_t split_size, int64_t dim) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   auto xla_tensors =
       XLATensor::split(bridge::GetXlaTensor(self), split_size, dim);
   return bridge::AtenFromXlaTensors(xla_tensors);
@@ -2536,58 +2610,58 @@ std::vector<at::Tensor> AtenXlaType::split(const at::Tensor& self,
 
 std::vector<at::Tensor> AtenXlaType::split_with_sizes(
     const at::Tensor& self, at::IntArrayRef split_sizes, int64_t dim) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   auto xla_tensors = XLATensor::split_with_sizes(
       bridge::GetXlaTensor(self), XlaHelpers::I64List(split_sizes), dim);
   return bridge::AtenFromXlaTensors(xla_tensors);
 }
 
 at::Tensor AtenXlaType::sqrt(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::sqrt(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor& AtenXlaType::sqrt_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::sqrt_(self_tensor);
   return self;
 }
 
 at::Tensor AtenXlaType::squeeze(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::squeeze(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor AtenXlaType::squeeze(const at::Tensor& self, int64_t dim) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::squeeze(bridge::GetXlaTensor(self), dim));
 }
 
 at::Tensor& AtenXlaType::squeeze_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::squeeze_(self_tensor);
   return self;
 }
 
 at::Tensor& AtenXlaType::squeeze_(at::Tensor& self, int64_t dim) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::squeeze_(self_tensor, dim);
   return self;
 }
 
 at::Tensor AtenXlaType::stack(at::TensorList tensors, int64_t dim) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::stack(bridge::GetXlaTensors(tensors), dim));
 }
 
 at::Tensor AtenXlaType::std(const at::Tensor& self, bool unbiased) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   return bridge::AtenFromXlaTensor(XLATensor::std(
       self_tensor,
@@ -2597,7 +2671,7 @@ at::Tensor AtenXlaType::std(const at::Tensor& self, bool unbiased) {
 
 at::Tensor AtenXlaType::std(const at::Tensor& self, at::IntArrayRef dim,
                             bool unbiased, bool keepdim) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::std(
       bridge::GetXlaTensor(self), xla::util::ToVector<xla::int64>(dim),
       /*keep_reduced_dimensions*/ keepdim, unbiased));
@@ -2605,7 +2679,7 @@ at::Tensor AtenXlaType::std(const at::Tensor& self, at::IntArrayRef dim,
 
 at::Tensor AtenXlaType::sub(const at::Tensor& self, const at::Tensor& other,
                             at::Scalar alpha) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   CheckSubOperandTypes(self.scalar_type(), other.scalar_type());
   auto xlatensors = GetPromotedXlaTensorsForBinaryOp(self, other);
   return bridge::AtenFromXlaTensor(
@@ -2614,7 +2688,7 @@ at::Tensor AtenXlaType::sub(const at::Tensor& self, const at::Tensor& other,
 
 at::Tensor AtenXlaType::sub(const at::Tensor& self, at::Scalar other,
                             at::Scalar alpha) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   CheckSubOperandTypes(self.scalar_type(), GetScalarType(other));
   return bridge::AtenFromXlaTensor(
       XLATensor::sub(bridge::GetXlaTensor(self), other, alpha));
@@ -2622,7 +2696,7 @@ at::Tensor AtenXlaType::sub(const at::Tensor& self, at::Scalar other,
 
 at::Tensor& AtenXlaType::sub_(at::Tensor& self, const at::Tensor& other,
                               at::Scalar alpha) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   CheckSubOperandTypes(self.scalar_type(), other.scalar_type());
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::sub_(self_tensor,
@@ -2633,7 +2707,7 @@ at::Tensor& AtenXlaType::sub_(at::Tensor& self, const at::Tensor& other,
 
 at::Tensor& AtenXlaType::sub_(at::Tensor& self, at::Scalar other,
                               at::Scalar alpha) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   CheckSubOperandTypes(self.scalar_type(), GetScalarType(other));
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::sub_(self_tensor, other, alpha);
@@ -2642,7 +2716,7 @@ at::Tensor& AtenXlaType::sub_(at::Tensor& self, at::Scalar other,
 
 at::Tensor AtenXlaType::sum(const at::Tensor& self,
                             c10::optional<at::ScalarType> dtype) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   return bridge::AtenFromXlaTensor(XLATensor::sum(
       self_tensor,
@@ -2652,7 +2726,7 @@ at::Tensor AtenXlaType::sum(const at::Tensor& self,
 
 at::Tensor AtenXlaType::sum(const at::Tensor& self, at::IntArrayRef dim,
                             bool keepdim, c10::optional<at::ScalarType> dtype) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::sum(bridge::GetXlaTensor(self),
                      xla::util::ToVector<xla::int64>(dim), keepdim, dtype));
@@ -2660,7 +2734,7 @@ at::Tensor AtenXlaType::sum(const at::Tensor& self, at::IntArrayRef dim,
 
 std::tuple<at::Tensor, at::Tensor, at::Tensor> AtenXlaType::svd(
     const at::Tensor& self, bool some, bool compute_uv) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   auto results = XLATensor::svd(bridge::GetXlaTensor(self), some, compute_uv);
   return std::make_tuple(bridge::AtenFromXlaTensor(std::get<0>(results)),
                          bridge::AtenFromXlaTensor(std::get<1>(results)),
@@ -2670,7 +2744,7 @@ std::tuple<at::Tensor, at::Tensor, at::Tensor> AtenXlaType::svd(
 std::tuple<at::Tensor, at::Tensor> AtenXlaType::symeig(const at::Tensor& self,
                                                        bool eigenvectors,
                                                        bool upper) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   auto results =
       XLATensor::symeig(bridge::GetXlaTensor(self), eigenvectors, upper);
   return std::make_tuple(bridge::AtenFromXlaTensor(std::get<0>(results)),
@@ -2678,43 +2752,43 @@ std::tuple<at::Tensor, at::Tensor> AtenXlaType::symeig(const at::Tensor& self,
 }
 
 at::Tensor AtenXlaType::t(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::transpose(bridge::GetXlaTensor(self), 0, 1));
 }
 
 at::Tensor& AtenXlaType::t_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::transpose_(self_tensor, 0, 1);
   return self;
 }
 
 at::Tensor AtenXlaType::take(const at::Tensor& self, const at::Tensor& index) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::take(bridge::GetXlaTensor(self), bridge::GetXlaTensor(index)));
 }
 
 at::Tensor AtenXlaType::tan(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::tan(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor& AtenXlaType::tan_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::tan_(self_tensor);
   return self;
 }
 
 at::Tensor AtenXlaType::tanh(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::tanh(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor& AtenXlaType::tanh_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::tanh_(self_tensor);
   return self;
@@ -2722,21 +2796,21 @@ at::Tensor& AtenXlaType::tanh_(at::Tensor& self) {
 
 at::Tensor AtenXlaType::tanh_backward(const at::Tensor& grad_output,
                                       const at::Tensor& output) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::tanh_backward(
       bridge::GetXlaTensor(grad_output), bridge::GetXlaTensor(output)));
 }
 
 at::Tensor AtenXlaType::threshold(const at::Tensor& self, at::Scalar threshold,
                                   at::Scalar value) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::threshold(
       bridge::GetXlaTensor(self), threshold.to<double>(), value.to<double>()));
 }
 
 at::Tensor& AtenXlaType::threshold_(at::Tensor& self, at::Scalar threshold,
                                     at::Scalar value) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::threshold_(self_tensor, threshold.to<double>(),
                         value.to<double>());
@@ -2746,7 +2820,7 @@ at::Tensor& AtenXlaType::threshold_(at::Tensor& self, at::Scalar threshold,
 at::Tensor AtenXlaType::threshold_backward(const at::Tensor& grad_output,
                                            const at::Tensor& self,
                                            at::Scalar threshold) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(XLATensor::threshold_backward(
       bridge::GetXlaTensor(grad_output), bridge::GetXlaTensor(self),
       threshold.to<double>()));
@@ -2756,7 +2830,7 @@ std::tuple<at::Tensor, at::Tensor> AtenXlaType::topk(const at::Tensor& self,
                                                      int64_t k, int64_t dim,
                                                      bool largest,
                                                      bool sorted) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   auto results =
       XLATensor::topk(bridge::GetXlaTensor(self), k, dim, largest, sorted);
   return std::make_tuple(bridge::AtenFromXlaTensor(std::get<0>(results)),
@@ -2764,21 +2838,21 @@ std::tuple<at::Tensor, at::Tensor> AtenXlaType::topk(const at::Tensor& self,
 }
 
 at::Tensor AtenXlaType::trace(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::trace(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor AtenXlaType::transpose(const at::Tensor& self, int64_t dim0,
                                   int64_t dim1) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::transpose(bridge::GetXlaTensor(self), dim0, dim1));
 }
 
 at::Tensor& AtenXlaType::transpose_(at::Tensor& self, int64_t dim0,
                                     int64_t dim1) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::transpose_(self_tensor, dim0, dim1);
   return self;
@@ -2787,7 +2861,7 @@ at::Tensor& AtenXlaType::transpose_(at::Tensor& self, int64_t dim0,
 std::tuple<at::Tensor, at::Tensor> AtenXlaType::triangular_solve(
     const at::Tensor& b, const at::Tensor& A, bool upper, bool transpose,
     bool unitriangular) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   // Currently, ATen doesn't have a left_side option. Once this
   // is added, this API will have to be changed.
   auto results = XLATensor::triangular_solve(
@@ -2798,39 +2872,39 @@ std::tuple<at::Tensor, at::Tensor> AtenXlaType::triangular_solve(
 }
 
 at::Tensor AtenXlaType::tril(const at::Tensor& self, int64_t diagonal) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::tril(bridge::GetXlaTensor(self), diagonal));
 }
 
 at::Tensor& AtenXlaType::tril_(at::Tensor& self, int64_t diagonal) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::tril_(self_tensor, diagonal);
   return self;
 }
 
 at::Tensor AtenXlaType::triu(const at::Tensor& self, int64_t diagonal) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::triu(bridge::GetXlaTensor(self), diagonal));
 }
 
 at::Tensor& AtenXlaType::triu_(at::Tensor& self, int64_t diagonal) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::triu_(self_tensor, diagonal);
   return self;
 }
 
 at::Tensor AtenXlaType::trunc(const at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::trunc(bridge::GetXlaTensor(self)));
 }
 
 at::Tensor& AtenXlaType::trunc_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::trunc_(self_tensor);
   return self;
@@ -2838,19 +2912,19 @@ at::Tensor& AtenXlaType::trunc_(at::Tensor& self) {
 
 std::vector<at::Tensor> AtenXlaType::unbind(const at::Tensor& self,
                                             int64_t dim) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensors(
       XLATensor::unbind(bridge::GetXlaTensor(self), dim));
 }
 
 at::Tensor AtenXlaType::unsqueeze(const at::Tensor& self, int64_t dim) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::unsqueeze(bridge::GetXlaTensor(self), dim));
 }
 
 at::Tensor& AtenXlaType::unsqueeze_(at::Tensor& self, int64_t dim) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::unsqueeze_(self_tensor, dim);
   return self;
@@ -2859,7 +2933,7 @@ at::Tensor& AtenXlaType::unsqueeze_(at::Tensor& self, int64_t dim) {
 at::Tensor AtenXlaType::upsample_bilinear2d(const at::Tensor& self,
                                             at::IntArrayRef output_size,
                                             bool align_corners) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   // Only the XLA TPU backend for now implements the CustomCall required by our
   // XLA lowering.
@@ -2875,7 +2949,7 @@ at::Tensor AtenXlaType::upsample_bilinear2d(const at::Tensor& self,
 at::Tensor AtenXlaType::upsample_bilinear2d_backward(
     const at::Tensor& grad_output, at::IntArrayRef output_size,
     at::IntArrayRef input_size, bool align_corners) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor grad_output_tensor = bridge::GetXlaTensor(grad_output);
   // Only the XLA TPU backend for now implements the CustomCall required by our
   // XLA lowering.
@@ -2890,7 +2964,7 @@ at::Tensor AtenXlaType::upsample_bilinear2d_backward(
 
 at::Tensor AtenXlaType::upsample_nearest2d(const at::Tensor& self,
                                            at::IntArrayRef output_size) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   // Only the XLA TPU backend for now implements the CustomCall required by our
   // XLA lowering.
@@ -2904,7 +2978,7 @@ at::Tensor AtenXlaType::upsample_nearest2d(const at::Tensor& self,
 at::Tensor AtenXlaType::upsample_nearest2d_backward(
     const at::Tensor& grad_output, at::IntArrayRef output_size,
     at::IntArrayRef input_size) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor grad_output_tensor = bridge::GetXlaTensor(grad_output);
   // Only the XLA TPU backend for now implements the CustomCall required by our
   // XLA lowering.
@@ -2918,13 +2992,13 @@ at::Tensor AtenXlaType::upsample_nearest2d_backward(
 }
 
 at::Tensor AtenXlaType::view(const at::Tensor& self, at::IntArrayRef size) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   return bridge::AtenFromXlaTensor(
       XLATensor::view(bridge::GetXlaTensor(self), XlaHelpers::I64List(size)));
 }
 
 at::Tensor& AtenXlaType::zero_(at::Tensor& self) {
-  XLA_FN_COUNTER("xla::");
+  XLA_FN_PROFILE("xla::");
   XLATensor self_tensor = bridge::GetXlaTensor(self);
   XLATensor::zero_(self_tensor);
   return self;
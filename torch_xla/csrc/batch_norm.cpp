@@ -1,19 +1,63 @@
 #include "torch_xla/csrc/batch_norm.h"
 
+#include "tensorflow/compiler/xla/client/lib/constants.h"
+#include "tensorflow/compiler/xla/shape_util.h"
 #include "torch_xla/csrc/helpers.h"
 
 namespace torch_xla {
 namespace {
 
-xla::XlaOp VarianceRecover(const xla::XlaOp& invstd, float eps_value) {
-  xla::XlaBuilder* builder = invstd.builder();
-  const xla::Shape& invstd_shape = XlaHelpers::ShapeOfXlaOp(invstd);
-  xla::XlaOp eps =
-      XlaHelpers::ScalarValue(eps_value, invstd_shape.element_type(), builder);
-  xla::XlaOp one =
-      XlaHelpers::ScalarValue<float>(1, invstd_shape.element_type(), builder);
-  xla::XlaOp one_over_invstd = one / invstd;
-  return one_over_invstd * one_over_invstd - eps;
+// The batch normalization is expanded into plain reductions and element-wise
+// operations, rather than being emitted as the BatchNorm* XLA operations. This
+// lets the XLA fusion pass merge the normalization with the element-wise
+// consumers (like residual additions and activations) and producers (like the
+// activation gradients in the backward pass), which would otherwise each need
+// a separate pass over the activation tensors.
+
+// The features dimension is 1 for all the PyTorch batch norm layouts.
+constexpr xla::int64 kFeatureIndex = 1;
+
+std::vector<xla::int64> ReductionDimensions(xla::int64 rank) {
+  std::vector<xla::int64> dimensions;
+  for (xla::int64 dim = 0; dim < rank; ++dim) {
+    if (dim != kFeatureIndex) {
+      dimensions.push_back(dim);
+    }
+  }
+  return dimensions;
+}
+
+xla::XlaOp ReduceToFeatures(const xla::XlaOp& input) {
+  const xla::Shape& input_shape = XlaHelpers::ShapeOfXlaOp(input);
+  xla::XlaOp zero = xla::Zero(input.builder(), input_shape.element_type());
+  return xla::Reduce(
+      input, zero,
+      XlaHelpers::CreateAddComputation(input_shape.element_type()),
+      ReductionDimensions(input_shape.rank()));
+}
+
+xla::XlaOp BroadcastFeatures(const xla::XlaOp& features,
+                             const xla::Shape& input_shape) {
+  return xla::BroadcastInDim(features, input_shape.dimensions(),
+                             {kFeatureIndex});
+}
+
+// Returns the number of elements which get reduced into each feature.
+xla::XlaOp FeatureElementCount(const xla::Shape& input_shape,
+                               xla::XlaBuilder* builder) {
+  xla::int64 count = xla::ShapeUtil::ElementsIn(input_shape) /
+                     input_shape.dimensions(kFeatureIndex);
+  return XlaHelpers::ScalarValue<double>(count, input_shape.element_type(),
+                                         builder);
+}
+
+xla::XlaOp Normalize(const xla::XlaOp& input, const xla::XlaOp& weight,
+                     const xla::XlaOp& bias, const xla::XlaOp& mean,
+                     const xla::XlaOp& invstd) {
+  const xla::Shape& input_shape = XlaHelpers::ShapeOfXlaOp(input);
+  return (input - BroadcastFeatures(mean, input_shape)) *
+             BroadcastFeatures(invstd * weight, input_shape) +
+         BroadcastFeatures(bias, input_shape);
 }
 
 }  // namespace
@@ -24,42 +68,52 @@ xla::XlaOp BatchNormVarianceInvert(const xla::XlaOp& variance,
   const xla::Shape& variance_shape = XlaHelpers::ShapeOfXlaOp(variance);
   xla::XlaOp eps = XlaHelpers::ScalarValue(
       eps_value, variance_shape.element_type(), builder);
-  xla::XlaOp one =
-      XlaHelpers::ScalarValue<float>(1, variance_shape.element_type(), builder);
-  return one / xla::Sqrt(variance + eps);
+  return xla::Rsqrt(variance + eps);
 }
 
 BatchNormOutput BuildBatchNormTraining(const xla::XlaOp& input,
                                        const xla::XlaOp& weight,
                                        const xla::XlaOp& bias,
                                        float eps_value) {
-  xla::XlaOp outputs =
-      xla::BatchNormTraining(input, weight, bias, eps_value, 1);
-  xla::XlaOp output = xla::GetTupleElement(outputs, 0);
-  xla::XlaOp batch_mean = xla::GetTupleElement(outputs, 1);
-  xla::XlaOp batch_variance = xla::GetTupleElement(outputs, 2);
+  const xla::Shape& input_shape = XlaHelpers::ShapeOfXlaOp(input);
+  xla::XlaOp count = FeatureElementCount(input_shape, input.builder());
+  xla::XlaOp batch_mean = ReduceToFeatures(input) / count;
+  xla::XlaOp batch_square_mean = ReduceToFeatures(input * input) / count;
+  // The rounding errors of E[x^2] - E[x]^2 can lead to tiny negative values.
+  xla::XlaOp batch_variance = xla::Max(
+      batch_square_mean - batch_mean * batch_mean,
+      xla::Zero(input.builder(), input_shape.element_type()));
+  xla::XlaOp output =
+      Normalize(input, weight, bias, batch_mean,
+                BatchNormVarianceInvert(batch_variance, eps_value));
   return {output, batch_mean, batch_variance};
 }
 
 xla::XlaOp BuildBatchNormInference(
     const xla::XlaOp& input, const xla::XlaOp& weight, const xla::XlaOp& bias,
     const xla::XlaOp& mean, const xla::XlaOp& variance, float eps_value) {
-  return xla::BatchNormInference(input, weight, bias, mean, variance, eps_value,
-                                 1);
+  return Normalize(input, weight, bias, mean,
+                   BatchNormVarianceInvert(variance, eps_value));
 }
 
 BatchNormGrads BuildBatchNormBackward(const xla::XlaOp& grad,
                                       const xla::XlaOp& input,
                                       const xla::XlaOp& weight,
                                       const xla::XlaOp& save_mean,
-                                      const xla::XlaOp& save_invstd,
-                                      bool training, float eps_value) {
-  xla::XlaOp grads = xla::BatchNormGrad(input, weight, save_mean,
-                                        VarianceRecover(save_invstd, eps_value),
-                                        grad, eps_value, 1);
-  xla::XlaOp grad_input = xla::GetTupleElement(grads, 0);
-  xla::XlaOp grad_weight = xla::GetTupleElement(grads, 1);
-  xla::XlaOp grad_bias = xla::GetTupleElement(grads, 2);
+                                      const xla::XlaOp& save_invstd) {
+  const xla::Shape& input_shape = XlaHelpers::ShapeOfXlaOp(input);
+  xla::XlaOp normalized = (input - BroadcastFeatures(save_mean, input_shape)) *
+                          BroadcastFeatures(save_invstd, input_shape);
+  xla::XlaOp grad_bias = ReduceToFeatures(grad);
+  xla::XlaOp grad_weight = ReduceToFeatures(grad * normalized);
+  xla::XlaOp scale = BroadcastFeatures(weight * save_invstd, input_shape);
+  // The batch statistics depend on the input, so their gradients need to be
+  // accounted as well.
+  xla::XlaOp count = FeatureElementCount(input_shape, input.builder());
+  xla::XlaOp grad_input =
+      scale *
+      (grad - BroadcastFeatures(grad_bias / count, input_shape) -
+       normalized * BroadcastFeatures(grad_weight / count, input_shape));
   return {grad_input, grad_weight, grad_bias};
 }
 
@@ -32,7 +32,6 @@ BatchNormGrads BuildBatchNormBackward(const xla::XlaOp& grad,
                                       const xla::XlaOp& input,
                                       const xla::XlaOp& weight,
                                       const xla::XlaOp& save_mean,
-                                      const xla::XlaOp& save_invstd,
-                                      bool training, float eps_value);
+                                      const xla::XlaOp& save_invstd);
 
 }  // namespace torch_xla
@@ -0,0 +1,449 @@
+#include "torch_xla/csrc/checkpoint.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/compiler/xla/shape_util.h"
+#include "tensorflow/compiler/xla/xla_client/async_task.h"
+#include "tensorflow/compiler/xla/xla_client/debug_macros.h"
+#include "tensorflow/compiler/xla/xla_client/metrics.h"
+#include "tensorflow/compiler/xla/xla_client/multi_wait.h"
+#include "tensorflow/compiler/xla/xla_client/thread_pool.h"
+#include "tensorflow/compiler/xla/xla_client/tf_logging.h"
+#include "torch_xla/csrc/tensor_util.h"
+
+namespace torch_xla {
+namespace {
+
+static const char* const kManifestHeader = "torch_xla_checkpoint";
+static const int kManifestVersion = 1;
+// The tensor data within the shard files is aligned to this value, so that it
+// can be directly mapped and used by the readers.
+static const xla::int64 kDataAlignment = 64;
+
+using BatchTask = xla::util::AsyncTask<std::vector<at::Tensor>>;
+
+struct TensorEntry {
+  at::ScalarType scalar_type;
+  std::vector<int64_t> sizes;
+  xla::int64 shard = 0;
+  xla::int64 offset = 0;
+  xla::int64 size = 0;
+};
+
+std::string GetShardPath(const std::string& path, xla::int64 shard) {
+  char suffix[32];
+  std::snprintf(suffix, sizeof(suffix), ".shard-%05lld",
+                static_cast<long long>(shard));
+  return absl::StrCat(path, suffix);
+}
+
+std::string GetManifestPath(const std::string& path) {
+  return absl::StrCat(path, ".manifest");
+}
+
+at::ScalarType ScalarTypeFromName(const std::string& name) {
+  static const at::ScalarType kScalarTypes[] = {
+      at::ScalarType::Bool,  at::ScalarType::Byte,   at::ScalarType::Char,
+      at::ScalarType::Short, at::ScalarType::Int,    at::ScalarType::Long,
+      at::ScalarType::Half,  at::ScalarType::Float,  at::ScalarType::Double,
+      at::ScalarType::BFloat16};
+  for (auto scalar_type : kScalarTypes) {
+    if (name == c10::toString(scalar_type)) {
+      return scalar_type;
+    }
+  }
+  XLA_ERROR() << "Unsupported checkpoint tensor type: " << name;
+}
+
+// Writes tensors data into a sequence of shard files.
+class ShardWriter {
+ public:
+  ShardWriter(std::string path, xla::int64 shard_bytes)
+      : path_(std::move(path)), shard_bytes_(shard_bytes) {}
+
+  void Write(const at::Tensor& tensor, TensorEntry* entry) {
+    at::Tensor ctensor = tensor.contiguous();
+    xla::int64 size = ctensor.numel() * ctensor.element_size();
+    if (file_ == nullptr || (offset_ > 0 && offset_ + size > shard_bytes_)) {
+      NextShard();
+    }
+    xla::int64 padding =
+        (kDataAlignment - offset_ % kDataAlignment) % kDataAlignment;
+    if (padding > 0) {
+      static const char kZeros[kDataAlignment] = {};
+      file_->write(kZeros, padding);
+      offset_ += padding;
+    }
+    entry->shard = shard_;
+    entry->offset = offset_;
+    entry->size = size;
+    file_->write(static_cast<const char*>(ctensor.data_ptr()), size);
+    XLA_CHECK(*file_) << "Failed to write checkpoint shard "
+                      << GetShardPath(path_, shard_);
+    offset_ += size;
+  }
+
+  xla::int64 Close() {
+    if (file_ != nullptr) {
+      file_->close();
+      XLA_CHECK(*file_) << "Failed to close checkpoint shard "
+                        << GetShardPath(path_, shard_);
+      file_ = nullptr;
+    }
+    return shard_ + 1;
+  }
+
+ private:
+  void NextShard() {
+    Close();
+    shard_ += 1;
+    offset_ = 0;
+    std::string shard_path = GetShardPath(path_, shard_);
+    file_.reset(
+        new std::ofstream(shard_path, std::ios::out | std::ios::binary));
+    XLA_CHECK(*file_) << "Unable to create checkpoint shard " << shard_path;
+  }
+
+  std::string path_;
+  xla::int64 shard_bytes_ = 0;
+  xla::int64 shard_ = -1;
+  xla::int64 offset_ = 0;
+  std::unique_ptr<std::ofstream> file_;
+};
+
+// Read only memory mapping of a whole file.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path) : path_(path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    XLA_CHECK_GE(fd, 0) << "Unable to open " << path << ": "
+                        << std::strerror(errno);
+    struct stat st;
+    int rc = fstat(fd, &st);
+    if (rc == 0) {
+      size_ = st.st_size;
+      if (size_ > 0) {
+        data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      }
+    }
+    // The close() call below can overwrite errno.
+    int error = errno;
+    close(fd);
+    XLA_CHECK_EQ(rc, 0) << "Unable to stat " << path << ": "
+                        << std::strerror(error);
+    XLA_CHECK(data_ != MAP_FAILED) << "Unable to map " << path << ": "
+                                   << std::strerror(error);
+    if (data_ != nullptr) {
+      // The data is consumed mostly sequentially by the upload.
+      madvise(data_, size_, MADV_SEQUENTIAL);
+      madvise(data_, size_, MADV_WILLNEED);
+    }
+  }
+
+  ~MappedFile() {
+    if (data_ != nullptr) {
+      munmap(data_, size_);
+    }
+  }
+
+  const std::string& path() const { return path_; }
+
+  char* data() const { return static_cast<char*>(data_); }
+
+  size_t size() const { return size_; }
+
+ private:
+  std::string path_;
+  void* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+// Uploads to device the tensors of a shard file. The tensors are created as
+// views over the mapped file pages, which the populate functions read from
+// directly, hence no intermediate host copy is needed. The uploads are issued
+// in batches of at most batch_bytes bytes.
+void UploadShard(const MappedFile& file,
+                 const std::vector<TensorEntry>& entries,
+                 const std::vector<size_t>& indices, const Device& device,
+                 xla::int64 batch_bytes,
+                 std::vector<xla::ComputationClient::DataPtr>* tensors_data) {
+  for (size_t start = 0; start < indices.size();) {
+    std::vector<xla::ComputationClient::TensorSource> source_tensors;
+    xla::int64 current_batch_bytes = 0;
+    size_t end = start;
+    for (; end < indices.size(); ++end) {
+      const TensorEntry& entry = entries[indices[end]];
+      if (end > start && current_batch_bytes + entry.size > batch_bytes) {
+        break;
+      }
+      XLA_CHECK_LE(entry.offset + entry.size, file.size()) << file.path();
+      current_batch_bytes += entry.size;
+      at::Tensor tensor =
+          at::from_blob(file.data() + entry.offset, entry.sizes,
+                        at::TensorOptions(entry.scalar_type));
+      auto populate_fn =
+          [tensor, device](
+              const xla::ComputationClient::TensorSource& source_tensor,
+              void* dest_buffer, size_t dest_buffer_size) {
+            PopulateTensorBuffer(tensor, source_tensor.shape, dest_buffer,
+                                 dest_buffer_size, device);
+          };
+      source_tensors.emplace_back(
+          CreateComputationShapeFromTensor(tensor, &device), device.ToString(),
+          std::move(populate_fn));
+    }
+    std::vector<xla::ComputationClient::DataPtr> handles =
+        xla::ComputationClient::Get()->TransferToServer(source_tensors);
+    for (size_t i = start; i < end; ++i) {
+      (*tensors_data)[indices[i]] = std::move(handles[i - start]);
+    }
+    XLA_COUNTER("CheckpointReadBatches", 1);
+    start = end;
+  }
+}
+
+// Schedules the fetch of the tensors data of a batch. The device data is
+// fetched with a single TransferFromServer() call, and the literals are
+// converted into PyTorch tensors in parallel.
+BatchTask ScheduleBatchFetch(std::vector<c10::optional<at::Tensor>> host_data,
+                             std::vector<xla::ComputationClient::DataPtr> data,
+                             std::vector<at::ScalarType> scalar_types) {
+  auto fetchfn = [host_data = std::move(host_data), data = std::move(data),
+                  scalar_types = std::move(scalar_types)]() {
+    std::vector<xla::ComputationClient::DataPtr> tensors_data;
+    for (auto& xla_data : data) {
+      if (xla_data != nullptr) {
+        tensors_data.push_back(xla_data);
+      }
+    }
+    std::vector<xla::Literal> literals =
+        xla::ComputationClient::Get()->TransferFromServer(tensors_data);
+
+    std::vector<at::Tensor> results(host_data.size());
+    xla::util::MultiWait mwait(literals.size());
+    for (size_t i = 0, literal_index = 0; i < host_data.size(); ++i) {
+      if (host_data[i]) {
+        results[i] = *host_data[i];
+      } else {
+        auto convert_fn = [&, i, literal_index]() {
+          results[i] = MakeTensorFromXlaLiteral(literals[literal_index],
+                                                scalar_types[i]);
+        };
+        xla::env::ScheduleClosure(mwait.Completer(std::move(convert_fn)));
+        ++literal_index;
+      }
+    }
+    mwait.Wait();
+    return results;
+  };
+  BatchTask task(std::move(fetchfn));
+  task.Schedule();
+  return task;
+}
+
+void WriteManifest(const std::string& path, xla::int64 num_shards,
+                   const std::vector<TensorEntry>& entries) {
+  std::string manifest_path = GetManifestPath(path);
+  std::string tmp_path = absl::StrCat(manifest_path, ".tmp");
+  {
+    std::ofstream manifest(tmp_path);
+    XLA_CHECK(manifest) << "Unable to create checkpoint manifest " << tmp_path;
+    manifest << kManifestHeader << " " << kManifestVersion << "\n";
+    manifest << num_shards << " " << entries.size() << "\n";
+    for (auto& entry : entries) {
+      manifest << c10::toString(entry.scalar_type) << " " << entry.shard << " "
+               << entry.offset << " " << entry.size << " "
+               << entry.sizes.size();
+      for (auto dim : entry.sizes) {
+        manifest << " " << dim;
+      }
+      manifest << "\n";
+    }
+    manifest.close();
+    XLA_CHECK(manifest) << "Failed to write checkpoint manifest " << tmp_path;
+  }
+  // Make the checkpoint visible only once all its data has been written.
+  XLA_CHECK_EQ(std::rename(tmp_path.c_str(), manifest_path.c_str()), 0)
+      << "Unable to rename " << tmp_path << " to " << manifest_path;
+}
+
+std::vector<TensorEntry> ReadManifest(const std::string& path,
+                                      xla::int64* num_shards) {
+  std::string manifest_path = GetManifestPath(path);
+  std::ifstream manifest(manifest_path);
+  XLA_CHECK(manifest) << "Unable to open checkpoint manifest "
+                      << manifest_path;
+  std::string header;
+  int version = 0;
+  size_t num_entries = 0;
+  manifest >> header >> version >> *num_shards >> num_entries;
+  XLA_CHECK(manifest && header == kManifestHeader)
+      << "Invalid checkpoint manifest " << manifest_path;
+  XLA_CHECK_EQ(version, kManifestVersion)
+      << "Unsupported checkpoint manifest version in " << manifest_path;
+  std::vector<TensorEntry> entries(num_entries);
+  for (auto& entry : entries) {
+    std::string type_name;
+    size_t rank = 0;
+    manifest >> type_name >> entry.shard >> entry.offset >> entry.size >> rank;
+    entry.scalar_type = ScalarTypeFromName(type_name);
+    entry.sizes.resize(rank);
+    for (auto& dim : entry.sizes) {
+      manifest >> dim;
+    }
+    XLA_CHECK(manifest) << "Invalid checkpoint manifest " << manifest_path;
+    XLA_CHECK_LT(entry.shard, *num_shards) << manifest_path;
+  }
+  return entries;
+}
+
+}  // namespace
+
+void WriteCheckpoint(const std::string& path, std::vector<XLATensor>* tensors,
+                     xla::int64 batch_bytes, xla::int64 shard_bytes) {
+  XLA_TIMED("WriteCheckpointTime");
+  XLATensor::SyncTensorsGraph(tensors, {}, /*wait=*/true,
+                              /*sync_xla_data=*/true);
+
+  // Split the tensors into batches of (at most) batch_bytes bytes.
+  std::vector<size_t> batch_starts;
+  std::vector<c10::optional<at::Tensor>> host_data;
+  std::vector<xla::ComputationClient::DataPtr> device_data;
+  std::vector<TensorEntry> entries(tensors->size());
+  xla::int64 current_batch_bytes = 0;
+  for (size_t i = 0; i < tensors->size(); ++i) {
+    XLATensor& tensor = (*tensors)[i];
+    c10::optional<at::Tensor> tensor_data = tensor.CurrentTensorData();
+    xla::ComputationClient::DataPtr xla_data;
+    xla::int64 size = 0;
+    if (tensor_data) {
+      size = tensor_data->numel() * tensor_data->element_size();
+    } else {
+      xla_data = tensor.GetXlaData();
+      size = xla::ShapeUtil::ByteSizeOf(xla_data->shape(), /*pointer_size=*/8);
+    }
+    if (batch_starts.empty() || current_batch_bytes + size > batch_bytes) {
+      batch_starts.push_back(i);
+      current_batch_bytes = 0;
+    }
+    current_batch_bytes += size;
+    host_data.push_back(std::move(tensor_data));
+    device_data.push_back(std::move(xla_data));
+    entries[i].scalar_type = tensor.dtype();
+    for (auto dim : tensor.shape().get().dimensions()) {
+      entries[i].sizes.push_back(dim);
+    }
+  }
+  batch_starts.push_back(tensors->size());
+
+  auto schedule_batch = [&](size_t batch) {
+    size_t start = batch_starts[batch];
+    size_t end = batch_starts[batch + 1];
+    std::vector<at::ScalarType> scalar_types;
+    for (size_t i = start; i < end; ++i) {
+      scalar_types.push_back(entries[i].scalar_type);
+    }
+    return ScheduleBatchFetch(
+        std::vector<c10::optional<at::Tensor>>(host_data.begin() + start,
+                                               host_data.begin() + end),
+        std::vector<xla::ComputationClient::DataPtr>(
+            device_data.begin() + start, device_data.begin() + end),
+        std::move(scalar_types));
+  };
+
+  // We keep at most two batches of data in host memory: the one being written,
+  // and the one being fetched from the device.
+  ShardWriter writer(path, shard_bytes);
+  size_t num_batches = batch_starts.size() - 1;
+  std::unique_ptr<BatchTask> next_batch;
+  if (num_batches > 0) {
+    next_batch.reset(new BatchTask(schedule_batch(0)));
+  }
+  for (size_t batch = 0; batch < num_batches; ++batch) {
+    std::vector<at::Tensor> batch_tensors = next_batch->Wait().ConsumeValue();
+    next_batch.reset();
+    if (batch + 1 < num_batches) {
+      next_batch.reset(new BatchTask(schedule_batch(batch + 1)));
+    }
+    for (size_t i = 0; i < batch_tensors.size(); ++i) {
+      writer.Write(batch_tensors[i], &entries[batch_starts[batch] + i]);
+    }
+    XLA_COUNTER("CheckpointWriteBatches", 1);
+  }
+  WriteManifest(path, writer.Close(), entries);
+  TF_VLOG(3) << "Wrote checkpoint " << path << " with " << entries.size()
+             << " tensors in " << num_batches << " batches";
+}
+
+std::vector<XLATensor> ReadCheckpointToDevice(const std::string& path,
+                                              const Device& device,
+                                              xla::int64 batch_bytes) {
+  XLA_TIMED("ReadCheckpointToDeviceTime");
+  xla::int64 num_shards = 0;
+  std::vector<TensorEntry> entries = ReadManifest(path, &num_shards);
+  std::vector<std::vector<size_t>> shards_indices(num_shards);
+  for (size_t i = 0; i < entries.size(); ++i) {
+    shards_indices[entries[i].shard].push_back(i);
+  }
+  // Shard files are processed in parallel, while the tensors within a shard
+  // are uploaded in sequential batches, to bound the host memory used by the
+  // upload buffers.
+  std::vector<xla::ComputationClient::DataPtr> tensors_data(entries.size());
+  xla::util::MultiWait mwait(num_shards);
+  for (xla::int64 shard = 0; shard < num_shards; ++shard) {
+    auto upload_fn = [&, shard]() {
+      MappedFile file(GetShardPath(path, shard));
+      UploadShard(file, entries, shards_indices[shard], device, batch_bytes,
+                  &tensors_data);
+    };
+    xla::env::ScheduleIoClosure(mwait.Completer(std::move(upload_fn)));
+  }
+  mwait.Wait();
+
+  std::vector<XLATensor> tensors;
+  tensors.reserve(entries.size());
+  for (size_t i = 0; i < entries.size(); ++i) {
+    tensors.push_back(
+        XLATensor::Create(std::move(tensors_data[i]), entries[i].scalar_type));
+  }
+  return tensors;
+}
+
+std::vector<at::Tensor> ReadCheckpoint(const std::string& path) {
+  XLA_TIMED("ReadCheckpointTime");
+  xla::int64 num_shards = 0;
+  std::vector<TensorEntry> entries = ReadManifest(path, &num_shards);
+  std::vector<std::unique_ptr<std::ifstream>> shards(num_shards);
+  std::vector<at::Tensor> tensors;
+  tensors.reserve(entries.size());
+  for (auto& entry : entries) {
+    std::unique_ptr<std::ifstream>& shard = shards[entry.shard];
+    if (shard == nullptr) {
+      std::string shard_path = GetShardPath(path, entry.shard);
+      shard.reset(
+          new std::ifstream(shard_path, std::ios::in | std::ios::binary));
+      XLA_CHECK(*shard) << "Unable to open checkpoint shard " << shard_path;
+    }
+    at::Tensor tensor =
+        at::empty(entry.sizes, at::TensorOptions(entry.scalar_type));
+    XLA_CHECK_EQ(tensor.numel() * tensor.element_size(), entry.size);
+    shard->seekg(entry.offset);
+    shard->read(static_cast<char*>(tensor.data_ptr()), entry.size);
+    XLA_CHECK(*shard) << "Failed to read checkpoint shard "
+                      << GetShardPath(path, entry.shard);
+    tensors.push_back(std::move(tensor));
+  }
+  return tensors;
+}
+
+}  // namespace torch_xla
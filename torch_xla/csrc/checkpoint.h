@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "tensorflow/compiler/xla/types.h"
+#include "torch/csrc/autograd/variable.h"
+#include "torch_xla/csrc/tensor.h"
+
+namespace torch_xla {
+
+// Writes the content of the tensors as a checkpoint made of a set of shard
+// files (named <path>.shard-NNNNN) holding the raw tensor data, plus a
+// <path>.manifest file describing element type, shape and shard location of
+// each tensor. The device data is fetched in batches of at most batch_bytes
+// bytes, and the write of a batch overlaps with the fetch of the next one. A
+// new shard file is started once the current one grows beyond shard_bytes.
+void WriteCheckpoint(const std::string& path, std::vector<XLATensor>* tensors,
+                     xla::int64 batch_bytes, xla::int64 shard_bytes);
+
+// Reads back, as PyTorch CPU tensors, the content of a checkpoint written with
+// the WriteCheckpoint() API.
+std::vector<at::Tensor> ReadCheckpoint(const std::string& path);
+
+// Reads the content of a checkpoint written with the WriteCheckpoint() API
+// directly into device memory. The shard files are memory mapped, and uploaded
+// in batches of at most batch_bytes bytes, without intermediate host copies.
+std::vector<XLATensor> ReadCheckpointToDevice(const std::string& path,
+                                              const Device& device,
+                                              xla::int64 batch_bytes);
+
+}  // namespace torch_xla
@@ -1,13 +1,21 @@
 #include "torch_xla/csrc/debug_util.h"
 
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <cerrno>
+#include <cstring>
 #include <fstream>
 #include <mutex>
 #include <sstream>
 #include <unordered_set>
 
 #include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
+#include "tensorflow/compiler/xla/shape_util.h"
 #include "tensorflow/compiler/xla/xla_client/debug_macros.h"
+#include "tensorflow/compiler/xla/xla_client/metrics.h"
 #include "tensorflow/compiler/xla/xla_client/sys_util.h"
 #include "torch_xla/csrc/ir.h"
 #include "torch_xla/csrc/ir_dump_util.h"
@@ -105,6 +113,55 @@ void DebugUtil::SaveTensorsGraphInfo(
   }
 }
 
+const char* const DebugUtil::kInputsRecipe = "uniform-v1";
+
+void DebugUtil::CaptureComputation(const xla::XlaComputation& computation,
+                                   const std::string& device, size_t hash) {
+  // Only uncached graphs get here, so the environment can be read every time,
+  // allowing the capture to be turned on and off at runtime.
+  std::string capture_dir =
+      xla::sys_util::GetEnvOrdinalPath("XLA_CAPTURE_GRAPHS_DIR", "");
+  if (capture_dir.empty()) {
+    return;
+  }
+  static std::mutex lock;
+  static std::unordered_set<size_t>* captured_hashes =
+      new std::unordered_set<size_t>();
+  // The lock is held until the graph is saved, as a hash is only marked as
+  // captured once its files have been successfully written.
+  std::lock_guard<std::mutex> guard(lock);
+  if (captured_hashes->count(hash) > 0) {
+    return;
+  }
+  XLA_CHECK(::mkdir(capture_dir.c_str(), 0755) == 0 || errno == EEXIST)
+      << "Unable to create graphs capture folder " << capture_dir << ": "
+      << std::strerror(errno);
+  std::string path = absl::StrCat(capture_dir, "/graph_", hash);
+  {
+    std::ofstream proto_file(absl::StrCat(path, ".hlo.pb"),
+                             std::ios::out | std::ios::binary);
+    XLA_CHECK(computation.proto().SerializeToOstream(&proto_file))
+        << "Failed to write captured graph " << path;
+  }
+  xla::ProgramShape program_shape =
+      ConsumeValue(computation.GetProgramShape());
+  {
+    std::ofstream meta_file(absl::StrCat(path, ".meta"));
+    meta_file << "device: " << device << "\n";
+    meta_file << "seed: " << hash << "\n";
+    meta_file << "recipe: " << kInputsRecipe << "\n";
+    for (auto& shape : program_shape.parameters()) {
+      meta_file << "parameter: "
+                << xla::ShapeUtil::HumanStringWithLayout(shape) << "\n";
+    }
+    meta_file.flush();
+    XLA_CHECK(meta_file.good())
+        << "Failed to write captured graph metadata " << path;
+  }
+  captured_hashes->insert(hash);
+  XLA_COUNTER("CapturedGraphs", 1);
+}
+
 bool DebugUtil::ExperimentEnabled(const std::string& name) {
   static const std::unordered_set<std::string>* xset = LoadExperiments();
   return xset->find(name) != xset->end();
@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 
+#include "tensorflow/compiler/xla/client/xla_computation.h"
 #include "tensorflow/core/lib/gtl/array_slice.h"
 #include "torch_xla/csrc/tensor.h"
 
@@ -35,6 +36,19 @@ class DebugUtil {
       const std::vector<size_t>* indices,
       GraphFormat format = GetDefaultGraphFormat());
 
+  // The name of the recipe used by the replay_ptxla tool to generate the inputs
+  // of the captured graphs out of their seed. It must change if the way inputs
+  // are generated out of the seed changes.
+  static const char* const kInputsRecipe;
+
+  // If the environment variable XLA_CAPTURE_GRAPHS_DIR is set to a directory
+  // path, the HLO module of the computation is saved within it, together with a
+  // description of its parameters and of the seeded recipe which generates
+  // synthetic inputs for them. Computations with an already captured hash are
+  // skipped. The saved graphs can be replayed with the replay_ptxla tool.
+  static void CaptureComputation(const xla::XlaComputation& computation,
+                                 const std::string& device, size_t hash);
+
   static bool ExperimentEnabled(const std::string& name);
 };
 
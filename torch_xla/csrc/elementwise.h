@@ -19,8 +19,11 @@ xla::XlaOp BuildThreshold(const xla::XlaOp& input, const xla::XlaOp& output,
 // Computes the rectified linear unit (replace negative elements with 0).
 xla::XlaOp BuildRelu(const xla::XlaOp& input);
 
+// The seed and rng_offset are only used in training mode, see BuildRngBits().
 std::vector<xla::XlaOp> BuildRrelu(const xla::XlaOp& input, at::Scalar lower,
-                                   at::Scalar upper, bool training);
+                                   at::Scalar upper, bool training,
+                                   const xla::XlaOp& seed,
+                                   xla::int64 rng_offset);
 
 xla::XlaOp BuildRreluBackward(const xla::XlaOp& grad_output,
                               const xla::XlaOp& input, const xla::XlaOp& noise,
@@ -0,0 +1,184 @@
+#include "torch_xla/csrc/example_decoder.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "tensorflow/compiler/xla/xla_client/debug_macros.h"
+#include "tensorflow/compiler/xla/xla_client/metrics.h"
+#include "tensorflow/compiler/xla/xla_client/multi_wait.h"
+#include "tensorflow/compiler/xla/xla_client/thread_pool.h"
+#include "tensorflow/compiler/xla/xla_client/util.h"
+#include "tensorflow/core/example/example.pb.h"
+#include "tensorflow/core/example/feature.pb.h"
+
+namespace torch_xla {
+namespace {
+
+// The minimum number of examples a decoding thread is assigned.
+static const size_t kMinThreadExamples = 16;
+
+template <typename S, typename T>
+void CopyValues(const S* src, int64_t count, T* dest) {
+  for (int64_t i = 0; i < count; ++i) {
+    dest[i] = static_cast<T>(src[i]);
+  }
+}
+
+template <typename T>
+void DecodeFeatureValues(const tensorflow::Feature* feature,
+                         const ExampleFeatureSpec& spec, int64_t row_size,
+                         T* dest, int64_t* length) {
+  int64_t count = 0;
+  if (feature != nullptr) {
+    switch (feature->kind_case()) {
+      case tensorflow::Feature::kFloatList: {
+        const tensorflow::FloatList& fvalue = feature->float_list();
+        count = fvalue.value_size();
+        XLA_CHECK(count == row_size || (spec.padded && count < row_size))
+            << "Feature " << spec.name << " has " << count
+            << " values, expected " << row_size;
+        CopyValues(fvalue.value().data(), count, dest);
+      } break;
+      case tensorflow::Feature::kInt64List: {
+        const tensorflow::Int64List& ivalue = feature->int64_list();
+        count = ivalue.value_size();
+        XLA_CHECK(count == row_size || (spec.padded && count < row_size))
+            << "Feature " << spec.name << " has " << count
+            << " values, expected " << row_size;
+        CopyValues(ivalue.value().data(), count, dest);
+      } break;
+      case tensorflow::Feature::kBytesList: {
+        const tensorflow::BytesList& bvalue = feature->bytes_list();
+        XLA_CHECK_EQ(bvalue.value_size(), 1)
+            << "Only single value bytes lists are supported: " << spec.name;
+        const std::string& svalue = bvalue.value(0);
+        count = svalue.size();
+        XLA_CHECK(count == row_size || (spec.padded && count < row_size))
+            << "Feature " << spec.name << " has " << count
+            << " values, expected " << row_size;
+        CopyValues(reinterpret_cast<const uint8_t*>(svalue.data()), count,
+                   dest);
+      } break;
+      default:
+        XLA_ERROR() << "Unknown data type for feature " << spec.name;
+    }
+  } else {
+    XLA_CHECK(spec.padded) << "Missing feature " << spec.name;
+  }
+  std::fill(dest + count, dest + row_size, static_cast<T>(spec.default_value));
+  *length = count;
+}
+
+void DecodeFeature(const tensorflow::Feature* feature,
+                   const ExampleFeatureSpec& spec, size_t index,
+                   at::Tensor* values, int64_t* length) {
+  int64_t row_size = xla::util::Multiply<int64_t>(spec.shape);
+  switch (spec.scalar_type) {
+    case at::ScalarType::Double:
+      DecodeFeatureValues(feature, spec, row_size,
+                          values->data_ptr<double>() + index * row_size,
+                          length);
+      break;
+    case at::ScalarType::Float:
+      DecodeFeatureValues(feature, spec, row_size,
+                          values->data_ptr<float>() + index * row_size,
+                          length);
+      break;
+    case at::ScalarType::BFloat16:
+      DecodeFeatureValues(feature, spec, row_size,
+                          values->data_ptr<at::BFloat16>() + index * row_size,
+                          length);
+      break;
+    case at::ScalarType::Bool:
+      DecodeFeatureValues(feature, spec, row_size,
+                          values->data_ptr<bool>() + index * row_size, length);
+      break;
+    case at::ScalarType::Byte:
+      DecodeFeatureValues(feature, spec, row_size,
+                          values->data_ptr<uint8_t>() + index * row_size,
+                          length);
+      break;
+    case at::ScalarType::Char:
+      DecodeFeatureValues(feature, spec, row_size,
+                          values->data_ptr<int8_t>() + index * row_size,
+                          length);
+      break;
+    case at::ScalarType::Short:
+      DecodeFeatureValues(feature, spec, row_size,
+                          values->data_ptr<int16_t>() + index * row_size,
+                          length);
+      break;
+    case at::ScalarType::Int:
+      DecodeFeatureValues(feature, spec, row_size,
+                          values->data_ptr<int32_t>() + index * row_size,
+                          length);
+      break;
+    case at::ScalarType::Long:
+      DecodeFeatureValues(feature, spec, row_size,
+                          values->data_ptr<int64_t>() + index * row_size,
+                          length);
+      break;
+    default:
+      XLA_ERROR() << "Feature type not supported: " << spec.scalar_type;
+  }
+}
+
+void DecodeExampleRange(const std::vector<std::string>& records,
+                        const std::vector<ExampleFeatureSpec>& specs,
+                        size_t start, size_t end, DecodedExamples* decoded) {
+  tensorflow::Example exmsg;
+  for (size_t i = start; i < end; ++i) {
+    XLA_CHECK(exmsg.ParseFromString(records[i]))
+        << "Unable to parse TF example at index " << i;
+    const auto& features = exmsg.features().feature();
+    for (size_t j = 0; j < specs.size(); ++j) {
+      auto it = features.find(specs[j].name);
+      int64_t length = 0;
+      DecodeFeature(it != features.end() ? &it->second : nullptr, specs[j], i,
+                    &decoded->values[j], &length);
+      if (decoded->lengths[j].defined()) {
+        decoded->lengths[j].data_ptr<int64_t>()[i] = length;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+DecodedExamples DecodeExamples(const std::vector<std::string>& records,
+                               const std::vector<ExampleFeatureSpec>& specs) {
+  XLA_TIMED("DecodeExamplesTime");
+  int64_t num_examples = records.size();
+  DecodedExamples decoded;
+  for (auto& spec : specs) {
+    std::vector<int64_t> sizes({num_examples});
+    sizes.insert(sizes.end(), spec.shape.begin(), spec.shape.end());
+    decoded.values.push_back(
+        at::empty(sizes, at::TensorOptions(spec.scalar_type)));
+    decoded.lengths.push_back(
+        spec.padded ? at::empty({num_examples}, at::TensorOptions(at::kLong))
+                    : at::Tensor());
+  }
+  // Every example writes to its own slice of the output tensors, so the
+  // example ranges can be decoded concurrently.
+  size_t max_parts =
+      std::max<size_t>(std::thread::hardware_concurrency() / 2, 1);
+  size_t part_size = std::max<size_t>(
+      (records.size() + max_parts - 1) / max_parts, kMinThreadExamples);
+  size_t num_parts = (records.size() + part_size - 1) / part_size;
+  xla::util::MultiWait mwait(num_parts);
+  for (size_t i = 0; i < num_parts; ++i) {
+    auto decode_fn = [&, i]() {
+      size_t start = i * part_size;
+      DecodeExampleRange(records, specs, start,
+                         std::min(start + part_size, records.size()),
+                         &decoded);
+    };
+    xla::env::ScheduleClosure(mwait.Completer(std::move(decode_fn)));
+  }
+  mwait.Wait();
+  XLA_COUNTER("DecodedExamples", num_examples);
+  return decoded;
+}
+
+}  // namespace torch_xla
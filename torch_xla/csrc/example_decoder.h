@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "torch/csrc/autograd/variable.h"
+
+namespace torch_xla {
+
+// Describes how a tf.Example feature is decoded into a dense tensor.
+struct ExampleFeatureSpec {
+  std::string name;
+  at::ScalarType scalar_type = at::ScalarType::Float;
+  // The per example shape of the feature.
+  std::vector<int64_t> shape;
+  // If true, an example can carry fewer values than the ones the shape holds
+  // (including none at all, if the feature is missing), and the remaining ones
+  // are set to default_value. Otherwise the number of values must match.
+  bool padded = false;
+  double default_value = 0;
+};
+
+struct DecodedExamples {
+  // For each feature spec, a [N] + spec.shape tensor, with N being the number
+  // of decoded examples.
+  std::vector<at::Tensor> values;
+  // For each padded feature spec, a [N] kLong tensor with the number of values
+  // carried by each example. Undefined tensors for non padded ones.
+  std::vector<at::Tensor> lengths;
+};
+
+// Parses the serialized tf.Example records in parallel, writing the feature
+// values directly into batched tensors preallocated according to the specs.
+// Float, int64 and single value bytes lists are supported, and their values
+// are converted to the element type requested by the spec.
+DecodedExamples DecodeExamples(const std::vector<std::string>& records,
+                               const std::vector<ExampleFeatureSpec>& specs);
+
+}  // namespace torch_xla
@@ -0,0 +1,109 @@
+#include "torch_xla/csrc/fallback_tracker.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/compiler/xla/xla_client/metrics.h"
+#include "tensorflow/compiler/xla/xla_client/sys_util.h"
+#include "torch_xla/csrc/python_util.h"
+
+namespace torch_xla {
+namespace {
+
+struct CallSiteStats {
+  int64_t calls = 0;
+  int64_t total_ns = 0;
+};
+
+class CallSitesArena {
+ public:
+  static CallSitesArena* Get() {
+    static CallSitesArena* arena = new CallSitesArena();
+    return arena;
+  }
+
+  void Add(const std::string& name, const std::string& location,
+           int64_t time_ns) {
+    std::lock_guard<std::mutex> lock(lock_);
+    CallSiteStats& stats = stats_[std::make_pair(name, location)];
+    stats.calls += 1;
+    stats.total_ns += time_ns;
+  }
+
+  std::string CreateReport() {
+    std::vector<std::pair<const Key*, const CallSiteStats*>> call_sites;
+    std::lock_guard<std::mutex> lock(lock_);
+    for (auto& key_stats : stats_) {
+      call_sites.emplace_back(&key_stats.first, &key_stats.second);
+    }
+    std::sort(call_sites.begin(), call_sites.end(),
+              [](const std::pair<const Key*, const CallSiteStats*>& s1,
+                 const std::pair<const Key*, const CallSiteStats*>& s2) {
+                return s1.second->total_ns > s2.second->total_ns;
+              });
+    std::stringstream ss;
+    for (auto& key_stats : call_sites) {
+      ss << "Fallback: " << key_stats.first->first << std::endl;
+      ss << "  CallSite: " << key_stats.first->second << std::endl;
+      ss << "  Calls: " << key_stats.second->calls << std::endl;
+      ss << "  TotalTime: "
+         << xla::metrics::MetricFnTime(key_stats.second->total_ns)
+         << std::endl;
+    }
+    return ss.str();
+  }
+
+  void Reset() {
+    std::lock_guard<std::mutex> lock(lock_);
+    stats_.clear();
+  }
+
+ private:
+  // The (operation name, call site) pair.
+  using Key = std::pair<std::string, std::string>;
+
+  std::mutex lock_;
+  std::map<Key, CallSiteStats> stats_;
+};
+
+thread_local int g_fallback_depth = 0;
+
+std::string GetCallSite() {
+  c10::optional<SourceLocation> location = GetPythonFrameTop();
+  if (!location) {
+    return "<unknown>";
+  }
+  return absl::StrCat(location->function, " (", location->file, ":",
+                      location->line, ")");
+}
+
+}  // namespace
+
+FallbackTracker::Scope::Scope(const char* name) {
+  if (g_fallback_depth++ == 0) {
+    name_ = name;
+    start_ns_ = xla::sys_util::NowNs();
+  }
+}
+
+FallbackTracker::Scope::~Scope() {
+  --g_fallback_depth;
+  if (name_ != nullptr) {
+    // Fetching the Python frame costs microseconds, which are negligible
+    // compared to the cost of a CPU fallback.
+    CallSitesArena::Get()->Add(name_, GetCallSite(),
+                               xla::sys_util::NowNs() - start_ns_);
+  }
+}
+
+std::string FallbackTracker::CreateReport() {
+  return CallSitesArena::Get()->CreateReport();
+}
+
+void FallbackTracker::Reset() { CallSitesArena::Get()->Reset(); }
+
+}  // namespace torch_xla
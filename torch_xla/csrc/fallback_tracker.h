@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace torch_xla {
+
+// Tracks the ATen operations executed by the CPU fallbacks, aggregating their
+// count and wall time by operation and Python call site.
+class FallbackTracker {
+ public:
+  // Accounts the time spent within its C++ scope to the given fallback
+  // operation, at the current Python call site. Nested fallbacks are accounted
+  // to the outer one.
+  class Scope {
+   public:
+    explicit Scope(const char* name);
+
+    ~Scope();
+
+   private:
+    const char* name_ = nullptr;
+    int64_t start_ns_ = 0;
+  };
+
+  // Creates a report of the fallbacks call sites, sorted by total time.
+  static std::string CreateReport();
+
+  static void Reset();
+};
+
+}  // namespace torch_xla
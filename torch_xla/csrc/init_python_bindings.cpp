@@ -11,17 +11,23 @@
 #include "tensorflow/compiler/xla/xla_client/computation_client.h"
 #include "tensorflow/compiler/xla/xla_client/metrics.h"
 #include "tensorflow/compiler/xla/xla_client/record_reader.h"
+#include "tensorflow/compiler/xla/xla_client/tracer.h"
 #include "tensorflow/compiler/xla/xla_client/util.h"
 #include "tensorflow/core/example/example.pb.h"
 #include "tensorflow/core/example/feature.pb.h"
+#include "torch/csrc/Dtype.h"
 #include "torch/csrc/autograd/utils/wrap_outputs.h"
 #include "torch/csrc/autograd/variable.h"
 #include "torch_xla/csrc/aten_xla_bridge.h"
 #include "torch_xla/csrc/aten_xla_type.h"
+#include "torch_xla/csrc/checkpoint.h"
 #include "torch_xla/csrc/device.h"
+#include "torch_xla/csrc/example_decoder.h"
+#include "torch_xla/csrc/fallback_tracker.h"
 #include "torch_xla/csrc/helpers.h"
 #include "torch_xla/csrc/ir_dump_util.h"
 #include "torch_xla/csrc/ir_util.h"
+#include "torch_xla/csrc/op_profiler.h"
 #include "torch_xla/csrc/ops/token.h"
 #include "torch_xla/csrc/python_util.h"
 #include "torch_xla/csrc/tensor_impl.h"
@@ -143,6 +149,54 @@ void SyncTensors(const std::vector<at::Tensor>& tensors,
   XLATensor::SyncTensorsGraph(&xtensors, devices, wait, sync_xla_data);
 }
 
+XLATensor::TensorsFuture GetTensorsAsync(
+    const std::vector<at::Tensor>& tensors) {
+  std::vector<XLATensor> xtensors = GetXlaTensors(tensors, /*want_all=*/true);
+  return XLATensor::GetTensorsAsync(&xtensors);
+}
+
+std::vector<at::Tensor> WaitTensorsFuture(XLATensor::TensorsFuture* future) {
+  future->Wait();
+  std::vector<at::Tensor> result;
+  for (auto& tensor : future->GetValue()) {
+    result.push_back(torch::autograd::make_variable(tensor));
+  }
+  return result;
+}
+
+void SaveCheckpoint(const std::string& path,
+                    const std::vector<at::Tensor>& tensors,
+                    xla::int64 batch_bytes, xla::int64 shard_bytes) {
+  std::vector<XLATensor> xtensors = GetXlaTensors(tensors, /*want_all=*/true);
+  WriteCheckpoint(path, &xtensors, batch_bytes, shard_bytes);
+}
+
+std::vector<at::Tensor> LoadCheckpoint(const std::string& path) {
+  std::vector<at::Tensor> result;
+  for (auto& tensor : ReadCheckpoint(path)) {
+    result.push_back(torch::autograd::make_variable(tensor));
+  }
+  return result;
+}
+
+std::vector<at::Tensor> LoadCheckpointToDevice(const std::string& path,
+                                               const std::string& device_str,
+                                               xla::int64 batch_bytes) {
+  Device device = bridge::AtenDeviceToXlaDevice(c10::Device(device_str));
+  std::vector<at::Tensor> result;
+  for (auto& xtensor : ReadCheckpointToDevice(path, device, batch_bytes)) {
+    result.push_back(torch::autograd::make_variable(
+        bridge::AtenFromXlaTensor(std::move(xtensor))));
+  }
+  return result;
+}
+
+void SyncTensorsClosure(const std::vector<at::Tensor>& tensors,
+                        const std::vector<std::string>& devices, bool wait) {
+  std::vector<XLATensor> xtensors = GetXlaTensors(tensors, /*want_all=*/false);
+  XLATensor::SyncTensorsClosureGraph(&xtensors, devices, wait);
+}
+
 void SyncLiveTensors(const std::string& device_str,
                      const std::vector<std::string>& devices, bool wait) {
   auto opt_device = GetOptionalDevice(device_str);
@@ -158,6 +212,16 @@ void StepMarker(const std::string& device_str,
   XLATensor::MarkStep(device);
 }
 
+void SetRngSeed(xla::uint64 seed, const std::string& device_str) {
+  auto opt_device = GetOptionalDevice(device_str);
+  XLATensor::SetRngSeed(opt_device ? &opt_device.value() : nullptr, seed);
+}
+
+xla::uint64 GetRngSeed(const std::string& device_str) {
+  return XLATensor::GetRunningSeed(bridge::AtenDeviceToXlaDevice(
+      c10::Device(device_str.empty() ? GetCurrentDevice() : device_str)));
+}
+
 std::string GetTensorsHloGraph(const std::vector<at::Tensor>& tensors) {
   std::vector<XLATensor> xtensors = GetXlaTensors(tensors, /*want_all=*/false);
   return XLATensor::DumpHloComputation(xtensors);
@@ -260,6 +324,28 @@ bool RecordRead(const std::shared_ptr<xla::util::RecordReader>& reader,
   return reader->Read(value);
 }
 
+std::shared_ptr<xla::util::InterleavedRecordReader>
+CreateInterleavedRecordReader(
+    const std::vector<std::string>& paths,
+    const xla::util::InterleavedRecordReader::Options& options) {
+  return std::make_shared<xla::util::InterleavedRecordReader>(paths, options);
+}
+
+py::list InterleavedRecordReadBatch(
+    const std::shared_ptr<xla::util::InterleavedRecordReader>& reader,
+    size_t max_records) {
+  std::vector<std::string> records;
+  {
+    NoGilSection nogil;
+    reader->ReadBatch(max_records, &records);
+  }
+  py::list result;
+  for (auto& record : records) {
+    result.append(py::bytes(record));
+  }
+  return result;
+}
+
 py::object RecordReadExample(
     const std::shared_ptr<xla::util::RecordReader>& reader) {
   auto make_r1_size = [](int64_t size) -> std::vector<int64_t> {
@@ -323,6 +409,57 @@ py::object RecordReadExample(
   return example;
 }
 
+std::vector<ExampleFeatureSpec> ParseFeatureSpecs(const py::list& py_specs) {
+  std::vector<ExampleFeatureSpec> specs;
+  for (auto& py_spec : py_specs) {
+    py::tuple spec_tuple = py_spec.cast<py::tuple>();
+    XLA_CHECK_EQ(spec_tuple.size(), 5)
+        << "Feature specs must be (name, dtype, shape, padded, default_value)";
+    ExampleFeatureSpec spec;
+    spec.name = spec_tuple[0].cast<std::string>();
+    PyObject* dtype = spec_tuple[1].ptr();
+    XLA_CHECK(THPDtype_Check(dtype))
+        << "Invalid dtype for feature " << spec.name;
+    spec.scalar_type = reinterpret_cast<THPDtype*>(dtype)->scalar_type;
+    spec.shape = spec_tuple[2].cast<std::vector<int64_t>>();
+    spec.padded = spec_tuple[3].cast<bool>();
+    spec.default_value = spec_tuple[4].cast<double>();
+    specs.push_back(std::move(spec));
+  }
+  return specs;
+}
+
+py::tuple DecodeTfExamples(const std::vector<std::string>& records,
+                           const py::list& py_specs,
+                           const std::string& device) {
+  std::vector<ExampleFeatureSpec> specs = ParseFeatureSpecs(py_specs);
+  std::vector<at::Tensor> values;
+  std::vector<at::Tensor> lengths;
+  {
+    NoGilSection nogil;
+    DecodedExamples decoded = DecodeExamples(records, specs);
+    values = std::move(decoded.values);
+    lengths = std::move(decoded.lengths);
+    if (!device.empty()) {
+      // The upload converts the batches to the device layout while populating
+      // the transfer buffers.
+      std::vector<std::string> devices(values.size(), device);
+      values = GetXlaTensorsFromAten(values, devices);
+    }
+  }
+  py::list py_values;
+  py::list py_lengths;
+  for (size_t i = 0; i < values.size(); ++i) {
+    py_values.append(torch::autograd::make_variable(values[i]));
+    if (lengths[i].defined()) {
+      py_lengths.append(torch::autograd::make_variable(lengths[i]));
+    } else {
+      py_lengths.append(py::none());
+    }
+  }
+  return py::make_tuple(py_values, py_lengths);
+}
+
 void InitXlaModuleBindings(py::module m) {
   m.def("_initialize_aten_bindings",
         []() { AtenXlaType::InitializeAtenBindings(); });
@@ -420,6 +557,51 @@ void InitXlaModuleBindings(py::module m) {
         },
         py::arg("tensors"), py::arg("devices"), py::arg("wait") = true,
         py::arg("sync_xla_data") = true);
+
+  py::class_<XLATensor::TensorsFuture>(m, "TensorsFuture")
+      .def("wait", [](XLATensor::TensorsFuture& future) {
+        std::vector<at::Tensor> result;
+        {
+          NoGilSection nogil;
+          result = WaitTensorsFuture(&future);
+        }
+        return result;
+      });
+  m.def("_xla_get_tensors_async",
+        [](const std::vector<at::Tensor>& tensors) {
+          NoGilSection nogil;
+          return GetTensorsAsync(tensors);
+        },
+        py::arg("tensors"));
+  m.def("_xla_write_checkpoint",
+        [](const std::string& path, const std::vector<at::Tensor>& tensors,
+           xla::int64 batch_bytes, xla::int64 shard_bytes) {
+          NoGilSection nogil;
+          SaveCheckpoint(path, tensors, batch_bytes, shard_bytes);
+        },
+        py::arg("path"), py::arg("tensors"),
+        py::arg("batch_bytes") = 256 * 1024 * 1024,
+        py::arg("shard_bytes") = 1024 * 1024 * 1024);
+  m.def("_xla_read_checkpoint", [](const std::string& path) {
+    std::vector<at::Tensor> result;
+    {
+      NoGilSection nogil;
+      result = LoadCheckpoint(path);
+    }
+    return result;
+  });
+  m.def("_xla_read_checkpoint_to_device",
+        [](const std::string& path, const std::string& device,
+           xla::int64 batch_bytes) {
+          std::vector<at::Tensor> result;
+          {
+            NoGilSection nogil;
+            result = LoadCheckpointToDevice(path, device, batch_bytes);
+          }
+          return result;
+        },
+        py::arg("path"), py::arg("device"),
+        py::arg("batch_bytes") = 256 * 1024 * 1024);
   m.def("_xla_sync_live_tensors",
         [](const std::string& device, const std::vector<std::string>& devices,
            bool wait) {
@@ -427,6 +609,13 @@ void InitXlaModuleBindings(py::module m) {
           SyncLiveTensors(device, devices, wait);
         },
         py::arg("device") = "", py::arg("devices"), py::arg("wait") = true);
+  m.def("_xla_sync_tensors_closure",
+        [](const std::vector<at::Tensor>& tensors,
+           const std::vector<std::string>& devices, bool wait) {
+          NoGilSection nogil;
+          SyncTensorsClosure(tensors, devices, wait);
+        },
+        py::arg("tensors"), py::arg("devices"), py::arg("wait") = true);
   m.def("_xla_step_marker",
         [](const std::string& device, const std::vector<std::string>& devices,
            bool wait) {
@@ -434,6 +623,14 @@ void InitXlaModuleBindings(py::module m) {
           StepMarker(device, devices, wait);
         },
         py::arg("device") = "", py::arg("devices"), py::arg("wait") = true);
+  m.def("_xla_set_rng_seed",
+        [](xla::uint64 seed, const std::string& device) {
+          SetRngSeed(seed, device);
+        },
+        py::arg("seed") = 101, py::arg("device") = "");
+  m.def("_xla_get_rng_seed",
+        [](const std::string& device) { return GetRngSeed(device); },
+        py::arg("device") = "");
   m.def("_xla_wait_device_ops",
         [](const std::vector<std::string>& devices) {
           NoGilSection nogil;
@@ -451,6 +648,26 @@ void InitXlaModuleBindings(py::module m) {
   });
   m.def("_xla_metrics_report",
         []() { return xla::metrics::CreateMetricReport(); });
+  m.def("_xla_metrics_report_json",
+        []() { return xla::metrics::CreateMetricReportJson(); });
+  m.def("_xla_set_step_metrics_deltas",
+        [](bool enabled) { xla::metrics::SetStepDeltasEnabled(enabled); });
+  m.def("_xla_last_step_metrics",
+        []() { return xla::metrics::GetLastStepDeltaJson(); });
+  m.def("_xla_set_op_profiling",
+        [](bool enabled) { OpProfiler::SetEnabled(enabled); });
+  m.def("_xla_op_profile_report",
+        [](size_t top_n) { return OpProfiler::CreateReport(top_n); },
+        py::arg("top_n") = 20);
+  m.def("_xla_reset_op_profile", []() { OpProfiler::Reset(); });
+  m.def("_xla_fallback_report",
+        []() { return FallbackTracker::CreateReport(); });
+  m.def("_xla_reset_fallback_report", []() { FallbackTracker::Reset(); });
+  m.def("_xla_set_tracing",
+        [](bool enabled) { xla::tracer::SetEnabled(enabled); });
+  m.def("_xla_is_tracing", []() { return xla::tracer::IsEnabled(); });
+  m.def("_xla_dump_trace", []() { return xla::tracer::DumpChromeTrace(); });
+  m.def("_xla_clear_trace", []() { xla::tracer::ClearEvents(); });
   m.def("_xla_tensors_report",
         [](size_t nodes_threshold, const std::string& device) {
           return GetLiveTensorsReport(nodes_threshold, device);
@@ -483,6 +700,43 @@ void InitXlaModuleBindings(py::module m) {
         }
         return py::bytes(record);
       });
+  py::class_<xla::util::InterleavedRecordReader,
+             std::shared_ptr<xla::util::InterleavedRecordReader>>(
+      m, "InterleavedRecordReader");
+  m.def("_xla_create_interleaved_tfrecord_reader",
+        [](const std::vector<std::string>& paths,
+           const std::string& compression, xla::int64 buffer_size,
+           xla::int64 cycle_length, xla::int64 block_length,
+           xla::int64 prefetch_records, xla::int64 shard_ordinal,
+           xla::int64 num_shards) {
+          xla::util::InterleavedRecordReader::Options options;
+          options.compression = compression;
+          options.buffer_size = buffer_size;
+          options.cycle_length = cycle_length;
+          options.block_length = block_length;
+          options.prefetch_records = prefetch_records;
+          options.shard_ordinal = shard_ordinal;
+          options.num_shards = num_shards;
+          NoGilSection nogil;
+          return CreateInterleavedRecordReader(paths, options);
+        },
+        py::arg("paths"), py::arg("compression") = "",
+        py::arg("buffer_size") = 16 * 1024 * 1024,
+        py::arg("cycle_length") = 8, py::arg("block_length") = 1,
+        py::arg("prefetch_records") = 256, py::arg("shard_ordinal") = 0,
+        py::arg("num_shards") = 1);
+  m.def("_xla_interleaved_tfrecord_read",
+        [](const std::shared_ptr<xla::util::InterleavedRecordReader>& reader,
+           size_t max_records) {
+          return InterleavedRecordReadBatch(reader, max_records);
+        },
+        py::arg("reader"), py::arg("max_records") = 1);
+  m.def("_xla_decode_tfexamples",
+        [](const std::vector<std::string>& records, const py::list& specs,
+           const std::string& device) {
+          return DecodeTfExamples(records, specs, device);
+        },
+        py::arg("records"), py::arg("specs"), py::arg("device") = "");
   m.def("_xla_tfexample_read",
         [](const std::shared_ptr<xla::util::RecordReader>& reader) {
           return RecordReadExample(reader);
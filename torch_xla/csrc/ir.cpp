@@ -9,6 +9,7 @@
 #include "tensorflow/compiler/xla/xla_client/sys_util.h"
 #include "tensorflow/compiler/xla/xla_client/util.h"
 #include "torch_xla/csrc/lowering_context.h"
+#include "torch_xla/csrc/op_profiler.h"
 
 namespace torch_xla {
 namespace ir {
@@ -250,6 +251,7 @@ size_t Node::GetOpHash(OpKind op, const xla::Shape& shape, size_t hash_seed) {
 }
 
 xla::Shape Node::GetOpShape(const std::function<xla::Shape()>& shape_fn) const {
+  XLA_OP_PROFILE_PHASE(OpProfiler::kShapeInference);
   ShapeCache* shape_cache = GetShapeCache();
   auto shape = shape_cache->Get(hash());
   if (shape == nullptr) {
@@ -201,6 +201,12 @@ class Node {
 
   const Output& operand(size_t i) const { return operands_as_outputs_.at(i); }
 
+  // Same as operand(), but returning a value which holds a reference on the
+  // operand node, to be used when building new IR nodes out of it.
+  Value operand_value(size_t i) const {
+    return Value(operands_.at(i), operands_as_outputs_.at(i).index);
+  }
+
   const std::set<Use>& uses() const { return uses_; }
 
   size_t node_hash() const { return node_hash_; }
@@ -1,16 +1,26 @@
 #include "torch_xla/csrc/layout_manager.h"
 
+#include <unistd.h>
+
 #include <algorithm>
+#include <cstdio>
 #include <exception>
+#include <fstream>
 #include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <set>
+#include <sstream>
 #include <string>
 #include <unordered_map>
 
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
 #include "tensorflow/compiler/xla/shape_util.h"
 #include "tensorflow/compiler/xla/xla_client/debug_macros.h"
+#include "tensorflow/compiler/xla/xla_client/metrics.h"
 #include "tensorflow/compiler/xla/xla_client/sys_util.h"
 #include "tensorflow/compiler/xla/xla_client/tf_logging.h"
 #include "tensorflow/compiler/xla/xla_client/util.h"
@@ -31,6 +41,55 @@ class LayoutManager {
     return it != layouts_.end() ? &it->second->layout : nullptr;
   }
 
+  bool IsRecording() const { return recording_; }
+
+  // The recorded layouts are only used by the next runs, which load them from
+  // the profile file, so that the layouts map does not need to be locked.
+  void RecordLayout(tensorflow::gtl::ArraySlice<const xla::int64> dimensions,
+                    tensorflow::gtl::ArraySlice<const xla::int64> layout) {
+    std::vector<xla::int64> dims(dimensions.begin(), dimensions.end());
+    std::vector<xla::int64> dims_layout(layout.begin(), layout.end());
+    std::lock_guard<std::mutex> lock(lock_);
+    LayoutVotes& votes = votes_[dims];
+    size_t count = ++votes.counts[dims_layout];
+    if (count > votes.best_count) {
+      votes.best_count = count;
+      std::vector<xla::int64>& profile_layout = profile_[dims];
+      if (profile_layout != dims_layout) {
+        profile_layout = std::move(dims_layout);
+        profile_dirty_ = true;
+      }
+    }
+  }
+
+  void SaveProfile() {
+    std::lock_guard<std::mutex> lock(lock_);
+    if (!profile_dirty_ || profile_path_.empty()) {
+      return;
+    }
+    // The profile is written to a temporary file which is then renamed into
+    // place, so that readers never observe a partially written profile. The
+    // temporary name is unique to the process, as multiple processes might be
+    // saving the same profile.
+    std::string tmp_path = absl::StrCat(profile_path_, ".tmp.", getpid());
+    {
+      std::ofstream profile_file(tmp_path);
+      XLA_CHECK(profile_file)
+          << "Unable to create the layouts profile file: " << tmp_path;
+      for (auto& dims_layout : profile_) {
+        profile_file << absl::StrJoin(dims_layout.first, ",") << "="
+                     << absl::StrJoin(dims_layout.second, ",") << "\n";
+      }
+      profile_file.close();
+      XLA_CHECK(profile_file)
+          << "Failed to write the layouts profile file: " << tmp_path;
+    }
+    XLA_CHECK_EQ(std::rename(tmp_path.c_str(), profile_path_.c_str()), 0)
+        << "Unable to rename " << tmp_path << " to " << profile_path_;
+    profile_dirty_ = false;
+    XLA_COUNTER("LayoutProfileSaves", 1);
+  }
+
  private:
   struct LayoutEntry {
     std::vector<xla::int64> dimensions;
@@ -48,35 +107,65 @@ class LayoutManager {
       std::unordered_map<tensorflow::gtl::ArraySlice<const xla::int64>,
                          std::shared_ptr<LayoutEntry>, DimensionsHasher>;
 
-  LayoutManager() {
+  struct LayoutVotes {
+    std::map<std::vector<xla::int64>, size_t> counts;
+    size_t best_count = 0;
+  };
+
+  LayoutManager()
+      : profile_path_(xla::sys_util::GetEnvString("XLA_LAYOUTS_PROFILE", "")),
+        recording_(
+            xla::sys_util::GetEnvBool("XLA_LAYOUTS_PROFILE_RECORD", false)) {
     try {
-      PopulateLayouts();
+      PopulateLayouts(xla::sys_util::GetEnvString("XLA_LAYOUTS", ""), ';');
+      PopulateProfileLayouts();
     } catch (const std::exception& ex) {
       TF_LOG(FATAL) << "Exception caught while parsing XLA layouts: "
                     << ex.what();
     }
   }
 
-  void PopulateLayouts() {
-    // Layouts: SHAPE=LAYOUT;...
-    // SHAPE: INT,...
-    // LAYOUT: INT,...
-    std::string layouts_env = xla::sys_util::GetEnvString("XLA_LAYOUTS", "");
-    if (!layouts_env.empty()) {
-      std::vector<std::string> layouts = absl::StrSplit(layouts_env, ';');
-      for (const auto& layout_str : layouts) {
-        std::vector<std::string> parts = absl::StrSplit(layout_str, '=');
-        XLA_CHECK_EQ(parts.size(), 2) << layout_str;
-
-        auto entry = std::make_shared<LayoutEntry>();
-        entry->dimensions = ParseIntList(parts[0]);
-        entry->layout = ParseLayout(parts[1], entry->dimensions.size());
-        layouts_.emplace(entry->dimensions, entry);
-
-        TF_VLOG(2) << "Registering layout " << parts[1] << " for shape "
-                   << parts[0];
-      }
+  void PopulateProfileLayouts() {
+    if (profile_path_.empty()) {
+      return;
+    }
+    std::ifstream profile_file(profile_path_);
+    if (!profile_file.is_open()) {
+      XLA_CHECK(recording_) << "Unable to open the layouts profile file: "
+                            << profile_path_;
+      return;
+    }
+    std::stringstream ss;
+    ss << profile_file.rdbuf();
+    // The layouts recorded by a profiling run have lower priority than the
+    // XLA_LAYOUTS ones, and a new recording run adds to them.
+    for (auto& entry : PopulateLayouts(ss.str(), '\n')) {
+      profile_.emplace(entry->dimensions, entry->layout);
+    }
+  }
+
+  // Layouts: SHAPE=LAYOUT<SEPARATOR>...
+  // SHAPE: INT,...
+  // LAYOUT: INT,...
+  std::vector<std::shared_ptr<LayoutEntry>> PopulateLayouts(
+      const std::string& layouts_str, char separator) {
+    std::vector<std::shared_ptr<LayoutEntry>> entries;
+    std::vector<std::string> layouts =
+        absl::StrSplit(layouts_str, separator, absl::SkipEmpty());
+    for (const auto& layout_str : layouts) {
+      std::vector<std::string> parts = absl::StrSplit(layout_str, '=');
+      XLA_CHECK_EQ(parts.size(), 2) << layout_str;
+
+      auto entry = std::make_shared<LayoutEntry>();
+      entry->dimensions = ParseIntList(parts[0]);
+      entry->layout = ParseLayout(parts[1], entry->dimensions.size());
+      layouts_.emplace(entry->dimensions, entry);
+      entries.push_back(entry);
+
+      TF_VLOG(2) << "Registering layout " << parts[1] << " for shape "
+                 << parts[0];
     }
+    return entries;
   }
 
   static std::vector<xla::int64> ParseIntList(const std::string& list_str) {
@@ -103,6 +192,12 @@ class LayoutManager {
   }
 
   LayoutMap layouts_;
+  std::string profile_path_;
+  bool recording_ = false;
+  std::mutex lock_;
+  std::map<std::vector<xla::int64>, LayoutVotes> votes_;
+  std::map<std::vector<xla::int64>, std::vector<xla::int64>> profile_;
+  bool profile_dirty_ = false;
 };
 
 double PaddingFactor(xla::int64 size, int padding) {
@@ -158,4 +253,21 @@ xla::Shape MakeArrayShapeFromDimensions(
   return MakeTorchTensorLayout(dimensions, type);
 }
 
+bool IsLayoutProfileRecording() { return LayoutManager::Get()->IsRecording(); }
+
+void RecordComputationLayouts(const xla::ProgramShape& program_shape) {
+  LayoutManager* mgr = LayoutManager::Get();
+  xla::ShapeUtil::ForEachSubshape(
+      program_shape.result(),
+      [&](const xla::Shape& subshape, const xla::ShapeIndex&) {
+        // Rank 1 shapes have a single possible layout.
+        if (subshape.IsArray() && subshape.rank() > 1 &&
+            subshape.has_layout()) {
+          mgr->RecordLayout(subshape.dimensions(),
+                            subshape.layout().minor_to_major());
+        }
+      });
+  mgr->SaveProfile();
+}
+
 }  // namespace torch_xla
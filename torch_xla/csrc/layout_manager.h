@@ -19,4 +19,17 @@ xla::Shape MakeArrayShapeFromDimensions(
     tensorflow::gtl::ArraySlice<const xla::int64> dimensions,
     xla::PrimitiveType type, DeviceType device_type);
 
+// Whether the layouts chosen by the XLA compiler for the results of the
+// compiled computations are being recorded (XLA_LAYOUTS_PROFILE_RECORD). When
+// recording, the computations should be compiled leaving the result layouts
+// unspecified, for the compiler to choose them.
+bool IsLayoutProfileRecording();
+
+// Records the layouts of the array results of a compiled computation. The most
+// frequently chosen layout for every shape is persisted into the file pointed
+// by the XLA_LAYOUTS_PROFILE environment variable, which is then used by
+// MakeArrayShapeFromDimensions() in later runs, with lower priority than the
+// XLA_LAYOUTS ones.
+void RecordComputationLayouts(const xla::ProgramShape& program_shape);
+
 }  // namespace torch_xla
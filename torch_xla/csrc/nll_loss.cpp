@@ -1,143 +1,135 @@
 #include "torch_xla/csrc/nll_loss.h"
 
 #include "tensorflow/compiler/xla/client/lib/constants.h"
+#include "tensorflow/compiler/xla/client/lib/slicing.h"
+#include "tensorflow/compiler/xla/xla_client/debug_macros.h"
 #include "tensorflow/core/lib/gtl/array_slice.h"
-#include "torch_xla/csrc/data_ops.h"
 #include "torch_xla/csrc/helpers.h"
+#include "torch_xla/csrc/softmax_builder.h"
 #include "torch_xla/csrc/tensor_util.h"
 
 namespace torch_xla {
 namespace {
 
+const int kClassesAxis = 1;
+
 struct WeightScale {
+  // The weight of every sample, which is zero for the ignored ones.
   xla::XlaOp weight;
+  // The sum of the samples weight, used by the mean reduction.
   xla::XlaOp scale;
 };
 
-// Build a iota tensor populated with values 0 through depth - 1, with the
-// exception of ignore_index which is set to -1 (if between 0 and depth - 1).
-// This allows the ignored index to be ignored by the one-hot conversion.
-xla::XlaOp OneHotIota(xla::XlaBuilder* builder, xla::int64 depth, int axis,
-                      const xla::Shape& indices_shape, int ignore_index) {
-  int indices_dims = indices_shape.rank();
-  std::vector<xla::int64> linspace_dims(indices_dims + 1, 1);
-  linspace_dims[axis] = depth;
-  xla::Shape linspace_xla_shape = xla::ShapeUtil::MakeShapeWithDescendingLayout(
-      indices_shape.element_type(), linspace_dims);
-  xla::XlaOp iota = xla::Iota(builder, linspace_xla_shape, axis);
-  if (ignore_index >= 0 && ignore_index < depth) {
-    xla::XlaOp ignore_index_op =
-        xla::Broadcast(XlaHelpers::ScalarValue<xla::int64>(
-                           ignore_index, indices_shape.element_type(), builder),
-                       linspace_dims);
-    xla::XlaOp invalid_index =
-        xla::Broadcast(XlaHelpers::ScalarValue<xla::int64>(
-                           -1, indices_shape.element_type(), builder),
-                       linspace_dims);
-    iota = xla::Select(xla::Eq(iota, ignore_index_op), invalid_index, iota);
-  }
-  return iota;
+// Clamps the labels within the classes range, to make them safe indices. The
+// ignored labels, which can be outside such range, are masked by the weights.
+xla::XlaOp ClampLabels(const xla::XlaOp& labels, xla::int64 num_classes) {
+  xla::PrimitiveType type = XlaHelpers::TypeOfXlaOp(labels);
+  xla::XlaOp zero = xla::Zero(labels.builder(), type);
+  xla::XlaOp max_label = XlaHelpers::ScalarValue<xla::int64>(
+      num_classes - 1, type, labels.builder());
+  return xla::Clamp(zero, labels, max_label);
 }
 
-// Converts "indices" into a one-hot representation. "depth" is the size of the
-// new axis to add. "axis" is the position at which to add the new axis.
-// "on_value" and "off_value" represent the values to use for the on and off
-// positions, respectively. If "ignore_index" is a valid class, it'll be
-// considered off.
-xla::XlaOp LabelsToOneHot(xla::XlaBuilder* builder, xla::int64 depth, int axis,
-                          const xla::XlaOp& indices, const xla::XlaOp& on_value,
-                          const xla::XlaOp& off_value, int ignore_index) {
-  const xla::Shape& indices_shape = XlaHelpers::ShapeOfXlaOp(indices);
-
-  // Expand the labels with a depth dimension for the classes.
-  std::vector<xla::int64> output_dimensions(indices_shape.dimensions().begin(),
-                                            indices_shape.dimensions().end());
-  output_dimensions.insert(output_dimensions.begin() + axis, depth);
-
-  xla::XlaOp iota = OneHotIota(/*builder=*/builder, /*depth=*/depth,
-                               /*axis=*/axis, /*indices_shape=*/indices_shape,
-                               /*ignore_index=*/ignore_index);
-
-  // Now compare the labels in index form to the iota tensor to get the one hot
-  // format.
-  std::vector<xla::int64> broadcast_dims(indices_shape.rank());
-  std::iota(broadcast_dims.begin(), broadcast_dims.begin() + axis, 0);
-  std::iota(broadcast_dims.begin() + axis, broadcast_dims.end(), axis + 1);
-  xla::XlaOp one_hot_bool = xla::Eq(indices, iota, broadcast_dims);
-
-  // Selects the user-provided off_value and on_value values.
-  return xla::Select(one_hot_bool, xla::Broadcast(on_value, output_dimensions),
-                     xla::Broadcast(off_value, output_dimensions));
-}
-
-WeightScale GetMaskedWeight(const absl::optional<xla::XlaOp>& weight,
-                            const xla::Shape& logits_shape,
-                            const xla::XlaOp& labels,
-                            const xla::XlaOp& one_hot_labels,
-                            int ignore_index) {
+WeightScale GetSampleWeights(const absl::optional<xla::XlaOp>& weight,
+                             const xla::Shape& logits_shape,
+                             const xla::XlaOp& labels, int ignore_index) {
   const xla::Shape& labels_shape = XlaHelpers::ShapeOfXlaOp(labels);
+  xla::PrimitiveType type = logits_shape.element_type();
+  xla::XlaBuilder* builder = labels.builder();
   xla::XlaOp valid_bitmap = xla::Ne(
       labels, XlaHelpers::ScalarValue<xla::int64>(
-                  ignore_index, labels_shape.element_type(), labels.builder()));
-  xla::XlaOp xweight;
+                  ignore_index, labels_shape.element_type(), builder));
+  xla::XlaOp sample_weight;
   if (weight) {
-    xweight = xla::BroadcastInDim(*weight, logits_shape.dimensions(), {1});
+    sample_weight = xla::TorchIndexSelect(
+        *weight, ClampLabels(labels, logits_shape.dimensions(kClassesAxis)),
+        0);
   } else {
-    xweight =
-        XlaHelpers::ScalarBroadcast<float>(1.0, logits_shape, labels.builder());
+    sample_weight = XlaHelpers::ScalarBroadcast<float>(
+        1.0, type, labels_shape.dimensions(), builder);
   }
-  xla::XlaOp zeros =
-      XlaHelpers::ScalarBroadcast<float>(0.0, logits_shape, labels.builder());
-  xla::XlaOp xvalid_bitmap =
-      xla::BroadcastInDim(valid_bitmap, logits_shape.dimensions(), {0});
-  xla::XlaOp result_weight =
-      xla::Select(xvalid_bitmap, xweight, zeros) * one_hot_labels;
-
-  xla::XlaComputation add_func =
-      XlaHelpers::CreateAddComputation(logits_shape.element_type());
-  xla::XlaOp zero = xla::Zero(labels.builder(), logits_shape.element_type());
-  xla::XlaOp one = xla::One(labels.builder(), logits_shape.element_type());
-  xla::XlaOp scale = xla::ReduceAll(result_weight, zero, add_func);
+  xla::XlaOp zeros = XlaHelpers::ScalarBroadcast<float>(
+      0.0, type, labels_shape.dimensions(), builder);
+  sample_weight = xla::Select(valid_bitmap, sample_weight, zeros);
+
+  xla::XlaOp zero = xla::Zero(builder, type);
+  xla::XlaOp one = xla::One(builder, type);
+  xla::XlaOp scale = xla::ReduceAll(sample_weight, zero,
+                                    XlaHelpers::CreateAddComputation(type));
   scale = xla::Select(xla::Ne(scale, zero), scale, one);
-  return {result_weight, scale};
+  return {sample_weight, scale};
 }
 
-}  // namespace
-
-// Builds the NLLLoss for log-probabilities "logits" and class indices "labels".
-xla::XlaOp BuildNllLoss(const xla::XlaOp& logits, const xla::XlaOp& labels,
-                        const absl::optional<xla::XlaOp>& weight,
-                        int ignore_index, ReductionMode reduction_mode) {
-  const int classes_axis = 1;
+// Picks the logits[i, labels[i]] values, with a gather rather than by reducing
+// the product with the one-hot representation of the labels.
+xla::XlaOp GatherLabelLogits(const xla::XlaOp& logits,
+                             const xla::XlaOp& labels) {
   const xla::Shape& logits_shape = XlaHelpers::ShapeOfXlaOp(logits);
-  xla::XlaOp zero = xla::Zero(logits.builder(), logits_shape.element_type());
-  xla::XlaOp one = xla::One(logits.builder(), logits_shape.element_type());
-  xla::XlaOp one_hot_labels = LabelsToOneHot(
-      /*builder=*/logits.builder(),
-      /*depth=*/logits_shape.dimensions(1),
-      /*axis=*/classes_axis,
-      /*indices=*/labels,
-      /*on_value=*/one,
-      /*off_value=*/zero,
-      /*ignore_index=*/ignore_index);
-  xla::XlaOp mul = xla::Neg(one_hot_labels) * logits;
-  WeightScale weight_scale = GetMaskedWeight(weight, logits_shape, labels,
-                                             one_hot_labels, ignore_index);
-  mul = mul * weight_scale.weight;
-  xla::XlaComputation add_func =
-      XlaHelpers::CreateAddComputation(logits_shape.element_type());
+  xla::int64 batch = logits_shape.dimensions(0);
+  xla::XlaOp index = xla::Reshape(
+      ClampLabels(labels, logits_shape.dimensions(kClassesAxis)), {batch, 1});
+  return xla::Reshape(
+      xla::TorchGather(logits, index, kClassesAxis, /*sparse=*/true),
+      {batch});
+}
+
+xla::XlaOp ReduceLosses(const xla::XlaOp& losses,
+                        const WeightScale& weight_scale,
+                        ReductionMode reduction_mode) {
   if (reduction_mode == ReductionMode::kNone) {
-    return xla::Reduce(mul, zero, add_func, {classes_axis});
+    return losses;
   }
-  xla::XlaOp sum = xla::ReduceAll(mul, zero, add_func);
+  xla::PrimitiveType type = XlaHelpers::TypeOfXlaOp(losses);
+  xla::XlaOp sum = xla::ReduceAll(losses, xla::Zero(losses.builder(), type),
+                                  XlaHelpers::CreateAddComputation(type));
   if (reduction_mode == ReductionMode::kSum) {
     return sum;
   }
   return sum / weight_scale.scale;
 }
 
-// Builds the NLLLoss gradient for log-probabilities "logits" and class indices
-// "labels".
+// Returns the gradient of the loss with respect to the per sample losses.
+xla::XlaOp SampleGradients(const xla::XlaOp& grad_output,
+                           const WeightScale& weight_scale,
+                           ReductionMode reduction_mode) {
+  xla::XlaOp grad = grad_output * weight_scale.weight;
+  if (reduction_mode != ReductionMode::kMean) {
+    return grad;
+  }
+  return grad / weight_scale.scale;
+}
+
+// Returns the boolean mask of the positions selected by the labels, which is
+// fused by XLA within its consumers and never materialized.
+xla::XlaOp LabelsMask(const xla::XlaOp& labels,
+                      const xla::Shape& logits_shape) {
+  xla::XlaOp iota = xla::Iota(
+      labels.builder(),
+      xla::ShapeUtil::MakeShape(XlaHelpers::TypeOfXlaOp(labels),
+                                logits_shape.dimensions()),
+      kClassesAxis);
+  return xla::Eq(labels, iota, {0});
+}
+
+void CheckLogitsShape(const xla::Shape& logits_shape) {
+  XLA_CHECK_EQ(logits_shape.rank(), 2)
+      << "NLL loss expects (batch, classes) inputs: " << logits_shape;
+}
+
+}  // namespace
+
+xla::XlaOp BuildNllLoss(const xla::XlaOp& logits, const xla::XlaOp& labels,
+                        const absl::optional<xla::XlaOp>& weight,
+                        int ignore_index, ReductionMode reduction_mode) {
+  const xla::Shape& logits_shape = XlaHelpers::ShapeOfXlaOp(logits);
+  CheckLogitsShape(logits_shape);
+  WeightScale weight_scale =
+      GetSampleWeights(weight, logits_shape, labels, ignore_index);
+  xla::XlaOp losses =
+      xla::Neg(GatherLabelLogits(logits, labels)) * weight_scale.weight;
+  return ReduceLosses(losses, weight_scale, reduction_mode);
+}
+
 xla::XlaOp BuildNllLossBackward(const xla::XlaOp& grad_output,
                                 const xla::XlaOp& logits,
                                 const xla::XlaOp& labels,
@@ -145,32 +137,52 @@ xla::XlaOp BuildNllLossBackward(const xla::XlaOp& grad_output,
                                 const absl::optional<xla::XlaOp>& total_weight,
                                 int ignore_index,
                                 ReductionMode reduction_mode) {
-  const int classes_axis = 1;
   const xla::Shape& logits_shape = XlaHelpers::ShapeOfXlaOp(logits);
-  xla::XlaOp zero = xla::Zero(logits.builder(), logits_shape.element_type());
-  xla::XlaOp one = xla::One(logits.builder(), logits_shape.element_type());
-  xla::XlaOp one_hot_labels = LabelsToOneHot(
-      /*builder=*/logits.builder(),
-      /*depth=*/logits_shape.dimensions(1),
-      /*axis=*/classes_axis,
-      /*indices=*/labels,
-      /*on_value=*/one,
-      /*off_value=*/zero,
-      /*ignore_index=*/ignore_index);
-
-  const xla::Shape& grad_output_shape = XlaHelpers::ShapeOfXlaOp(grad_output);
-  xla::XlaOp grad = grad_output;
-  if (grad_output_shape.rank() == 1) {
-    grad = xla::BroadcastInDim(grad, logits_shape.dimensions(), {0});
-  }
-  xla::XlaOp result = xla::Neg(one_hot_labels) * grad;
-  WeightScale weight_scale = GetMaskedWeight(weight, logits_shape, labels,
-                                             one_hot_labels, ignore_index);
-  result = result * weight_scale.weight;
-  if (reduction_mode != ReductionMode::kMean) {
-    return result;
-  }
-  return result / weight_scale.scale;
+  CheckLogitsShape(logits_shape);
+  WeightScale weight_scale =
+      GetSampleWeights(weight, logits_shape, labels, ignore_index);
+  xla::XlaOp grad = SampleGradients(grad_output, weight_scale, reduction_mode);
+  xla::XlaOp zeros =
+      XlaHelpers::ScalarBroadcast<float>(0.0, logits_shape, logits.builder());
+  return xla::Select(
+      LabelsMask(labels, logits_shape),
+      xla::BroadcastInDim(xla::Neg(grad), logits_shape.dimensions(), {0}),
+      zeros);
+}
+
+xla::XlaOp BuildCrossEntropy(const xla::XlaOp& logits, const xla::XlaOp& labels,
+                             const absl::optional<xla::XlaOp>& weight,
+                             int ignore_index, ReductionMode reduction_mode) {
+  const xla::Shape& logits_shape = XlaHelpers::ShapeOfXlaOp(logits);
+  CheckLogitsShape(logits_shape);
+  WeightScale weight_scale =
+      GetSampleWeights(weight, logits_shape, labels, ignore_index);
+  xla::XlaOp losses = (BuildLogSumExp(logits, kClassesAxis) -
+                       GatherLabelLogits(logits, labels)) *
+                      weight_scale.weight;
+  return ReduceLosses(losses, weight_scale, reduction_mode);
+}
+
+xla::XlaOp BuildCrossEntropyBackward(const xla::XlaOp& grad_output,
+                                     const xla::XlaOp& logits,
+                                     const xla::XlaOp& labels,
+                                     const absl::optional<xla::XlaOp>& weight,
+                                     int ignore_index,
+                                     ReductionMode reduction_mode) {
+  const xla::Shape& logits_shape = XlaHelpers::ShapeOfXlaOp(logits);
+  CheckLogitsShape(logits_shape);
+  WeightScale weight_scale =
+      GetSampleWeights(weight, logits_shape, labels, ignore_index);
+  xla::XlaOp grad = SampleGradients(grad_output, weight_scale, reduction_mode);
+  // d(loss)/d(logits) = grad * (softmax(logits) - one_hot(labels))
+  xla::XlaOp softmax = xla::Exp(
+      xla::Sub(logits, BuildLogSumExp(logits, kClassesAxis), {0}));
+  xla::XlaOp zeros =
+      XlaHelpers::ScalarBroadcast<float>(0.0, logits_shape, logits.builder());
+  xla::XlaOp broadcast_grad =
+      xla::BroadcastInDim(grad, logits_shape.dimensions(), {0});
+  return softmax * broadcast_grad -
+         xla::Select(LabelsMask(labels, logits_shape), broadcast_grad, zeros);
 }
 
 }  // namespace torch_xla
@@ -20,4 +20,20 @@ xla::XlaOp BuildNllLossBackward(const xla::XlaOp& grad_output,
                                 const absl::optional<xla::XlaOp>& total_weight,
                                 int ignore_index, ReductionMode reduction_mode);
 
+// Builds the NLLLoss of log_softmax(logits) along the classes dimension, for
+// raw "logits" and class indices "labels". The log-probabilities are never
+// materialized, as the loss is computed as logsumexp(logits) minus the gathered
+// label logits.
+xla::XlaOp BuildCrossEntropy(const xla::XlaOp& logits, const xla::XlaOp& labels,
+                             const absl::optional<xla::XlaOp>& weight,
+                             int ignore_index, ReductionMode reduction_mode);
+
+// Builds the gradient of BuildCrossEntropy() with respect to "logits".
+xla::XlaOp BuildCrossEntropyBackward(const xla::XlaOp& grad_output,
+                                     const xla::XlaOp& logits,
+                                     const xla::XlaOp& labels,
+                                     const absl::optional<xla::XlaOp>& weight,
+                                     int ignore_index,
+                                     ReductionMode reduction_mode);
+
 }  // namespace torch_xla
@@ -0,0 +1,212 @@
+#include "torch_xla/csrc/op_profiler.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/compiler/xla/xla_client/sys_util.h"
+
+namespace torch_xla {
+
+struct OpProfiler::Frame {
+  Frame(const char* ns, const char* name)
+      : ns(ns), name(name), start_ns(xla::sys_util::NowNs()) {}
+
+  const char* ns;
+  const char* name;
+  int64_t start_ns;
+  int64_t phase_ns[kNumPhases] = {};
+  int64_t transfer_bytes = 0;
+  bool in_phase = false;
+};
+
+namespace {
+
+struct OpStats {
+  int64_t calls = 0;
+  int64_t total_ns = 0;
+  int64_t phase_ns[OpProfiler::kNumPhases] = {};
+  int64_t transfer_bytes = 0;
+};
+
+class OpStatsArena {
+ public:
+  static OpStatsArena* Get() {
+    static OpStatsArena* arena = new OpStatsArena();
+    return arena;
+  }
+
+  // Only the sampled operations reach this API, so the lock is not going to be
+  // contended at reasonable sample rates.
+  void Add(const std::string& name, int64_t total_ns, const int64_t* phase_ns,
+           int64_t transfer_bytes) {
+    std::lock_guard<std::mutex> lock(lock_);
+    OpStats& stats = stats_[name];
+    stats.calls += 1;
+    stats.total_ns += total_ns;
+    for (int i = 0; i < OpProfiler::kNumPhases; ++i) {
+      stats.phase_ns[i] += phase_ns[i];
+    }
+    stats.transfer_bytes += transfer_bytes;
+  }
+
+  std::vector<std::pair<std::string, OpStats>> GetStats() {
+    std::lock_guard<std::mutex> lock(lock_);
+    return std::vector<std::pair<std::string, OpStats>>(stats_.begin(),
+                                                        stats_.end());
+  }
+
+  void Reset() {
+    std::lock_guard<std::mutex> lock(lock_);
+    stats_.clear();
+  }
+
+ private:
+  std::mutex lock_;
+  std::map<std::string, OpStats> stats_;
+};
+
+int64_t GetSampleRate() {
+  static int64_t sample_rate = std::max<int64_t>(
+      xla::sys_util::GetEnvInt("XLA_OP_PROFILE_SAMPLE_RATE", 16), 1);
+  return sample_rate;
+}
+
+struct ThreadState {
+  OpProfiler::Frame* frame = nullptr;
+  uint64_t num_ops = 0;
+};
+
+ThreadState* GetThreadState() {
+  static thread_local ThreadState thread_state;
+  return &thread_state;
+}
+
+void EmitOpStats(const std::string& name, const OpStats& stats,
+                 std::stringstream* ss) {
+  static const char* const kPhaseNames[OpProfiler::kNumPhases] = {
+      "Bridge", "ShapeInference", "Fallback"};
+  int64_t phases_ns = 0;
+  for (int i = 0; i < OpProfiler::kNumPhases; ++i) {
+    phases_ns += stats.phase_ns[i];
+  }
+  std::vector<std::pair<const char*, int64_t>> breakdown;
+  breakdown.emplace_back("IrBuild",
+                         std::max<int64_t>(stats.total_ns - phases_ns, 0));
+  for (int i = 0; i < OpProfiler::kNumPhases; ++i) {
+    breakdown.emplace_back(kPhaseNames[i], stats.phase_ns[i]);
+  }
+  (*ss) << "Op: " << name << std::endl;
+  (*ss) << "  SampledCalls: " << stats.calls << std::endl;
+  (*ss) << "  TotalTime: " << xla::metrics::MetricFnTime(stats.total_ns)
+        << std::endl;
+  (*ss) << "  TimePerCall: "
+        << xla::metrics::MetricFnTime(stats.total_ns / stats.calls)
+        << std::endl;
+  (*ss) << "  Breakdown: ";
+  bool first = true;
+  for (auto& name_time : breakdown) {
+    if (name_time.second > 0) {
+      (*ss) << (first ? "" : "; ") << name_time.first << "="
+            << xla::metrics::MetricFnTime(name_time.second);
+      first = false;
+    }
+  }
+  (*ss) << std::endl;
+  if (stats.transfer_bytes > 0) {
+    (*ss) << "  TransferBytes: "
+          << xla::metrics::MetricFnBytes(stats.transfer_bytes) << std::endl;
+  }
+}
+
+}  // namespace
+
+std::atomic<bool> OpProfiler::enabled_(
+    xla::sys_util::GetEnvBool("XLA_OP_PROFILE", false));
+
+void OpProfiler::OpScope::Enter(const char* ns, const char* name,
+                                bool fallback) {
+  ThreadState* state = GetThreadState();
+  if (state->frame != nullptr) {
+    // Nested operations are accounted within the top level one, as kFallback
+    // phase if they are CPU fallbacks, and as IR building time otherwise.
+    if (fallback && !state->frame->in_phase) {
+      frame_ = state->frame;
+      phase_ = kFallback;
+      frame_->in_phase = true;
+      frame_->phase_ns[kFallback] -= xla::sys_util::NowNs();
+    }
+  } else if (state->num_ops++ % GetSampleRate() == 0) {
+    frame_ = new Frame(ns, name);
+    owns_frame_ = true;
+    phase_ = fallback ? kFallback : kNumPhases;
+    frame_->in_phase = fallback;
+    state->frame = frame_;
+  }
+}
+
+void OpProfiler::OpScope::Exit() {
+  int64_t now_ns = xla::sys_util::NowNs();
+  if (!owns_frame_) {
+    frame_->phase_ns[phase_] += now_ns;
+    frame_->in_phase = false;
+    return;
+  }
+  if (phase_ != kNumPhases) {
+    frame_->phase_ns[phase_] += now_ns - frame_->start_ns;
+  }
+  GetThreadState()->frame = nullptr;
+  OpStatsArena::Get()->Add(absl::StrCat(frame_->ns, frame_->name),
+                           now_ns - frame_->start_ns, frame_->phase_ns,
+                           frame_->transfer_bytes);
+  delete frame_;
+}
+
+void OpProfiler::PhaseScope::Enter(Phase phase) {
+  Frame* frame = GetThreadState()->frame;
+  if (frame != nullptr && !frame->in_phase) {
+    frame_ = frame;
+    phase_ = phase;
+    frame_->in_phase = true;
+    start_ns_ = xla::sys_util::NowNs();
+  }
+}
+
+void OpProfiler::PhaseScope::Exit() {
+  frame_->phase_ns[phase_] += xla::sys_util::NowNs() - start_ns_;
+  frame_->in_phase = false;
+}
+
+bool OpProfiler::IsProfiling() {
+  return IsEnabled() && GetThreadState()->frame != nullptr;
+}
+
+void OpProfiler::AddTransferBytes(int64_t bytes) {
+  Frame* frame = GetThreadState()->frame;
+  if (frame != nullptr) {
+    frame->transfer_bytes += bytes;
+  }
+}
+
+std::string OpProfiler::CreateReport(size_t top_n) {
+  std::vector<std::pair<std::string, OpStats>> stats =
+      OpStatsArena::Get()->GetStats();
+  std::sort(stats.begin(), stats.end(),
+            [](const std::pair<std::string, OpStats>& s1,
+               const std::pair<std::string, OpStats>& s2) {
+              return s1.second.total_ns > s2.second.total_ns;
+            });
+  std::stringstream ss;
+  ss << "SampleRate: " << GetSampleRate() << std::endl;
+  for (size_t i = 0; i < std::min(top_n, stats.size()); ++i) {
+    EmitOpStats(stats[i].first, stats[i].second, &ss);
+  }
+  return ss.str();
+}
+
+void OpProfiler::Reset() { OpStatsArena::Get()->Reset(); }
+
+}  // namespace torch_xla
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "tensorflow/compiler/xla/xla_client/metrics.h"
+
+namespace torch_xla {
+
+// Sampling profiler of the host time spent dispatching ATen operations to XLA.
+// Every XLA_OP_PROFILE_SAMPLE_RATE-th top level ATen operation issued by a
+// thread is timed, and its wall time is split among the phases below. The time
+// not accounted by any phase is reported as IR building time.
+class OpProfiler {
+ public:
+  // The profiling state of a sampled operation.
+  struct Frame;
+
+  enum Phase {
+    // Extraction of the XLA tensors out of, and wrapping into, ATen tensors.
+    kBridge,
+    // Computation (or shape cache lookup) of the IR nodes output shapes.
+    kShapeInference,
+    // Execution of ATen operations routed to the CPU fallbacks, including the
+    // data transfers between device and host.
+    kFallback,
+    kNumPhases,
+  };
+
+  // Tracks an ATen operation. Nested operations are accounted to the top level
+  // one, with the ones which are CPU fallbacks accounted as kFallback phase.
+  class OpScope {
+   public:
+    OpScope(const char* ns, const char* name, bool fallback) {
+      if (IsEnabled()) {
+        Enter(ns, name, fallback);
+      }
+    }
+
+    ~OpScope() {
+      if (frame_ != nullptr) {
+        Exit();
+      }
+    }
+
+   private:
+    void Enter(const char* ns, const char* name, bool fallback);
+
+    void Exit();
+
+    Frame* frame_ = nullptr;
+    bool owns_frame_ = false;
+    Phase phase_ = kNumPhases;
+  };
+
+  // Accounts the time spent within its C++ scope to the given phase of the
+  // operation being profiled, if any. Nested phases are accounted to the outer
+  // one.
+  class PhaseScope {
+   public:
+    explicit PhaseScope(Phase phase) {
+      if (IsEnabled()) {
+        Enter(phase);
+      }
+    }
+
+    ~PhaseScope() {
+      if (frame_ != nullptr) {
+        Exit();
+      }
+    }
+
+   private:
+    void Enter(Phase phase);
+
+    void Exit();
+
+    Frame* frame_ = nullptr;
+    Phase phase_ = kNumPhases;
+    int64_t start_ns_ = 0;
+  };
+
+  // Enabled by the XLA_OP_PROFILE environment variable.
+  static bool IsEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  static void SetEnabled(bool enabled) { enabled_.store(enabled); }
+
+  // Returns true if the calling thread is within an operation being profiled.
+  static bool IsProfiling();
+
+  // Accounts bytes transferred between host and device, to the operation being
+  // profiled by the calling thread.
+  static void AddTransferBytes(int64_t bytes);
+
+  // Creates a report of the top_n operations by total sampled time.
+  static std::string CreateReport(size_t top_n);
+
+  static void Reset();
+
+ private:
+  static std::atomic<bool> enabled_;
+};
+
+#define XLA_FN_PROFILE(ns)                                      \
+  XLA_FN_COUNTER(ns);                                           \
+  ::torch_xla::OpProfiler::OpScope __op_scope(ns, __FUNCTION__, \
+                                              /*fallback=*/false)
+
+#define XLA_OP_PROFILE_PHASE(phase) \
+  ::torch_xla::OpProfiler::PhaseScope __phase_scope(phase)
+
+}  // namespace torch_xla
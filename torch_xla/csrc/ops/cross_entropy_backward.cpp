@@ -0,0 +1,60 @@
+#include "torch_xla/csrc/ops/cross_entropy_backward.h"
+
+#include "tensorflow/compiler/xla/xla_client/util.h"
+#include "torch_xla/csrc/lowering_context.h"
+#include "torch_xla/csrc/nll_loss.h"
+#include "torch_xla/csrc/ops/xla_ops.h"
+
+namespace torch_xla {
+namespace ir {
+namespace ops {
+
+CrossEntropyBackward::CrossEntropyBackward(const Value& grad_output,
+                                           const Value& logits,
+                                           const Value& labels,
+                                           const absl::optional<Value>& weight,
+                                           ReductionMode reduction,
+                                           int ignore_index)
+    : Node(xla_cross_entropy_backward,
+           xla::util::GetValuesVector<Value>({grad_output, logits, labels},
+                                             {&weight}),
+           logits.shape(),
+           /*num_outputs=*/1,
+           xla::util::MHash(xla::util::GetEnumValue(reduction), ignore_index)),
+      reduction_(reduction),
+      ignore_index_(ignore_index) {}
+
+NodePtr CrossEntropyBackward::Clone(OpList operands) const {
+  absl::optional<Value> weight;
+  if (operands.size() > 3) {
+    weight = operands.at(3);
+  }
+  return MakeNode<CrossEntropyBackward>(operands.at(0), operands.at(1),
+                                        operands.at(2), weight, reduction_,
+                                        ignore_index_);
+}
+
+XlaOpVector CrossEntropyBackward::Lower(LoweringContext* loctx) const {
+  xla::XlaOp grad_output = loctx->GetOutputOp(operand(0));
+  xla::XlaOp logits = loctx->GetOutputOp(operand(1));
+  xla::XlaOp labels = loctx->GetOutputOp(operand(2));
+  absl::optional<xla::XlaOp> weight;
+  if (operands().size() > 3) {
+    weight = loctx->GetOutputOp(operand(3));
+  }
+  return ReturnOp(BuildCrossEntropyBackward(grad_output, logits, labels, weight,
+                                            ignore_index_, reduction_),
+                  loctx);
+}
+
+std::string CrossEntropyBackward::ToString() const {
+  std::stringstream ss;
+  ss << Node::ToString()
+     << ", reduction=" << xla::util::GetEnumValue(reduction_)
+     << ", ignore_index=" << ignore_index_;
+  return ss.str();
+}
+
+}  // namespace ops
+}  // namespace ir
+}  // namespace torch_xla
@@ -13,9 +13,11 @@
 #include "torch_xla/csrc/ops/index_get.h"
 #include "torch_xla/csrc/ops/index_put.h"
 #include "torch_xla/csrc/ops/infer_output_shape.h"
+#include "torch_xla/csrc/ops/masked_scatter.h"
 #include "torch_xla/csrc/ops/ops.h"
 #include "torch_xla/csrc/ops/permute.h"
 #include "torch_xla/csrc/ops/scalar.h"
+#include "torch_xla/csrc/ops/view.h"
 #include "torch_xla/csrc/xla_lower_util.h"
 
 namespace torch_xla {
@@ -287,6 +289,64 @@ ir::Value IndexPutByTensors(
       xla::util::ToVector<xla::int64>(result_permutation));
 }
 
+ir::Value IndexPutByMask(const XLATensor& base, const XLATensor& mask,
+                         const XLATensor& values, bool accumulate) {
+  auto base_shape_ref = base.shape();
+  const xla::Shape& base_shape = base_shape_ref.get();
+  auto mask_shape_ref = mask.shape();
+  const xla::Shape& mask_shape = mask_shape_ref.get();
+  XLA_CHECK_LE(mask_shape.rank(), base_shape.rank());
+  for (xla::int64 j = 0; j < mask_shape.rank(); ++j) {
+    XLA_CHECK_EQ(mask_shape.dimensions(j), base_shape.dimensions(j))
+        << "The shape of the mask " << mask_shape << " at index " << j
+        << " does not match the shape of the indexed tensor " << base_shape
+        << " at index " << j;
+  }
+  std::vector<xla::int64> base_dims =
+      xla::util::ToVector<xla::int64>(base_shape.dimensions());
+  // Align the mask to the leading dimensions of the base, and expand it over
+  // the trailing ones.
+  std::vector<xla::int64> mask_dims =
+      xla::util::ToVector<xla::int64>(mask_shape.dimensions());
+  mask_dims.resize(base_dims.size(), 1);
+  ir::Value expanded_mask = ir::MakeNode<ir::ops::Expand>(
+      ir::MakeNode<ir::ops::View>(mask.GetIrValue(), mask_dims), base_dims);
+
+  auto values_shape_ref = values.shape();
+  const xla::Shape& values_shape = values_shape_ref.get();
+  xla::int64 trailing_rank = base_shape.rank() - mask_shape.rank();
+  ir::Value base_value = accumulate ? XLATensor::GetIrValueForScalar(
+                                          0, base_shape, base.GetDevice())
+                                    : base.GetIrValue();
+  ir::Value update;
+  if (values_shape.rank() <= trailing_rank ||
+      (values_shape.rank() == trailing_rank + 1 &&
+       values_shape.dimensions(0) == 1)) {
+    // The same values are put at every selected position, so no count of the
+    // selected positions is needed.
+    std::vector<xla::int64> values_dims =
+        xla::util::ToVector<xla::int64>(values_shape.dimensions());
+    if (values_shape.rank() > trailing_rank) {
+      values_dims.erase(values_dims.begin());
+    }
+    ir::Value expanded_values = ir::MakeNode<ir::ops::Expand>(
+        ir::MakeNode<ir::ops::View>(values.GetIrValue(), values_dims),
+        base_dims);
+    update = ir::ops::Where(expanded_mask, expanded_values, base_value);
+  } else {
+    // The values hold one row per selected position, in row-major order of the
+    // positions. Like at::masked_scatter_(), a values tensor with more rows
+    // than the selected positions is not an error, while the caller checks
+    // that it does not hold fewer.
+    update = ir::MakeNode<ir::ops::MaskedScatter>(base_value, expanded_mask,
+                                                  values.GetIrValue());
+  }
+  if (accumulate) {
+    return base.GetIrValue() + update;
+  }
+  return update;
+}
+
 ir::NodePtr IndexFill(const XLATensor& base, xla::int64 dim,
                       const XLATensor& index, at::Scalar value) {
   XLA_CHECK_EQ(index.dtype(), at::ScalarType::Long)
@@ -62,6 +62,12 @@ ir::Value IndexPutByTensors(
     xla::int64 start_dim, const XLATensor& updates, bool accumulate,
     tensorflow::gtl::ArraySlice<const xla::int64> result_permutation);
 
+// Implements the indexed update by a boolean mask over the leading dimensions
+// of the base, as a select or a masked scatter which are lowered with static
+// shapes, instead of going through nonzero().
+ir::Value IndexPutByMask(const XLATensor& base, const XLATensor& mask,
+                         const XLATensor& values, bool accumulate);
+
 ir::NodePtr IndexFill(const XLATensor& base, xla::int64 dim,
                       const XLATensor& index, at::Scalar value);
 
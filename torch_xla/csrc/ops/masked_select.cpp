@@ -10,31 +10,38 @@ namespace ir {
 namespace ops {
 namespace {
 
-xla::Shape NodeOutputShape(const Value& input) {
+xla::Shape NodeOutputShape(const Value& input, bool dynamic) {
   const xla::Shape& input_shape = input.shape();
   xla::int64 input_elements = xla::ShapeUtil::ElementsIn(input_shape);
   xla::Shape result_shape =
       xla::ShapeUtil::MakeShape(input_shape.element_type(), {input_elements});
-  result_shape.set_dynamic_dimension(0, true);
+  result_shape.set_dynamic_dimension(0, dynamic);
   return xla::ShapeUtil::MakeTupleShape(
       {result_shape, xla::ShapeUtil::MakeShape(xla::PrimitiveType::S32, {})});
 }
 
 }  // namespace
 
-MaskedSelect::MaskedSelect(const Value& input, const Value& mask)
+MaskedSelect::MaskedSelect(const Value& input, const Value& mask, bool dynamic)
     : Node(ir::OpKind(at::aten::masked_select), {input, mask},
-           NodeOutputShape(input),
-           /*num_outputs=*/2) {}
+           NodeOutputShape(input, dynamic),
+           /*num_outputs=*/2, xla::util::MHash(dynamic)),
+      dynamic_(dynamic) {}
+
+std::string MaskedSelect::ToString() const {
+  std::stringstream ss;
+  ss << Node::ToString() << ", dynamic=" << dynamic_;
+  return ss.str();
+}
 
 NodePtr MaskedSelect::Clone(OpList operands) const {
-  return MakeNode<MaskedSelect>(operands.at(0), operands.at(1));
+  return MakeNode<MaskedSelect>(operands.at(0), operands.at(1), dynamic_);
 }
 
 XlaOpVector MaskedSelect::Lower(LoweringContext* loctx) const {
   xla::XlaOp input = loctx->GetOutputOp(operand(0));
   xla::XlaOp mask = loctx->GetOutputOp(operand(1));
-  return ReturnOps(BuildMaskedSelect(input, mask), loctx);
+  return ReturnOps(BuildMaskedSelect(input, mask, dynamic_), loctx);
 }
 
 }  // namespace ops
@@ -6,16 +6,25 @@ namespace torch_xla {
 namespace ir {
 namespace ops {
 
-// This node has no metadata, so it could have been implemented as generic-op in
-// ops.cpp, but since this might require special handling from upper IR layers,
-// it gets its own IR node class.
+// The node has two outputs, the result padded to the number of elements of the
+// input, and the count of its valid elements. If dynamic is true, the result
+// first dimension is marked as dynamic, which only some backends support.
+// Otherwise the padding elements are zeroed and the result can be consumed as
+// a static shaped tensor on any backend.
 class MaskedSelect : public Node {
  public:
-  MaskedSelect(const Value& input, const Value& mask);
+  MaskedSelect(const Value& input, const Value& mask, bool dynamic);
+
+  std::string ToString() const override;
 
   NodePtr Clone(OpList operands) const override;
 
   XlaOpVector Lower(LoweringContext* loctx) const override;
+
+  bool dynamic() const { return dynamic_; }
+
+ private:
+  bool dynamic_;
 };
 
 }  // namespace ops
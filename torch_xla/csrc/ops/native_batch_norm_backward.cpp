@@ -13,13 +13,13 @@ namespace {
 
 xla::Shape NodeOutputShape(const Value& grad_out, const Value& input,
                            const Value& weight, const Value& save_mean,
-                           const Value& save_invstd, bool training) {
+                           const Value& save_invstd) {
   auto lower_for_shape_fn =
       [&](tensorflow::gtl::ArraySlice<const xla::XlaOp> operands)
       -> xla::XlaOp {
     BatchNormGrads xla_outputs =
         BuildBatchNormBackward(operands[0], operands[1], operands[2],
-                               operands[3], operands[4], training, 0.5);
+                               operands[3], operands[4]);
     return xla::Tuple(operands[0].builder(),
                       {xla_outputs.grad_input, xla_outputs.grad_weight,
                        xla_outputs.grad_bias});
@@ -38,7 +38,7 @@ NativeBatchNormBackward::NativeBatchNormBackward(
            {grad_out, input, weight, save_mean, save_invstd},
            [&]() {
              return NodeOutputShape(grad_out, input, weight, save_mean,
-                                    save_invstd, training);
+                                    save_invstd);
            },
            /*num_outputs=*/3, xla::util::MHash(training, eps)),
       training_(training),
@@ -56,8 +56,8 @@ XlaOpVector NativeBatchNormBackward::Lower(LoweringContext* loctx) const {
   xla::XlaOp weight = loctx->GetOutputOp(operand(2));
   xla::XlaOp save_mean = loctx->GetOutputOp(operand(3));
   xla::XlaOp save_invstd = loctx->GetOutputOp(operand(4));
-  BatchNormGrads grads = BuildBatchNormBackward(
-      grad_out, input, weight, save_mean, save_invstd, training_, eps_);
+  BatchNormGrads grads =
+      BuildBatchNormBackward(grad_out, input, weight, save_mean, save_invstd);
   return ReturnOps({std::move(grads.grad_input), std::move(grads.grad_weight),
                     std::move(grads.grad_bias)},
                    loctx);
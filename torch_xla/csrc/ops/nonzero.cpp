@@ -10,29 +10,37 @@ namespace ir {
 namespace ops {
 namespace {
 
-xla::Shape NodeOutputShape(const Value& input) {
+xla::Shape NodeOutputShape(const Value& input, bool dynamic) {
   const xla::Shape& input_shape = input.shape();
   xla::int64 index_elements = xla::ShapeUtil::ElementsIn(input_shape);
   xla::Shape result_shape = xla::ShapeUtil::MakeShape(
       xla::PrimitiveType::S32, {index_elements, input_shape.rank()});
-  result_shape.set_dynamic_dimension(0, true);
+  result_shape.set_dynamic_dimension(0, dynamic);
   return xla::ShapeUtil::MakeTupleShape(
       {result_shape, xla::ShapeUtil::MakeShape(xla::PrimitiveType::S32, {})});
 }
 
 }  // namespace
 
-NonZero::NonZero(const Value& input)
-    : Node(ir::OpKind(at::aten::nonzero), {input}, NodeOutputShape(input),
-           /*num_outputs=*/2) {}
+NonZero::NonZero(const Value& input, bool dynamic)
+    : Node(ir::OpKind(at::aten::nonzero), {input},
+           NodeOutputShape(input, dynamic),
+           /*num_outputs=*/2, xla::util::MHash(dynamic)),
+      dynamic_(dynamic) {}
+
+std::string NonZero::ToString() const {
+  std::stringstream ss;
+  ss << Node::ToString() << ", dynamic=" << dynamic_;
+  return ss.str();
+}
 
 NodePtr NonZero::Clone(OpList operands) const {
-  return MakeNode<NonZero>(operands.at(0));
+  return MakeNode<NonZero>(operands.at(0), dynamic_);
 }
 
 XlaOpVector NonZero::Lower(LoweringContext* loctx) const {
   xla::XlaOp input = loctx->GetOutputOp(operand(0));
-  return ReturnOps(BuildNonZero(input), loctx);
+  return ReturnOps(BuildNonZero(input, dynamic_), loctx);
 }
 
 }  // namespace ops
@@ -594,18 +594,24 @@ NodePtr MinUnary(const Value& input) {
                    std::move(lower_fn));
 }
 
-NodePtr Bernoulli(const Value& input, const Value& probability) {
-  auto lower_fn = [](const Node& node, LoweringContext* loctx) -> XlaOpVector {
+NodePtr Bernoulli(const Value& input, const Value& probability,
+                  const Value& seed, xla::int64 rng_offset) {
+  auto lower_fn = [rng_offset](const Node& node,
+                               LoweringContext* loctx) -> XlaOpVector {
     xla::XlaOp xla_input = loctx->GetOutputOp(node.operand(0));
     xla::XlaOp xla_probability = loctx->GetOutputOp(node.operand(1));
+    xla::XlaOp xla_seed = loctx->GetOutputOp(node.operand(2));
     xla::XlaOp result =
-        BuildBernoulli(xla_probability, XlaHelpers::ShapeOfXlaOp(xla_input));
+        BuildBernoulli(xla_probability, xla_seed, rng_offset,
+                       XlaHelpers::ShapeOfXlaOp(xla_input));
     return node.ReturnOp(result, loctx);
   };
   NodePtr probability_expanded = MakeNode<Expand>(
       probability, xla::util::ToVector<xla::int64>(input.shape().dimensions()));
-  return GenericOp(OpKind(at::aten::bernoulli), {input, probability_expanded},
-                   input.shape(), std::move(lower_fn));
+  return GenericOp(OpKind(at::aten::bernoulli),
+                   {input, probability_expanded, seed}, input.shape(),
+                   std::move(lower_fn), /*num_outputs=*/1,
+                   xla::util::MHash(rng_offset));
 }
 
 NodePtr Take(const Value& input, const Value& index) {
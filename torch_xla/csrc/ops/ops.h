@@ -190,7 +190,10 @@ NodePtr MaxUnary(const Value& input);
 
 NodePtr MinUnary(const Value& input);
 
-NodePtr Bernoulli(const Value& input, const Value& probability);
+// The seed is the IR value returned by XLATensor::GetRngSeed(), together with
+// the rng_offset reserved for this operation.
+NodePtr Bernoulli(const Value& input, const Value& probability,
+                  const Value& seed, xla::int64 rng_offset);
 
 NodePtr Take(const Value& input, const Value& index);
 
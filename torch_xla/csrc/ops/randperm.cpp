@@ -8,26 +8,32 @@ namespace torch_xla {
 namespace ir {
 namespace ops {
 
-Randperm::Randperm(xla::int64 upper_bound, xla::PrimitiveType element_type)
-    : Node(ir::OpKind(at::aten::randperm), {},
+Randperm::Randperm(const Value& seed, xla::int64 upper_bound,
+                   xla::PrimitiveType element_type, xla::int64 rng_offset)
+    : Node(ir::OpKind(at::aten::randperm), {seed},
            xla::ShapeUtil::MakeShape(element_type, {upper_bound}),
            /*num_outputs=*/1,
-           xla::util::MHash(upper_bound, static_cast<int>(element_type))),
+           xla::util::MHash(upper_bound, static_cast<int>(element_type),
+                            rng_offset)),
       upper_bound_(upper_bound),
-      element_type_(element_type) {}
+      element_type_(element_type),
+      rng_offset_(rng_offset) {}
 
 NodePtr Randperm::Clone(OpList operands) const {
-  return MakeNode<Randperm>(upper_bound_, element_type_);
+  return MakeNode<Randperm>(operands.at(0), upper_bound_, element_type_,
+                            rng_offset_);
 }
 
 XlaOpVector Randperm::Lower(LoweringContext* loctx) const {
-  return ReturnOp(BuildRandperm(upper_bound_, element_type_, loctx->builder()),
-                  loctx);
+  xla::XlaOp seed = loctx->GetOutputOp(operand(0));
+  return ReturnOp(
+      BuildRandperm(upper_bound_, element_type_, seed, rng_offset_), loctx);
 }
 
 std::string Randperm::ToString() const {
   std::stringstream ss;
-  ss << Node::ToString() << ", upper_bound=" << upper_bound_;
+  ss << Node::ToString() << ", upper_bound=" << upper_bound_
+     << ", rng_offset=" << rng_offset_;
   return ss.str();
 }
 
@@ -8,7 +8,8 @@ namespace ops {
 
 class Randperm : public Node {
  public:
-  Randperm(xla::int64 upper_bound, xla::PrimitiveType element_type);
+  Randperm(const Value& seed, xla::int64 upper_bound,
+           xla::PrimitiveType element_type, xla::int64 rng_offset);
 
   std::string ToString() const override;
 
@@ -18,9 +19,12 @@ class Randperm : public Node {
 
   xla::int64 upper_bound() const { return upper_bound_; }
 
+  xla::int64 rng_offset() const { return rng_offset_; }
+
  private:
   xla::int64 upper_bound_;
   xla::PrimitiveType element_type_;
+  xla::int64 rng_offset_;
 };
 
 }  // namespace ops
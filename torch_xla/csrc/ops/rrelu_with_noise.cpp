@@ -9,29 +9,35 @@ namespace torch_xla {
 namespace ir {
 namespace ops {
 
-RreluWithNoise::RreluWithNoise(const Value& input, at::Scalar lower,
-                               at::Scalar upper, bool training)
-    : Node(ir::OpKind(at::aten::rrelu_with_noise), {input},
+RreluWithNoise::RreluWithNoise(const Value& input, const Value& seed,
+                               at::Scalar lower, at::Scalar upper,
+                               bool training, xla::int64 rng_offset)
+    : Node(ir::OpKind(at::aten::rrelu_with_noise), {input, seed},
            xla::ShapeUtil::MakeTupleShape({input.shape(), input.shape()}),
            /*num_outputs=*/2,
-           xla::util::MHash(ScalarHash(lower), ScalarHash(upper), training)),
+           xla::util::MHash(ScalarHash(lower), ScalarHash(upper), training,
+                            rng_offset)),
       lower_(std::move(lower)),
       upper_(std::move(upper)),
-      training_(training) {}
+      training_(training),
+      rng_offset_(rng_offset) {}
 
 NodePtr RreluWithNoise::Clone(OpList operands) const {
-  return MakeNode<RreluWithNoise>(operands.at(0), lower_, upper_, training_);
+  return MakeNode<RreluWithNoise>(operands.at(0), operands.at(1), lower_,
+                                  upper_, training_, rng_offset_);
 }
 
 XlaOpVector RreluWithNoise::Lower(LoweringContext* loctx) const {
   xla::XlaOp input = loctx->GetOutputOp(operand(0));
-  return ReturnOps(BuildRrelu(input, lower_, upper_, training_), loctx);
+  xla::XlaOp seed = loctx->GetOutputOp(operand(1));
+  return ReturnOps(
+      BuildRrelu(input, lower_, upper_, training_, seed, rng_offset_), loctx);
 }
 
 std::string RreluWithNoise::ToString() const {
   std::stringstream ss;
   ss << Node::ToString() << ", lower=" << lower_ << ", upper=" << upper_
-     << ", training=" << training_;
+     << ", training=" << training_ << ", rng_offset=" << rng_offset_;
   return ss.str();
 }
 
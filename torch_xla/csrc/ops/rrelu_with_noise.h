@@ -10,8 +10,8 @@ namespace ops {
 
 class RreluWithNoise : public Node {
  public:
-  RreluWithNoise(const Value& input, at::Scalar lower, at::Scalar upper,
-                 bool training);
+  RreluWithNoise(const Value& input, const Value& seed, at::Scalar lower,
+                 at::Scalar upper, bool training, xla::int64 rng_offset);
 
   std::string ToString() const override;
 
@@ -25,10 +25,13 @@ class RreluWithNoise : public Node {
 
   bool training() const { return training_; }
 
+  xla::int64 rng_offset() const { return rng_offset_; }
+
  private:
   at::Scalar lower_;
   at::Scalar upper_;
   bool training_;
+  xla::int64 rng_offset_;
 };
 
 }  // namespace ops
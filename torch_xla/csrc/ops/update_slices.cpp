@@ -0,0 +1,65 @@
+#include "torch_xla/csrc/ops/update_slices.h"
+
+#include "absl/strings/str_join.h"
+#include "tensorflow/compiler/xla/xla_client/debug_macros.h"
+#include "tensorflow/compiler/xla/xla_client/util.h"
+#include "torch_xla/csrc/lowering_context.h"
+#include "torch_xla/csrc/ops/xla_ops.h"
+#include "torch_xla/csrc/xla_lower_util.h"
+
+namespace torch_xla {
+namespace ir {
+namespace ops {
+namespace {
+
+std::vector<Value> GetOperandList(
+    const Value& input, const Value& indices,
+    tensorflow::gtl::ArraySlice<const Value> sources) {
+  std::vector<Value> operand_list;
+  operand_list.reserve(sources.size() + 2);
+  operand_list.push_back(input);
+  operand_list.push_back(indices);
+  operand_list.insert(operand_list.end(), sources.begin(), sources.end());
+  return operand_list;
+}
+
+}  // namespace
+
+UpdateSlices::UpdateSlices(const Value& input, const Value& indices,
+                           tensorflow::gtl::ArraySlice<const Value> sources,
+                           std::vector<xla::int64> sizes)
+    : Node(xla_update_slices, GetOperandList(input, indices, sources),
+           input.shape(), /*num_outputs=*/1, xla::util::MHash(sizes)),
+      sizes_(std::move(sizes)) {
+  XLA_CHECK_EQ(indices.shape().rank(), 2);
+  XLA_CHECK_EQ(indices.shape().dimensions(0),
+               static_cast<xla::int64>(sources.size()));
+  XLA_CHECK_EQ(indices.shape().dimensions(1), input.shape().rank());
+}
+
+NodePtr UpdateSlices::Clone(OpList operands) const {
+  std::vector<Value> sources(operands.begin() + 2, operands.end());
+  return MakeNode<UpdateSlices>(operands.at(0), operands.at(1), sources,
+                                sizes_);
+}
+
+XlaOpVector UpdateSlices::Lower(LoweringContext* loctx) const {
+  xla::XlaOp input = loctx->GetOutputOp(operand(0));
+  xla::XlaOp indices = loctx->GetOutputOp(operand(1));
+  std::vector<xla::XlaOp> sources;
+  for (size_t i = 2; i < operands().size(); ++i) {
+    sources.push_back(loctx->GetOutputOp(operand(i)));
+  }
+  return ReturnOp(BuildUpdateSlices(input, indices, sources, sizes_), loctx);
+}
+
+std::string UpdateSlices::ToString() const {
+  std::stringstream ss;
+  ss << Node::ToString() << ", sizes=[" << absl::StrJoin(sizes_, ", ")
+     << "], num_slices=" << operands().size() - 2;
+  return ss.str();
+}
+
+}  // namespace ops
+}  // namespace ir
+}  // namespace torch_xla
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vector>
+
+#include "tensorflow/core/lib/gtl/array_slice.h"
+#include "torch_xla/csrc/ir.h"
+
+namespace torch_xla {
+namespace ir {
+namespace ops {
+
+// Writes a sequence of equally sized, non overlapping, slices of the input.
+// The i-th source is reshaped to sizes and written at the base indices stored
+// in the i-th row of the [N, rank] indices tensor. Since the base indices are
+// carried by an operand, writes at different positions share the same graph.
+class UpdateSlices : public Node {
+ public:
+  UpdateSlices(const Value& input, const Value& indices,
+               tensorflow::gtl::ArraySlice<const Value> sources,
+               std::vector<xla::int64> sizes);
+
+  NodePtr Clone(OpList operands) const override;
+
+  XlaOpVector Lower(LoweringContext* loctx) const override;
+
+  std::string ToString() const override;
+
+  const std::vector<xla::int64>& sizes() const { return sizes_; }
+
+ private:
+  std::vector<xla::int64> sizes_;
+};
+
+}  // namespace ops
+}  // namespace ir
+}  // namespace torch_xla
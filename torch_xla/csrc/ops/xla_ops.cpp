@@ -6,6 +6,9 @@ namespace ops {
 
 const OpKindWrapper xla_as_strided_view_update("xla::as_strided_view_update");
 const OpKindWrapper xla_cast("xla::cast");
+const OpKindWrapper xla_cross_entropy("xla::cross_entropy");
+const OpKindWrapper xla_cross_entropy_backward(
+    "xla::cross_entropy_backward");
 const OpKindWrapper xla_cross_replica_sum("xla::cross_replica_sum");
 const OpKindWrapper xla_device_data("xla::device_data");
 const OpKindWrapper xla_diagonal_view_update("xla::diagonal_view_update");
@@ -18,6 +21,7 @@ const OpKindWrapper xla_tensor_data("xla::tensor_data");
 const OpKindWrapper xla_token("xla::token");
 const OpKindWrapper xla_unselect("xla::unselect");
 const OpKindWrapper xla_update_slice("xla::update_slice");
+const OpKindWrapper xla_update_slices("xla::update_slices");
 
 }  // namespace ops
 }  // namespace ir
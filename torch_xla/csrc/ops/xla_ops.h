@@ -30,6 +30,8 @@ class OpKindWrapper {
 
 extern const OpKindWrapper xla_as_strided_view_update;
 extern const OpKindWrapper xla_cast;
+extern const OpKindWrapper xla_cross_entropy;
+extern const OpKindWrapper xla_cross_entropy_backward;
 extern const OpKindWrapper xla_cross_replica_sum;
 extern const OpKindWrapper xla_device_data;
 extern const OpKindWrapper xla_diagonal_view_update;
@@ -42,6 +44,7 @@ extern const OpKindWrapper xla_tensor_data;
 extern const OpKindWrapper xla_token;
 extern const OpKindWrapper xla_unselect;
 extern const OpKindWrapper xla_update_slice;
+extern const OpKindWrapper xla_update_slices;
 
 }  // namespace ops
 }  // namespace ir
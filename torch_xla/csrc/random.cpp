@@ -0,0 +1,93 @@
+#include "torch_xla/csrc/random.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "tensorflow/compiler/xla/shape_util.h"
+#include "tensorflow/compiler/xla/xla_client/debug_macros.h"
+#include "tensorflow/compiler/xla/xla_client/util.h"
+
+namespace torch_xla {
+namespace {
+
+xla::XlaOp RotateLeft(const xla::XlaOp& value, xla::uint32 distance) {
+  xla::XlaBuilder* builder = value.builder();
+  return xla::Or(
+      xla::ShiftLeft(value, xla::ConstantR0<xla::uint32>(builder, distance)),
+      xla::ShiftRightLogical(
+          value, xla::ConstantR0<xla::uint32>(builder, 32 - distance)));
+}
+
+// Threefry-2x32 with 20 rounds, as described in "Parallel Random Numbers: As
+// Easy as 1, 2, 3" (Salmon et al. SC 2011).
+std::pair<xla::XlaOp, xla::XlaOp> Threefry2x32(const xla::XlaOp& key0,
+                                                const xla::XlaOp& key1,
+                                                xla::XlaOp x0, xla::XlaOp x1) {
+  static const xla::uint32 kRotations[2][4] = {{13, 15, 26, 6},
+                                               {17, 29, 16, 24}};
+  xla::XlaBuilder* builder = x0.builder();
+  xla::XlaOp keys[3] = {
+      key0, key1,
+      xla::Xor(xla::Xor(key0, key1),
+               xla::ConstantR0<xla::uint32>(builder, 0x1BD11BDA))};
+  x0 = x0 + keys[0];
+  x1 = x1 + keys[1];
+  for (int i = 0; i < 5; ++i) {
+    for (auto rotation : kRotations[i % 2]) {
+      x0 = x0 + x1;
+      x1 = xla::Xor(RotateLeft(x1, rotation), x0);
+    }
+    x0 = x0 + keys[(i + 1) % 3];
+    x1 = x1 + keys[(i + 2) % 3] + xla::ConstantR0<xla::uint32>(builder, i + 1);
+  }
+  return std::pair<xla::XlaOp, xla::XlaOp>(x0, x1);
+}
+
+// Maps random U32 bits to F32 values uniformly distributed within [0, 1), by
+// filling the mantissa of a value within [1, 2).
+xla::XlaOp BitsToUnitFloat(const xla::XlaOp& bits) {
+  xla::XlaBuilder* builder = bits.builder();
+  xla::XlaOp mantissa =
+      xla::ShiftRightLogical(bits, xla::ConstantR0<xla::uint32>(builder, 9));
+  xla::XlaOp one_two = xla::BitcastConvertType(
+      xla::Or(mantissa, xla::ConstantR0<xla::uint32>(builder, 0x3F800000)),
+      xla::PrimitiveType::F32);
+  return one_two - xla::ConstantR0<float>(builder, 1.0f);
+}
+
+}  // namespace
+
+xla::XlaOp BuildRngBits(
+    const xla::XlaOp& seed, xla::int64 offset,
+    tensorflow::gtl::ArraySlice<const xla::int64> dimensions) {
+  xla::XlaBuilder* builder = seed.builder();
+  xla::int64 num_elements = xla::util::Multiply<xla::int64>(dimensions);
+  // Every counter yields two 32 bit words.
+  xla::int64 num_counters = std::max<xla::int64>((num_elements + 1) / 2, 1);
+  XLA_CHECK_LE(num_counters, std::numeric_limits<xla::uint32>::max())
+      << "Too many random elements requested: " << num_elements;
+  xla::XlaOp seed64 = xla::ConvertElementType(seed, xla::PrimitiveType::U64);
+  xla::XlaOp key0 = xla::ConvertElementType(seed64, xla::PrimitiveType::U32);
+  xla::XlaOp key1 = xla::ConvertElementType(
+      xla::ShiftRightLogical(seed64, xla::ConstantR0<xla::uint64>(builder, 32)),
+      xla::PrimitiveType::U32);
+  xla::XlaOp x0 = xla::Iota(builder, xla::PrimitiveType::U32, num_counters);
+  xla::XlaOp x1 = xla::Broadcast(
+      xla::ConstantR0<xla::uint32>(builder, static_cast<xla::uint32>(offset)),
+      {num_counters});
+  std::pair<xla::XlaOp, xla::XlaOp> words = Threefry2x32(key0, key1, x0, x1);
+  xla::XlaOp bits = xla::ConcatInDim(builder, {words.first, words.second}, 0);
+  bits = xla::SliceInDim(bits, 0, num_elements, 1, 0);
+  return xla::Reshape(bits, dimensions);
+}
+
+xla::XlaOp BuildRngUniform(const xla::XlaOp& seed, xla::int64 offset,
+                           const xla::Shape& shape, const xla::XlaOp& minval,
+                           const xla::XlaOp& maxval) {
+  xla::XlaOp bits = BuildRngBits(seed, offset, shape.dimensions());
+  xla::XlaOp unit = xla::ConvertElementType(BitsToUnitFloat(bits),
+                                            shape.element_type());
+  return unit * (maxval - minval) + minval;
+}
+
+}  // namespace torch_xla
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "tensorflow/compiler/xla/client/xla_builder.h"
+#include "tensorflow/compiler/xla/types.h"
+#include "tensorflow/core/lib/gtl/array_slice.h"
+
+namespace torch_xla {
+
+// Generates U32 random bits with the given dimensions, using the Threefry-2x32
+// counter based generator. The key is the 64 bit seed scalar, and the counter
+// of every element is made of its linear index and of the offset, which must be
+// unique for every random operation using the same seed. The generated values
+// are a pure function of seed, offset and dimensions, so the XLA compiler is
+// free to recompute them instead of storing them.
+xla::XlaOp BuildRngBits(
+    const xla::XlaOp& seed, xla::int64 offset,
+    tensorflow::gtl::ArraySlice<const xla::int64> dimensions);
+
+// Generates uniformly distributed values within [minval, maxval), with the
+// shape and element type of the given floating point shape.
+xla::XlaOp BuildRngUniform(const xla::XlaOp& seed, xla::int64 offset,
+                           const xla::Shape& shape, const xla::XlaOp& minval,
+                           const xla::XlaOp& maxval);
+
+}  // namespace torch_xla
@@ -67,6 +67,24 @@ xla::XlaOp BuildLogSoftmax(const xla::XlaOp& logits, xla::int64 dim) {
                   parts.broadcast_dimensions);
 }
 
+xla::XlaOp BuildLogSumExp(const xla::XlaOp& logits, xla::int64 dim) {
+  const xla::Shape& logits_shape = XlaHelpers::ShapeOfXlaOp(logits);
+  xla::Literal min_value =
+      xla::LiteralUtil::MinValue(logits_shape.element_type());
+  xla::XlaOp logits_max =
+      xla::Reduce(logits, xla::ConstantLiteral(logits.builder(), min_value),
+                  XlaHelpers::CreateMaxComputation(logits_shape.element_type()),
+                  {dim});
+  xla::XlaOp shifted_logits = xla::Sub(
+      logits, logits_max, BroadcastDimensions(logits_shape.rank(), dim));
+  xla::XlaOp init_value = XlaHelpers::ScalarValue<float>(
+      0, logits_shape.element_type(), logits.builder());
+  xla::XlaOp reduce = xla::Reduce(
+      xla::Exp(shifted_logits), init_value,
+      XlaHelpers::CreateAddComputation(logits_shape.element_type()), {dim});
+  return logits_max + xla::Log(reduce);
+}
+
 xla::XlaOp BuildLogSoftmaxGrad(const xla::XlaOp& grad_output,
                                const xla::XlaOp& output, xla::int64 dim) {
   // Inspired from tf2xla.
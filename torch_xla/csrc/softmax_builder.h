@@ -7,6 +7,10 @@ namespace torch_xla {
 // Computes log(softmax(logits)) along the dimension specified by "dim".
 xla::XlaOp BuildLogSoftmax(const xla::XlaOp& logits, xla::int64 dim);
 
+// Computes log(sum(exp(logits))) along the dimension specified by "dim", which
+// is removed from the result shape.
+xla::XlaOp BuildLogSumExp(const xla::XlaOp& logits, xla::int64 dim);
+
 // Computes the gradient of the input of the LogSoftmax function.
 xla::XlaOp BuildLogSoftmaxGrad(const xla::XlaOp& grad_output,
                                const xla::XlaOp& output, xla::int64 dim);
@@ -4,19 +4,27 @@
 #include <atomic>
 #include <cmath>
 #include <condition_variable>
+#include <cstring>
 #include <exception>
 #include <functional>
+#include <list>
+#include <map>
 #include <mutex>
 #include <set>
 #include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "absl/strings/str_join.h"
+#include "tensorflow/compiler/xla/layout_util.h"
 #include "tensorflow/compiler/xla/literal_util.h"
+#include "tensorflow/compiler/xla/shape_util.h"
 #include "tensorflow/compiler/xla/xla_client/cache.h"
 #include "tensorflow/compiler/xla/xla_client/debug_macros.h"
 #include "tensorflow/compiler/xla/xla_client/metrics.h"
 #include "tensorflow/compiler/xla/xla_client/sys_util.h"
 #include "tensorflow/compiler/xla/xla_client/thread_pool.h"
+#include "tensorflow/compiler/xla/xla_client/tracer.h"
 #include "tensorflow/compiler/xla/xla_client/unique.h"
 #include "tensorflow/compiler/xla/xla_client/xla_util.h"
 #include "tensorflow/core/lib/core/errors.h"
@@ -46,6 +54,10 @@ struct TlsData {
 
 thread_local TlsData g_tls_data;
 
+// Counts the MarkStep() calls, and it is used to track the last step within
+// which a tensor has been used, to drive the device memory swap policy.
+std::atomic<size_t> g_step_counter(1);
+
 // Locking:
 // We perform two kinds of operations of tensors, synchronous and asynchronous.
 // The ApplyPendingGraph() are synchronous, as we need the device data result
@@ -155,6 +167,10 @@ std::vector<xla::util::ExceptionCleanup> LockDevices(
   return unlocker;
 }
 
+xla::int64 GetDataByteSize(const xla::ComputationClient::Data& data) {
+  return xla::ShapeUtil::ByteSizeOf(data.shape(), /*pointer_size=*/8);
+}
+
 class XlaDataCacheArena {
  public:
   struct TensorHasher {
@@ -219,6 +235,166 @@ xla::ComputationClient::DataPtr GetDeviceData(at::Scalar value,
                        device);
 }
 
+// Content addressed cache of the device data uploaded for non-scalar host
+// tensors. Differently from the XlaDataCache, which is bounded by the number of
+// entries, this one is bounded by the amount of device memory held by the
+// cached data, and the least recently used entries are evicted first.
+class XlaConstantCache {
+ public:
+  explicit XlaConstantCache(xla::int64 max_bytes) : max_bytes_(max_bytes) {}
+
+  xla::ComputationClient::DataPtr Get(const at::Tensor& tensor, size_t hash) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = FindLocked(tensor, hash);
+    if (it == element_map_.end()) {
+      return nullptr;
+    }
+    element_list_.splice(element_list_.begin(), element_list_, it->second);
+    return it->second->data;
+  }
+
+  // Adds the device data for the given host tensor, which must not be modified
+  // after being added. Returns the device data stored within the cache, which
+  // might be different from the input one in case of concurrent additions.
+  xla::ComputationClient::DataPtr Add(at::Tensor tensor, size_t hash,
+                                      xla::ComputationClient::DataPtr data) {
+    xla::int64 size = GetDataByteSize(*data);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = FindLocked(tensor, hash);
+    if (it != element_map_.end()) {
+      return it->second->data;
+    }
+    if (size > max_bytes_) {
+      return data;
+    }
+    element_list_.push_front(Element{hash, tensor.contiguous(), data, size});
+    element_map_.emplace(hash, element_list_.begin());
+    total_bytes_ += size;
+    EvictLocked();
+    return data;
+  }
+
+  void SetMaxBytes(xla::int64 max_bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (max_bytes != max_bytes_) {
+      max_bytes_ = max_bytes;
+      EvictLocked();
+    }
+  }
+
+ private:
+  struct Element {
+    size_t hash;
+    at::Tensor tensor;
+    xla::ComputationClient::DataPtr data;
+    xla::int64 size;
+  };
+
+  using ElementList = std::list<Element>;
+  using ElementMap = std::unordered_multimap<size_t, ElementList::iterator>;
+
+  void EvictLocked() {
+    while (total_bytes_ > max_bytes_) {
+      const Element& last = element_list_.back();
+      auto range = element_map_.equal_range(last.hash);
+      for (auto mit = range.first; mit != range.second; ++mit) {
+        if (&*mit->second == &last) {
+          element_map_.erase(mit);
+          break;
+        }
+      }
+      total_bytes_ -= last.size;
+      element_list_.pop_back();
+      XLA_COUNTER("ConstantCacheEvictions", 1);
+    }
+  }
+
+  // The tensors are compared by bytes, as value comparison would never match
+  // tensors holding NaNs, and would match 0.0 with -0.0.
+  ElementMap::iterator FindLocked(const at::Tensor& tensor, size_t hash) {
+    auto range = element_map_.equal_range(hash);
+    if (range.first == range.second) {
+      return element_map_.end();
+    }
+    at::Tensor contiguous_tensor = tensor.contiguous();
+    size_t size = contiguous_tensor.numel() * contiguous_tensor.element_size();
+    for (auto it = range.first; it != range.second; ++it) {
+      const at::Tensor& ctensor = it->second->tensor;
+      if (ctensor.scalar_type() == tensor.scalar_type() &&
+          ctensor.sizes() == tensor.sizes() &&
+          std::memcmp(ctensor.data_ptr(), contiguous_tensor.data_ptr(),
+                      size) == 0) {
+        return it;
+      }
+    }
+    return element_map_.end();
+  }
+
+  std::mutex mutex_;
+  xla::int64 max_bytes_ = 0;
+  xla::int64 total_bytes_ = 0;
+  ElementList element_list_;
+  ElementMap element_map_;
+};
+
+class XlaConstantCacheArena {
+ public:
+  XlaConstantCache* Get(const Device& device, xla::int64 max_bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = device_caches_.find(device);
+    if (it == device_caches_.end()) {
+      std::unique_ptr<XlaConstantCache> cache(new XlaConstantCache(max_bytes));
+      it = device_caches_.emplace(device, std::move(cache)).first;
+    } else {
+      it->second->SetMaxBytes(max_bytes);
+    }
+    return it->second.get();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::map<Device, std::unique_ptr<XlaConstantCache>> device_caches_;
+};
+
+// Returns the constant cache for the given device, or nullptr if the cache
+// is disabled (XLA_CONSTANT_CACHE_BYTES not set). The size is read at every
+// call, which is cheap compared to the upload which follows, so that the cache
+// can be turned on, off or resized at runtime.
+XlaConstantCache* GetXlaConstantCache(const Device& device) {
+  static XlaConstantCacheArena* arena = new XlaConstantCacheArena();
+  xla::int64 max_bytes =
+      xla::sys_util::GetEnvInt("XLA_CONSTANT_CACHE_BYTES", 0);
+  return max_bytes > 0 ? arena->Get(device, max_bytes) : nullptr;
+}
+
+xla::metrics::Metric* ConstantCacheSavedBytesMetric() {
+  static xla::metrics::Metric* metric = new xla::metrics::Metric(
+      "ConstantCacheSavedBytes", xla::metrics::MetricFnBytes);
+  return metric;
+}
+
+xla::ComputationClient::DataPtr GetConstantDeviceData(const at::Tensor& tensor,
+                                                      const Device& device) {
+  static const xla::int64 kMaxTensorBytes = xla::sys_util::GetEnvInt(
+      "XLA_CONSTANT_CACHE_MAX_TENSOR_BYTES", 1024 * 1024);
+  XlaConstantCache* cache = GetXlaConstantCache(device);
+  if (cache == nullptr ||
+      tensor.numel() * tensor.element_size() > kMaxTensorBytes) {
+    return TensorToXlaData(tensor, device);
+  }
+  size_t hash = xla::util::HashCombine(
+      xla::util::GetEnumValue(tensor.scalar_type()), TensorHash(tensor));
+  xla::ComputationClient::DataPtr device_data = cache->Get(tensor, hash);
+  if (device_data != nullptr) {
+    XLA_COUNTER("ConstantCacheHit", 1);
+    ConstantCacheSavedBytesMetric()->AddSample(GetDataByteSize(*device_data));
+    return device_data;
+  }
+  XLA_COUNTER("ConstantCacheMiss", 1);
+  device_data = TensorToXlaData(tensor, device);
+  return cache->Add(CopyTensor(tensor), hash, std::move(device_data));
+}
+
 // Routing values to device data maximizes the changes for compilation cache
 // hits, but it can prevent the compiler to perform optimizations. So tensor
 // values which are within a given set, are routed to constant scalars if this
@@ -237,6 +413,24 @@ bool ShouldSyncIrValue(const ir::Value& ir_value) {
   return ir_value->op() != ir::ops::xla_not_supported;
 }
 
+xla::int64 GetDeviceMemoryBudget() {
+  static const xla::int64 budget =
+      xla::sys_util::GetEnvInt("XLA_DEVICE_MEMORY_BUDGET", 0);
+  return budget;
+}
+
+xla::metrics::Metric* SwapOutBytesMetric() {
+  static xla::metrics::Metric* metric =
+      new xla::metrics::Metric("SwapOutBytes", xla::metrics::MetricFnBytes);
+  return metric;
+}
+
+xla::metrics::Metric* SwapInBytesMetric() {
+  static xla::metrics::Metric* metric =
+      new xla::metrics::Metric("SwapInBytes", xla::metrics::MetricFnBytes);
+  return metric;
+}
+
 }  // namespace
 
 // The DeviceContextArena holds per device live information and statistics,
@@ -249,6 +443,9 @@ class XLATensor::DeviceContextArena {
     std::mutex lock;
     std::map<xla::int64, std::weak_ptr<Data>> tensors_data;
     std::set<size_t> sync_hashes;
+    xla::uint64 seed = 101;
+    xla::int64 rng_offset = 0;
+    ir::Value seed_ir_value;
   };
 
  public:
@@ -294,6 +491,53 @@ class XLATensor::DeviceContextArena {
     ForAllDeviceContexts(fn, device);
   }
 
+  ir::Value GetRngSeed(const Device& device, xla::int64* rng_offset) {
+    DeviceContext* devctx = GetDeviceContext(device);
+    std::lock_guard<std::mutex> lock(devctx->lock);
+    if (!devctx->seed_ir_value) {
+      // Not going through GetIrValueForScalar(), as special scalar values would
+      // turn into graph constants.
+      devctx->seed_ir_value = ir::MakeNode<ir::ops::DeviceData>(GetDeviceData(
+          static_cast<int64_t>(devctx->seed), at::ScalarType::Long, device));
+    }
+    *rng_offset = devctx->rng_offset++;
+    return devctx->seed_ir_value;
+  }
+
+  void SetRngSeed(const Device* device, xla::uint64 seed) {
+    auto fn = [&](DeviceContext* devctx) {
+      std::lock_guard<std::mutex> lock(devctx->lock);
+      devctx->seed = seed;
+      devctx->rng_offset = 0;
+      devctx->seed_ir_value = ir::Value();
+    };
+    ForAllDeviceContexts(fn, device);
+  }
+
+  xla::uint64 GetRunningSeed(const Device& device) {
+    DeviceContext* devctx = GetDeviceContext(device);
+    std::lock_guard<std::mutex> lock(devctx->lock);
+    return devctx->seed;
+  }
+
+  // Moves the devices which issued random operations to a new seed, and resets
+  // their counter offsets. Called at every graph sync, so that the offsets
+  // carried by the random IR nodes (hence the graph hashes) do not grow across
+  // syncs which are not followed by a MarkStep().
+  void AdvanceRngSeeds(const Device* device) {
+    static const xla::uint64 kSeedMul = 6364136223846793005ULL;
+    static const xla::uint64 kSeedAdd = 1442695040888963407ULL;
+    auto fn = [&](DeviceContext* devctx) {
+      std::lock_guard<std::mutex> lock(devctx->lock);
+      if (devctx->rng_offset > 0) {
+        devctx->seed = devctx->seed * kSeedMul + kSeedAdd;
+        devctx->rng_offset = 0;
+        devctx->seed_ir_value = ir::Value();
+      }
+    };
+    ForAllDeviceContexts(fn, device);
+  }
+
   void AddSyncedHash(const Device& device, size_t hash) {
     DeviceContext* devctx = GetDeviceContext(device);
     std::lock_guard<std::mutex> lock(devctx->lock);
@@ -511,6 +755,7 @@ xla::ComputationClient::DataPtr XLATensor::GetXlaData() {
     up_to_date = !ir_value_updated.updated;
     ir_value = std::move(ir_value_updated.ir_value);
   }
+  MarkUsed();
   if (up_to_date) {
     xla::ComputationClient::DataPtr xla_data = CurrentXlaData();
     if (xla_data != nullptr) {
@@ -529,9 +774,16 @@ xla::ComputationClient::DataPtr XLATensor::GetXlaData() {
   }
   if (data()->ir_value) {
     ApplyPendingGraph();
+  } else if (data()->swapped_out) {
+    SwapIn();
   } else {
     XLA_CHECK(data()->tensor_data);
-    data()->xla_data = TensorToXlaData(*data()->tensor_data, GetDevice());
+    if (data()->upload_queued) {
+      UploadQueuedTensors();
+    }
+    if (data()->xla_data == nullptr) {
+      data()->xla_data = TensorToXlaData(*data()->tensor_data, GetDevice());
+    }
   }
   return data()->xla_data;
 }
@@ -559,6 +811,7 @@ void XLATensor::SetXlaData(xla::ComputationClient::DataPtr xla_data) {
 void XLATensor::SetXlaData(xla::ComputationClient::DataPtr xla_data,
                            bool sync) {
   data()->xla_data = std::move(xla_data);
+  data()->swapped_out = false;
   // Assigning a device data should always clear the IR node, to allow graph
   // trimming. A view cannot be rest though, unless we are at a step-end sync.
   AssignIrValue(ir::Value());
@@ -571,6 +824,7 @@ void XLATensor::SetXlaData(xla::ComputationClient::DataPtr xla_data,
 void XLATensor::SetIrValue(ir::Value ir_value) {
   data()->xla_data = nullptr;
   data()->tensor_data = c10::nullopt;
+  data()->swapped_out = false;
   data()->generation += 1;
   if (data()->view != nullptr) {
     // If we have an active view, and a SetIrValue() happens, it means we are
@@ -613,6 +867,7 @@ void XLATensor::TryLimitGraphSize() {
 }
 
 ir::Value XLATensor::GetIrValue() const {
+  MarkUsed();
   ir::Value ir_value = CurrentIrValue();
   if (ir_value) {
     return ir_value;
@@ -628,6 +883,17 @@ ir::Value XLATensor::GetIrValue() const {
     AssignIrValue(CreateTensorNode(xla_data));
     return data()->ir_value;
   }
+  if (data()->swapped_out) {
+    AssignIrValue(CreateTensorNode(const_cast<XLATensor*>(this)->SwapIn()));
+    return data()->ir_value;
+  }
+  if (data()->upload_queued) {
+    UploadQueuedTensors();
+    if (data()->xla_data != nullptr) {
+      AssignIrValue(CreateTensorNode(data()->xla_data));
+      return data()->ir_value;
+    }
+  }
   c10::optional<at::Tensor> tensor_data = CurrentTensorData();
   XLA_CHECK(tensor_data);
   AssignIrValue(GetIrValueForTensor(*tensor_data, GetDevice()));
@@ -645,6 +911,97 @@ void XLATensor::SetTensorData(at::Tensor tensor_data) {
   data()->tensor_data = std::move(tensor_data);
 }
 
+void XLATensor::MarkUsed() const {
+  data()->last_use_step.store(g_step_counter.load(std::memory_order_relaxed),
+                              std::memory_order_relaxed);
+}
+
+bool XLATensor::IsSwappable() const {
+  if (data()->view != nullptr || data()->xla_data == nullptr ||
+      !data()->xla_data->HasValue()) {
+    return false;
+  }
+  // A tensor holding device data can also have an IR value, but only if that
+  // is the device data node created by GetIrValue() out of the same data.
+  if (data()->ir_value) {
+    const ir::ops::DeviceData* device_data =
+        dynamic_cast<const ir::ops::DeviceData*>(data()->ir_value.node.get());
+    return device_data != nullptr && device_data->data() == data()->xla_data;
+  }
+  return true;
+}
+
+void XLATensor::ReleaseSwappedXlaData() {
+  XLA_CHECK(data()->tensor_data);
+  data()->xla_data = nullptr;
+  AssignIrValue(ir::Value());
+  data()->swapped_out = true;
+}
+
+xla::ComputationClient::DataPtr XLATensor::SwapIn() {
+  std::vector<XLATensor> tensors({*this});
+  SwapInTensors(&tensors);
+  return data()->xla_data;
+}
+
+std::vector<std::weak_ptr<XLATensor::Data>>* XLATensor::GetQueuedUploads() {
+  static thread_local std::vector<std::weak_ptr<Data>> queued_uploads;
+  return &queued_uploads;
+}
+
+void XLATensor::QueueDeviceUpload() {
+  // Zero-dimensional tensors are left alone, as GetIrValueForTensor() might
+  // turn them into constants, with no need of device data.
+  if (data()->tensor_data && data()->tensor_data->dim() > 0 &&
+      data()->xla_data == nullptr && !data()->ir_value &&
+      data()->view == nullptr && !data()->upload_queued) {
+    data()->upload_queued = true;
+    GetQueuedUploads()->push_back(data_ptr());
+    XLA_COUNTER("QueuedDeviceUploads", 1);
+  }
+}
+
+void XLATensor::UploadQueuedTensors() {
+  std::vector<std::weak_ptr<Data>>* queued_uploads = GetQueuedUploads();
+  std::vector<std::shared_ptr<Data>> tensors_data;
+  std::vector<at::Tensor> at_tensors;
+  std::vector<std::string> devices;
+  for (auto& weak_data : *queued_uploads) {
+    std::shared_ptr<Data> data = weak_data.lock();
+    if (data == nullptr || !data->upload_queued) {
+      continue;
+    }
+    data->upload_queued = false;
+    // The tensor might have been updated after having been queued.
+    if (data->tensor_data && data->xla_data == nullptr && !data->ir_value &&
+        data->view == nullptr) {
+      at_tensors.push_back(*data->tensor_data);
+      devices.push_back(data->device.ToString());
+      tensors_data.push_back(std::move(data));
+    }
+  }
+  queued_uploads->clear();
+  if (!at_tensors.empty()) {
+    XLA_COUNTER("QueuedDeviceUploadsFlush", 1);
+    std::vector<xla::ComputationClient::DataPtr> handles =
+        CreateTensorsData(at_tensors, devices);
+    for (size_t i = 0; i < handles.size(); ++i) {
+      tensors_data[i]->xla_data = std::move(handles[i]);
+    }
+  }
+}
+
+void XLATensor::ClearQueuedUploads() {
+  std::vector<std::weak_ptr<Data>>* queued_uploads = GetQueuedUploads();
+  for (auto& weak_data : *queued_uploads) {
+    std::shared_ptr<Data> data = weak_data.lock();
+    if (data != nullptr) {
+      data->upload_queued = false;
+    }
+  }
+  queued_uploads->clear();
+}
+
 c10::optional<at::Tensor> XLATensor::CurrentTensorData() const {
   if (data()->view != nullptr && !data()->view->IsUpToDate()) {
     return c10::nullopt;
@@ -664,7 +1021,7 @@ ir::Value XLATensor::GetIrValueForTensor(const at::Tensor& tensor,
     }
     data = GetDeviceData(tensor, device);
   } else {
-    data = TensorToXlaData(tensor, device);
+    data = GetConstantDeviceData(tensor, device);
   }
   return ir::MakeNode<ir::ops::DeviceData>(std::move(data));
 }
@@ -734,7 +1091,7 @@ std::shared_ptr<View> XLATensor::CreateView(ViewInfo view_info) const {
   // becoming one itself. This means creating an alias with the current IR
   // Node, and using the same alias for the created IR Node.
   ir::Value ir_value = GetIrValue();
-  std::shared_ptr<Alias> alias = std::make_shared<Alias>(ir_value);
+  std::shared_ptr<Alias> alias = std::make_shared<Alias>(ir_value, GetDevice());
   ViewInfo this_view_info(
       ViewInfo::Type::kNoOp, ir_value.shape(),
       xla::util::ToVector<xla::int64>(ir_value.shape().dimensions()));
@@ -774,6 +1131,7 @@ void XLATensor::SetTensor(at::Tensor tensor) {
   SetTensorData(tensor);
   data()->view = nullptr;
   data()->xla_data = nullptr;
+  data()->swapped_out = false;
   AssignIrValue(ir::Value());
   data()->generation += 1;
 }
@@ -785,6 +1143,7 @@ void XLATensor::UpdateFromTensor(at::Tensor tensor) {
     data()->view = UpdateView(data()->view, std::move(ir_value));
   }
   data()->xla_data = nullptr;
+  data()->swapped_out = false;
   AssignIrValue(ir::Value());
 }
 
@@ -894,6 +1253,111 @@ std::vector<at::Tensor> XLATensor::GetTensorsFused(
   return results;
 }
 
+XLATensor::TensorsFuture XLATensor::GetTensorsAsync(
+    std::vector<XLATensor>* tensors) {
+  static const bool op_by_op =
+      xla::sys_util::GetEnvBool("GET_TENSORS_OPBYOP", false);
+  if (op_by_op) {
+    std::vector<at::Tensor> results = GetTensorsOpByOp(tensors);
+    TensorsFuture future([results = std::move(results)]() { return results; });
+    future.Schedule();
+    return future;
+  }
+
+  // If none of the tensors has pending IR operations, there is no need to run
+  // a sync operation, which would wait on the device locks for the in flight
+  // operations (like the one issued by the last step marker) to complete. The
+  // device barrier is issued by the background task instead, before fetching
+  // the device data.
+  bool needs_sync = false;
+  std::set<Device> devices;
+  for (auto& tensor : *tensors) {
+    if (tensor.CurrentXlaData() == nullptr) {
+      ir::Value ir_value = tensor.CurrentIrValue();
+      needs_sync = needs_sync || (ir_value && ShouldSyncIrValue(ir_value));
+    }
+    devices.insert(tensor.GetDevice());
+  }
+  std::shared_ptr<Async> async;
+  if (needs_sync) {
+    SyncTensorsConfig config;
+    config.force_xla_data = false;
+    async = SyncTensorsGraphInternal(tensors, {}, config);
+  }
+  // The tensors state can be changed by the caller as soon as we return, so we
+  // take a snapshot of what is needed to fetch their values. The device data of
+  // the tensors which are part of the sync operation will only be available
+  // once the asynchronous execution completes.
+  std::vector<c10::optional<at::Tensor>> tensors_host_data;
+  std::vector<xla::ComputationClient::DataPtr> tensors_device_data;
+  std::vector<at::ScalarType> tensors_types;
+  size_t indices_index = 0;
+  for (size_t i = 0; i < tensors->size(); ++i) {
+    const XLATensor& tensor = (*tensors)[i];
+    tensors_types.push_back(tensor.dtype());
+    if (async != nullptr && indices_index < async->indices.size() &&
+        i == async->indices[indices_index]) {
+      tensors_host_data.emplace_back(c10::nullopt);
+      tensors_device_data.emplace_back(nullptr);
+      ++indices_index;
+    } else {
+      tensors_host_data.push_back(tensor.CurrentTensorData());
+      if (!tensors_host_data.back()) {
+        xla::ComputationClient::DataPtr xla_data = tensor.CurrentXlaData();
+        XLA_CHECK(xla_data != nullptr);
+        tensors_device_data.push_back(std::move(xla_data));
+      } else {
+        tensors_device_data.emplace_back(nullptr);
+      }
+    }
+  }
+
+  auto fetchfn = [async, devices = std::move(devices),
+                  tensors_host_data = std::move(tensors_host_data),
+                  tensors_device_data = std::move(tensors_device_data),
+                  tensors_types = std::move(tensors_types)]() mutable {
+    XLA_TIMED("GetTensorsAsyncFetchTime");
+    if (async != nullptr) {
+      async->mwait.Wait();
+      for (size_t i = 0; i < async->indices.size(); ++i) {
+        XLA_CHECK(async->tensors_data[i] != nullptr);
+        tensors_device_data[async->indices[i]] = async->tensors_data[i];
+      }
+    } else {
+      for (auto& device : devices) {
+        DeviceBarrier(device);
+      }
+    }
+    std::vector<xla::ComputationClient::DataPtr> tensors_data;
+    for (auto& xla_data : tensors_device_data) {
+      if (xla_data != nullptr) {
+        tensors_data.push_back(xla_data);
+      }
+    }
+    std::vector<xla::Literal> literals =
+        xla::ComputationClient::Get()->TransferFromServer(tensors_data);
+    std::vector<at::Tensor> results;
+    size_t literals_index = 0;
+    results.reserve(tensors_host_data.size());
+    for (size_t i = 0; i < tensors_host_data.size(); ++i) {
+      if (tensors_host_data[i]) {
+        results.push_back(*tensors_host_data[i]);
+      } else {
+        XLA_CHECK_LT(literals_index, literals.size());
+        results.push_back(MakeTensorFromXlaLiteral(literals[literals_index],
+                                                   tensors_types[i]));
+        ++literals_index;
+      }
+    }
+    return results;
+  };
+
+  XLA_COUNTER("GetTensorsAsync", 1);
+  TensorsFuture future(std::move(fetchfn));
+  future.Schedule();
+  return future;
+}
+
 std::vector<XLATensor> XLATensor::CreateTensors(
     const std::vector<at::Tensor>& tensors,
     const std::vector<std::string>& devices) {
@@ -911,6 +1375,144 @@ ir::Value XLATensor::CreateTensorNode(xla::ComputationClient::DataPtr data) {
   return ir::ops::DeviceDataOp(std::move(data));
 }
 
+void XLATensor::SwapOutTensors(std::vector<XLATensor>* tensors) {
+  XLA_TIMED("SwapOutTime");
+  std::set<Device> devices;
+  for (auto& tensor : *tensors) {
+    devices.insert(tensor.GetDevice());
+  }
+  // Wait for any in flight asynchronous operation to complete, so that the
+  // device data handles are stable.
+  for (auto& device : devices) {
+    DeviceBarrier(device);
+  }
+
+  std::vector<size_t> indices;
+  std::vector<xla::ComputationClient::DataPtr> tensors_data;
+  xla::int64 swapped_bytes = 0;
+  for (size_t i = 0; i < tensors->size(); ++i) {
+    XLATensor& tensor = (*tensors)[i];
+    if (!tensor.IsSwappable()) {
+      continue;
+    }
+    swapped_bytes += GetDataByteSize(*tensor.data()->xla_data);
+    if (tensor.data()->tensor_data) {
+      // The host side already has a copy of the data, so no need to fetch it.
+      tensor.ReleaseSwappedXlaData();
+    } else {
+      indices.push_back(i);
+      tensors_data.push_back(tensor.data()->xla_data);
+    }
+  }
+  if (!tensors_data.empty()) {
+    std::vector<xla::Literal> literals =
+        xla::ComputationClient::Get()->TransferFromServer(tensors_data);
+    for (size_t i = 0; i < indices.size(); ++i) {
+      XLATensor& tensor = (*tensors)[indices[i]];
+      tensor.SetTensorData(
+          MakeTensorFromXlaLiteral(literals[i], tensor.dtype()));
+      tensor.ReleaseSwappedXlaData();
+    }
+  }
+  if (swapped_bytes > 0) {
+    SwapOutBytesMetric()->AddSample(swapped_bytes);
+  }
+}
+
+void XLATensor::SwapInTensors(std::vector<XLATensor>* tensors) {
+  XLA_TIMED("SwapInTime");
+  std::set<Data*> swapped_data;
+  std::vector<Data*> tensors_data;
+  std::vector<at::Tensor> at_tensors;
+  std::vector<std::string> devices;
+  for (auto& tensor : *tensors) {
+    Data* tensor_data = tensor.data();
+    if (tensor_data->swapped_out && swapped_data.insert(tensor_data).second) {
+      XLA_CHECK(tensor_data->tensor_data);
+      tensors_data.push_back(tensor_data);
+      at_tensors.push_back(*tensor_data->tensor_data);
+      devices.push_back(tensor_data->device.ToString());
+    }
+  }
+  if (at_tensors.empty()) {
+    return;
+  }
+  std::vector<xla::ComputationClient::DataPtr> handles =
+      CreateTensorsData(at_tensors, devices);
+  xla::int64 swapped_bytes = 0;
+  for (size_t i = 0; i < handles.size(); ++i) {
+    swapped_bytes += GetDataByteSize(*handles[i]);
+    tensors_data[i]->xla_data = std::move(handles[i]);
+    tensors_data[i]->swapped_out = false;
+  }
+  XLA_COUNTER("SwapInTensors", tensors_data.size());
+  SwapInBytesMetric()->AddSample(swapped_bytes);
+}
+
+void XLATensor::ApplyDeviceMemoryBudget(const Device* device) {
+  xla::int64 budget = GetDeviceMemoryBudget();
+  if (budget <= 0) {
+    return;
+  }
+  // The live tensors are returned grouped by device, so we process each group.
+  std::vector<XLATensor> tensors = GetLiveTensors(device);
+  for (size_t start = 0; start < tensors.size();) {
+    size_t end = start + 1;
+    while (end < tensors.size() &&
+           tensors[end].GetDevice() == tensors[start].GetDevice()) {
+      ++end;
+    }
+    // Only the shapes are accessed here, which are valid even for the device
+    // data placeholders of in flight asynchronous operations. Aliasing tensors
+    // sharing the same device data are accounted only once.
+    std::set<const xla::ComputationClient::Data*> accounted_data;
+    xla::int64 device_bytes = 0;
+    for (size_t i = start; i < end; ++i) {
+      xla::ComputationClient::DataPtr xla_data = tensors[i].CurrentXlaData();
+      if (xla_data != nullptr && accounted_data.insert(xla_data.get()).second) {
+        device_bytes += GetDataByteSize(*xla_data);
+      }
+    }
+    XLA_VALUE_METRIC("TrackedDeviceBytes", device_bytes);
+    if (device_bytes > budget) {
+      DeviceBarrier(tensors[start].GetDevice());
+
+      std::vector<XLATensor> candidates;
+      for (size_t i = start; i < end; ++i) {
+        if (tensors[i].IsSwappable()) {
+          candidates.push_back(tensors[i]);
+        }
+      }
+      std::stable_sort(candidates.begin(), candidates.end(),
+                       [](const XLATensor& t1, const XLATensor& t2) {
+                         return t1.data()->last_use_step.load(
+                                    std::memory_order_relaxed) <
+                                t2.data()->last_use_step.load(
+                                    std::memory_order_relaxed);
+                       });
+      std::vector<XLATensor> swap_tensors;
+      std::set<const xla::ComputationClient::Data*> swapped_data;
+      for (auto& tensor : candidates) {
+        if (device_bytes <= budget) {
+          break;
+        }
+        const xla::ComputationClient::DataPtr& xla_data =
+            tensor.data()->xla_data;
+        if (swapped_data.insert(xla_data.get()).second) {
+          device_bytes -= GetDataByteSize(*xla_data);
+        }
+        swap_tensors.push_back(tensor);
+      }
+      TF_VLOG(3) << "Swapping out " << swap_tensors.size() << " tensors from "
+                 << tensors[start].GetDevice() << " to meet a budget of "
+                 << budget << " bytes";
+      XLA_COUNTER("SwapOutTensors", swap_tensors.size());
+      SwapOutTensors(&swap_tensors);
+    }
+    start = end;
+  }
+}
+
 xla::int64 XLATensor::GetNextTensorId() {
   static std::atomic<xla::int64>* id_generator = new std::atomic<xla::int64>(1);
   return id_generator->fetch_add(1);
@@ -926,8 +1528,19 @@ std::vector<XLATensor> XLATensor::MakeOutputTensors(ir::NodePtr node) const {
 }
 
 XLATensor XLATensor::CopyTensorToDevice(const Device& device) {
-  // TODO: This can be optimized via proper XRT/XLA computation.
-  return Create(ToTensor(), device);
+  c10::optional<at::Tensor> tensor_data = CurrentTensorData();
+  // Devices of different types might want different layouts for the same data,
+  // so only same type copies are done on the device side.
+  if (tensor_data || device.hw_type != GetDevice().hw_type) {
+    return Create(tensor_data ? *tensor_data : ToTensor(), device);
+  }
+  // Wait for any async operation still writing the data being copied.
+  DeviceBarrier(GetDevice());
+  std::vector<xla::ComputationClient::DataPtr> device_data =
+      xla::ComputationClient::Get()->TransferToDevice({GetXlaData()},
+                                                      device.ToString());
+  XLA_COUNTER("DeviceToDeviceCopies", 1);
+  return Create(std::move(device_data.front()), dtype());
 }
 
 XLATensor XLATensor::CreateFrom(ir::Value ir_value) const {
@@ -987,7 +1600,11 @@ XLATensor::SyncTensorCollection XLATensor::CollectSyncTensors(
   coll.indices.reserve(tensors.size());
   TF_VLOG(4) << "Waiting on device barrier for device " << coll.device
              << " ...";
-  coll.unlocker = LockDevices(unique_device.AsSet());
+  {
+    xla::tracer::ScopedEvent trace("WaitDeviceLock");
+    trace.AddArg("device", coll.device);
+    coll.unlocker = LockDevices(unique_device.AsSet());
+  }
   TF_VLOG(4) << "Waiting on device barrier for device " << coll.device
              << " done!";
   for (size_t i = 0; i < tensors.size(); ++i) {
@@ -1023,9 +1640,20 @@ XLATensor::SyncTensorCollection XLATensor::CollectSyncTensors(
       // present. Also, we uploaded the at::Tensor data to the device, but such
       // data is still valid so we leave it live on the XLA tensor (so that a
       // following ToTensor() does not need to fetch it from device).
-      tensors[at_tensor_index[i]].data()->xla_data = std::move(handles[i]);
+      Data* tensor_data = tensors[at_tensor_index[i]].data();
+      if (tensor_data->swapped_out) {
+        XLA_COUNTER("SwapInTensors", 1);
+        SwapInBytesMetric()->AddSample(GetDataByteSize(*handles[i]));
+        tensor_data->swapped_out = false;
+      }
+      tensor_data->xla_data = std::move(handles[i]);
     }
   }
+  if (!coll.indices.empty()) {
+    // The random operations of the graphs traced after this one, get a new
+    // seed and restart their offsets.
+    DeviceContextArena::Get()->AdvanceRngSeeds(&(*unique_device));
+  }
   TF_VLOG(4) << "Tensors graph hash " << coll.hash << " on device "
              << coll.device;
   return coll;
@@ -1114,6 +1742,9 @@ std::shared_ptr<XLATensor::Async> XLATensor::ScheduleSyncTensorsGraph(
   }
 
   auto syncfn = [async, hash = coll->hash]() {
+    xla::tracer::ScopedEvent trace("ExecuteGraph");
+    trace.AddArg("device", async->device);
+    trace.AddArg("graph_hash", hash);
     xla::ComputationClient::ExecuteComputationOptions options;
     try {
       TF_VLOG(3) << "Executing IR graph hash " << hash << " on device "
@@ -1173,10 +1804,72 @@ void XLATensor::SyncLiveTensorsGraph(
   SyncTensorsGraph(&tensors, devices, wait, /*sync_xla_data=*/true);
 }
 
+void XLATensor::SyncTensorsClosureGraph(
+    std::vector<XLATensor>* tensors,
+    tensorflow::gtl::ArraySlice<const std::string> devices, bool wait) {
+  std::vector<const ir::Node*> roots;
+  std::set<xla::int64> unique_ids;
+  xla::util::Unique<Device> unique_device;
+  for (auto& tensor : *tensors) {
+    ir::Value ir_value = tensor.CurrentIrValue();
+    if (ir_value) {
+      roots.push_back(ir_value.node.get());
+    }
+    unique_ids.insert(tensor.GetUniqueId());
+    unique_device.set(tensor.GetDevice());
+  }
+  if (!roots.empty()) {
+    std::vector<const ir::Node*> post_order =
+        ir::Util::ComputePostOrder(roots);
+    std::unordered_set<const ir::Node*> graph_nodes(post_order.begin(),
+                                                    post_order.end());
+    size_t num_tensors = tensors->size();
+    for (auto& tensor : GetLiveTensors(&(*unique_device))) {
+      if (tensor.CurrentXlaData() == nullptr &&
+          unique_ids.count(tensor.GetUniqueId()) == 0) {
+        ir::Value ir_value = tensor.CurrentIrValue();
+        if (ir_value && graph_nodes.count(ir_value.node.get()) > 0) {
+          tensors->push_back(std::move(tensor));
+        }
+      }
+    }
+    XLA_COUNTER("SyncClosureTensors", tensors->size() - num_tensors);
+  }
+  TF_VLOG(4) << tensors->size() << " closure tensors: devices=["
+             << absl::StrJoin(devices, ",") << "]";
+  SyncTensorsGraph(tensors, devices, wait, /*sync_xla_data=*/true);
+}
+
+ir::Value XLATensor::GetRngSeed(const Device& device, xla::int64* rng_offset) {
+  return DeviceContextArena::Get()->GetRngSeed(device, rng_offset);
+}
+
+void XLATensor::SetRngSeed(const Device* device, xla::uint64 seed) {
+  DeviceContextArena::Get()->SetRngSeed(device, seed);
+}
+
+xla::uint64 XLATensor::GetRunningSeed(const Device& device) {
+  return DeviceContextArena::Get()->GetRunningSeed(device);
+}
+
 void XLATensor::MarkStep(const Device* device) {
+  // The time elapsed between steps is mostly spent tracing the IR graph of
+  // the step on the host side.
+  static std::atomic<xla::int64> last_step_ns(xla::sys_util::NowNs());
+  xla::int64 now_ns = xla::sys_util::NowNs();
+  xla::tracer::AddCompleteEvent("HostStep", last_step_ns.exchange(now_ns),
+                                now_ns);
   XLA_COUNTER("MarkStep", 1);
+  if (xla::metrics::StepDeltasEnabled()) {
+    xla::metrics::CaptureStepDelta();
+  }
+  ApplyDeviceMemoryBudget(device);
+  g_step_counter.fetch_add(1);
   DeviceContextArena::Get()->ClearProfileData(device);
+  DeviceContextArena::Get()->AdvanceRngSeeds(device);
   ir::ScopePusher::ResetScopes();
+  // The tensors still queued at step end, are uploaded by the step sync.
+  ClearQueuedUploads();
   g_tls_data.Reset();
 }
 
@@ -1266,16 +1959,20 @@ std::shared_ptr<XLATensor::Async> XLATensor::SyncTensorsGraphInternal(
     std::vector<XLATensor>* tensors,
     tensorflow::gtl::ArraySlice<const std::string> devices,
     const SyncTensorsConfig& config) {
+  xla::tracer::ScopedEvent trace("SyncTensorsGraph");
   SyncTensorCollection coll = CollectSyncTensors(*tensors, config);
   if (coll.indices.empty()) {
     return nullptr;
   }
+  trace.AddArg("device", coll.device);
+  trace.AddArg("graph_hash", coll.hash);
   std::shared_ptr<Async> async = TryRunCachedSync(tensors, config, &coll);
   if (async != nullptr) {
     return async;
   }
   XLA_COUNTER("UncachedSyncTensors", 1);
 
+  xla::int64 lowering_start_ns = xla::sys_util::NowNs();
   xla::util::Unique<Device> unique_device;
   ir::LoweringContext lowering_ctx("SyncTensorsGraph");
   for (auto index : coll.indices) {
@@ -1289,8 +1986,15 @@ std::shared_ptr<XLATensor::Async> XLATensor::SyncTensorsGraphInternal(
 
   xla::XlaComputation computation = ConsumeValue(lowering_ctx.Build());
   xla::ProgramShape program_shape = ConsumeValue(computation.GetProgramShape());
+  xla::tracer::AddCompleteEvent("LowerGraph", lowering_start_ns,
+                                xla::sys_util::NowNs());
+  DebugUtil::CaptureComputation(computation, coll.device, coll.hash);
   xla::Shape shape =
       MakeShapeWithDeviceLayout(program_shape.result(), unique_device->hw_type);
+  bool record_layouts = IsLayoutProfileRecording();
+  if (record_layouts) {
+    xla::LayoutUtil::ClearLayout(&shape);
+  }
 
   std::vector<xla::ComputationClient::CompileInstance> instances;
   instances.push_back({std::move(computation), unique_device->ToString(),
@@ -1305,6 +2009,9 @@ std::shared_ptr<XLATensor::Async> XLATensor::SyncTensorsGraphInternal(
           xla::ComputationClient::Get()->Compile(std::move(instances));
   TF_VLOG(3) << "Compiling IR graph hash " << coll.hash << " on device "
              << coll.device << " done!";
+  if (record_layouts) {
+    RecordComputationLayouts(computations.front()->program_shape());
+  }
 
   std::vector<xla::ComputationClient::DataPtr> parameters_data =
       lowering_ctx.GetParametersData();
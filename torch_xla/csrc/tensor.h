@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <iostream>
 #include <string>
 #include <unordered_map>
@@ -55,6 +56,13 @@ class XLATensor {
 
   void UpdateFromTensor(at::Tensor tensor);
 
+  // Queues the upload to device of the host data held by the tensor. Rather
+  // than uploading it at first use, all the queued tensors of the calling
+  // thread are uploaded together, with a single transfer, the first time any
+  // of them is needed on device. This allows the results of a run of CPU
+  // fallbacks to reach the device at once.
+  void QueueDeviceUpload();
+
   at::ScalarType dtype() const;
 
   // Set logical_element_type which is visible to upstream PyTorch.
@@ -141,10 +149,33 @@ class XLATensor {
       const Device* device,
       tensorflow::gtl::ArraySlice<const std::string> devices, bool wait);
 
+  // Applies the pending IR operations needed to compute the input tensors,
+  // which must all be on the same device. The live tensors whose pending IR
+  // values are part of such graph are synced as well, as they come as
+  // additional outputs of the same computation. The pending operations of all
+  // the other live tensors are left untouched, so that a partial sync does not
+  // compile and run unrelated computations.
+  static void SyncTensorsClosureGraph(
+      std::vector<XLATensor>* tensors,
+      tensorflow::gtl::ArraySlice<const std::string> devices, bool wait);
+
   // Marks an execution step, which allows the tensor framework to understand
   // the computation boundaries.
   static void MarkStep(const Device* device);
 
+  // Returns the IR value of the RNG seed of the device for the current step,
+  // and stores into rng_offset the counter offset reserved for a new random
+  // operation. The seed is fed as device data, and the offsets restart at every
+  // graph sync and MarkStep() (which also advance the seed), so that steps
+  // issuing the same random operations trace identical graphs.
+  static ir::Value GetRngSeed(const Device& device, xla::int64* rng_offset);
+
+  // Sets the RNG seed of the given device, or of all the devices if nullptr.
+  static void SetRngSeed(const Device* device, xla::uint64 seed);
+
+  // Returns the RNG seed the device is going to use for the current step.
+  static xla::uint64 GetRunningSeed(const Device& device);
+
   // Waits for all the outstanding operations on all the supplied devices.
   // If devices is empty, the wait will happen for all local devices.
   static void WaitDeviceOps(
@@ -154,12 +185,35 @@ class XLATensor {
   // All the tensors must be on the same device.
   static std::vector<at::Tensor> GetTensors(std::vector<XLATensor>* tensors);
 
+  using TensorsFuture = xla::util::AsyncTask<std::vector<at::Tensor>>;
+
+  // Asynchronous version of GetTensors(). The execution of the pending IR
+  // operations is scheduled right away, while waiting for its completion and
+  // fetching the data back from the device happen in the background. The
+  // returned future holds the PyTorch CPU tensors. If the tensors have no
+  // pending IR operations, the API does not wait for the in flight device
+  // operations to complete.
+  static TensorsFuture GetTensorsAsync(std::vector<XLATensor>* tensors);
+
   // Operation which creates XLA tensors out of PyTorch CPU tensors by batching
   // the requests to the computation servers.
   static std::vector<XLATensor> CreateTensors(
       const std::vector<at::Tensor>& tensors,
       const std::vector<std::string>& devices);
 
+  // Moves the device data held by the input tensors back into host memory, and
+  // drops the tensors references to the device handles. Tensors which have
+  // pending IR operations, or which are views, are left untouched. The host
+  // data is transparently uploaded again the next time the tensors are used.
+  static void SwapOutTensors(std::vector<XLATensor>* tensors);
+
+  // Uploads back to device, with a single transfer, the data of the input
+  // tensors which have been swapped out. A swapped out tensor which is used
+  // before being swapped in by this API, or by a graph sync which has it as
+  // input, gets uploaded on its own. Callers about to use many swapped out
+  // tensors should swap them in with a single call to this API first.
+  static void SwapInTensors(std::vector<XLATensor>* tensors);
+
   //////////////////////////////////////////////////////////////////////////////
   // ATEN operators follows here, listed in alphabetical order.
   //////////////////////////////////////////////////////////////////////////////
@@ -528,6 +582,11 @@ class XLATensor {
       xla::int64 start_dim, const XLATensor& values, bool accumulate,
       tensorflow::gtl::ArraySlice<const xla::int64> result_permutation);
 
+  // Puts values into the input tensor at the positions selected by a boolean
+  // mask over its leading dimensions, without expanding the mask into indices.
+  static void index_put_(XLATensor& input, const XLATensor& mask,
+                         const XLATensor& values, bool accumulate);
+
   static XLATensor index_select(const XLATensor& input, xla::int64 dim,
                                 const XLATensor& index);
 
@@ -604,7 +663,15 @@ class XLATensor {
   static void masked_fill_(XLATensor& input, const XLATensor& mask,
                            at::Scalar value);
 
-  static XLATensor masked_select(const XLATensor& input, const XLATensor& mask);
+  static void masked_scatter_(XLATensor& input, const XLATensor& mask,
+                              const XLATensor& source);
+
+  // Returns the selected elements padded to the number of elements of the
+  // input, and the Int count of the valid ones. See the ir::ops::MaskedSelect
+  // node for the meaning of dynamic.
+  static std::tuple<XLATensor, XLATensor> masked_select(const XLATensor& input,
+                                                        const XLATensor& mask,
+                                                        bool dynamic);
 
   static XLATensor matmul(const XLATensor& input, const XLATensor& other);
 
@@ -704,7 +771,11 @@ class XLATensor {
                                      xla::int64 reduction, int ignore_index,
                                      const XLATensor& total_weight);
 
-  static XLATensor nonzero(const XLATensor& input);
+  // Returns the indices of the nonzero elements padded to the number of
+  // elements of the input, and the Int count of the valid ones. See the
+  // ir::ops::NonZero node for the meaning of dynamic.
+  static std::tuple<XLATensor, XLATensor> nonzero(const XLATensor& input,
+                                                  bool dynamic);
 
   static XLATensor norm(const XLATensor& input, c10::optional<at::Scalar> p,
                         c10::optional<at::ScalarType> dtype,
@@ -1061,6 +1132,14 @@ class XLATensor {
     const Device device;
     const xla::int64 unique_id = 0;
     size_t generation = 1;
+    // The step number (see MarkStep()) in which the tensor has been last used.
+    // Tensors can be used concurrently from multiple threads, hence atomic.
+    std::atomic<size_t> last_use_step{0};
+    // Whether the device data has been moved to tensor_data by the swap policy,
+    // and needs to be uploaded again upon next use.
+    bool swapped_out = false;
+    // Whether the tensor_data is within the queued device uploads.
+    bool upload_queued = false;
   };
 
   XLATensor(const at::Tensor& tensor, const Device& device);
@@ -1088,6 +1167,26 @@ class XLATensor {
 
   void SetTensorData(at::Tensor tensor_data);
 
+  // Records the tensor as used within the current step.
+  void MarkUsed() const;
+
+  // Whether the tensor holds device data which can be moved to host memory.
+  bool IsSwappable() const;
+
+  // Drops the device data of a tensor whose value is available as tensor_data.
+  void ReleaseSwappedXlaData();
+
+  // Uploads the data of a tensor which has been swapped out, back to device,
+  // using a SwapInTensors() batch of one tensor.
+  xla::ComputationClient::DataPtr SwapIn();
+
+  static std::vector<std::weak_ptr<Data>>* GetQueuedUploads();
+
+  // Uploads the tensors queued by QueueDeviceUpload() with a single transfer.
+  static void UploadQueuedTensors();
+
+  static void ClearQueuedUploads();
+
   View::IrNode GetViewUpdate(const std::shared_ptr<View>& view) const;
 
   std::shared_ptr<View> UpdateView(std::shared_ptr<View> view,
@@ -1170,6 +1269,11 @@ class XLATensor {
 
   static ir::Value CreateTensorNode(xla::ComputationClient::DataPtr data);
 
+  // If the XLA_DEVICE_MEMORY_BUDGET environment variable is set, and the device
+  // bytes held by the live tensors exceed such budget, swaps out the least
+  // recently used tensors until the budget is met.
+  static void ApplyDeviceMemoryBudget(const Device* device);
+
   static xla::int64 GetNextTensorId();
 
   std::shared_ptr<Data> data_;
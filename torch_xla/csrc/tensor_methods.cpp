@@ -34,6 +34,8 @@
 #include "torch_xla/csrc/ops/constant_pad_nd.h"
 #include "torch_xla/csrc/ops/convolution_backward_overrideable.h"
 #include "torch_xla/csrc/ops/convolution_overrideable.h"
+#include "torch_xla/csrc/ops/cross_entropy.h"
+#include "torch_xla/csrc/ops/cross_entropy_backward.h"
 #include "torch_xla/csrc/ops/cumprod.h"
 #include "torch_xla/csrc/ops/cumsum.h"
 #include "torch_xla/csrc/ops/device_data.h"
@@ -56,6 +58,7 @@
 #include "torch_xla/csrc/ops/linear_interpolation.h"
 #include "torch_xla/csrc/ops/log_softmax.h"
 #include "torch_xla/csrc/ops/masked_fill.h"
+#include "torch_xla/csrc/ops/masked_scatter.h"
 #include "torch_xla/csrc/ops/masked_select.h"
 #include "torch_xla/csrc/ops/max_in_dim.h"
 #include "torch_xla/csrc/ops/max_pool_nd.h"
@@ -255,6 +258,18 @@ ViewInfo CreateAsStridedViewInfo(
                   std::move(as_strided_info));
 }
 
+// Returns the LogSoftmax node producing the value, if that is a log-softmax
+// along the classes dimension which can be fused with the NLL loss.
+const ir::ops::LogSoftmax* GetFusableLogSoftmax(const ir::Value& value) {
+  const ir::ops::LogSoftmax* log_softmax =
+      dynamic_cast<const ir::ops::LogSoftmax*>(value.node.get());
+  if (log_softmax == nullptr || log_softmax->dim() != 1 ||
+      log_softmax->dtype() || value.shape().rank() != 2) {
+    return nullptr;
+  }
+  return log_softmax;
+}
+
 }  // namespace
 
 XLATensor XLATensor::__and__(const XLATensor& input, at::Scalar other) {
@@ -582,25 +597,35 @@ XLATensor XLATensor::avg_pool_nd_backward(
 }
 
 XLATensor XLATensor::bernoulli(const XLATensor& input, double probability) {
+  xla::int64 rng_offset;
+  ir::Value seed = GetRngSeed(input.GetDevice(), &rng_offset);
   return input.CreateFrom(ir::ops::Bernoulli(
       input.GetIrValue(),
-      GetIrValueForScalar(probability, input.shape(), input.GetDevice())));
+      GetIrValueForScalar(probability, input.shape(), input.GetDevice()), seed,
+      rng_offset));
 }
 
 XLATensor XLATensor::bernoulli(const XLATensor& input) {
-  return input.CreateFrom(
-      ir::ops::Bernoulli(input.GetIrValue(), input.GetIrValue()));
+  xla::int64 rng_offset;
+  ir::Value seed = GetRngSeed(input.GetDevice(), &rng_offset);
+  return input.CreateFrom(ir::ops::Bernoulli(
+      input.GetIrValue(), input.GetIrValue(), seed, rng_offset));
 }
 
 void XLATensor::bernoulli_(XLATensor& input, double probability) {
+  xla::int64 rng_offset;
+  ir::Value seed = GetRngSeed(input.GetDevice(), &rng_offset);
   input.SetIrValue(ir::ops::Bernoulli(
       input.GetIrValue(),
-      GetIrValueForScalar(probability, input.shape(), input.GetDevice())));
+      GetIrValueForScalar(probability, input.shape(), input.GetDevice()), seed,
+      rng_offset));
 }
 
 void XLATensor::bernoulli_(XLATensor& input, const XLATensor& probability) {
-  input.SetIrValue(
-      ir::ops::Bernoulli(input.GetIrValue(), probability.GetIrValue()));
+  xla::int64 rng_offset;
+  ir::Value seed = GetRngSeed(input.GetDevice(), &rng_offset);
+  input.SetIrValue(ir::ops::Bernoulli(
+      input.GetIrValue(), probability.GetIrValue(), seed, rng_offset));
 }
 
 XLATensor XLATensor::binary_cross_entropy(const XLATensor& input,
@@ -1207,6 +1232,11 @@ void XLATensor::index_put_(
                                      accumulate, result_permutation));
 }
 
+void XLATensor::index_put_(XLATensor& input, const XLATensor& mask,
+                           const XLATensor& values, bool accumulate) {
+  input.SetIrValue(IndexPutByMask(input, mask, values, accumulate));
+}
+
 XLATensor XLATensor::index_select(const XLATensor& input, xla::int64 dim,
                                   const XLATensor& index) {
   ir::Value index_value = EnsureRank1(index.GetIrValue());
@@ -1358,8 +1388,28 @@ XLATensor XLATensor::log_softmax(const XLATensor& input, xla::int64 dim,
 XLATensor XLATensor::log_softmax_backward(const XLATensor& grad_output,
                                           const XLATensor& output,
                                           xla::int64 dim) {
-  return grad_output.CreateFrom(ir::ops::LogSoftmaxBackwardOp(
-      grad_output.GetIrValue(), output.GetIrValue(), dim));
+  ir::Value grad_output_value = grad_output.GetIrValue();
+  ir::Value output_value = output.GetIrValue();
+  // The NLL loss gradient with respect to the log-probabilities, followed by
+  // the log-softmax one, is computed straight out of the logits.
+  const ir::ops::NllLossBackward* nll_loss_backward =
+      dynamic_cast<const ir::ops::NllLossBackward*>(
+          grad_output_value.node.get());
+  const ir::ops::LogSoftmax* log_softmax = GetFusableLogSoftmax(output_value);
+  if (nll_loss_backward != nullptr && log_softmax != nullptr &&
+      nll_loss_backward->operand(1) == ir::Output(output_value)) {
+    XLA_COUNTER("FusedCrossEntropyBackward", 1);
+    absl::optional<ir::Value> weight;
+    if (nll_loss_backward->operands().size() > 3) {
+      weight = nll_loss_backward->operand_value(3);
+    }
+    return grad_output.CreateFrom(ir::MakeNode<ir::ops::CrossEntropyBackward>(
+        nll_loss_backward->operand_value(0), log_softmax->operand_value(0),
+        nll_loss_backward->operand_value(2), weight,
+        nll_loss_backward->reduction(), nll_loss_backward->ignore_index()));
+  }
+  return grad_output.CreateFrom(
+      ir::ops::LogSoftmaxBackwardOp(grad_output_value, output_value, dim));
 }
 
 XLATensor XLATensor::log1p(const XLATensor& input) {
@@ -1405,11 +1455,23 @@ void XLATensor::masked_fill_(XLATensor& input, const XLATensor& mask,
                                                      expanded_mask, value));
 }
 
-XLATensor XLATensor::masked_select(const XLATensor& input,
-                                   const XLATensor& mask) {
-  ir::NodePtr node = ir::MakeNode<ir::ops::MaskedSelect>(input.GetIrValue(),
-                                                         mask.GetIrValue());
-  return input.CreateFrom(ir::Value(node, 0));
+void XLATensor::masked_scatter_(XLATensor& input, const XLATensor& mask,
+                                const XLATensor& source) {
+  // Expand mask to be the same size as input.
+  ir::NodePtr expanded_mask = ir::MakeNode<ir::ops::Expand>(
+      mask.GetIrValue(),
+      xla::util::ToVector<xla::int64>(input.shape().get().dimensions()));
+  input.SetIrValue(ir::MakeNode<ir::ops::MaskedScatter>(
+      input.GetIrValue(), expanded_mask, source.GetIrValue()));
+}
+
+std::tuple<XLATensor, XLATensor> XLATensor::masked_select(
+    const XLATensor& input, const XLATensor& mask, bool dynamic) {
+  ir::NodePtr node = ir::MakeNode<ir::ops::MaskedSelect>(
+      input.GetIrValue(), mask.GetIrValue(), dynamic);
+  return std::make_tuple(
+      input.CreateFrom(ir::Value(node, 0)),
+      input.CreateFrom(ir::Value(node, 1), at::ScalarType::Int));
 }
 
 XLATensor XLATensor::matmul(const XLATensor& input, const XLATensor& other) {
@@ -1672,8 +1734,18 @@ void XLATensor::neg_(XLATensor& input) {
 XLATensor XLATensor::nll_loss(const XLATensor& input, const XLATensor& target,
                               const XLATensor& weight, xla::int64 reduction,
                               int ignore_index) {
+  ir::Value input_value = input.GetIrValue();
+  const ir::ops::LogSoftmax* log_softmax = GetFusableLogSoftmax(input_value);
+  if (log_softmax != nullptr) {
+    // The log-probabilities are not materialized, unless used somewhere else.
+    XLA_COUNTER("FusedCrossEntropy", 1);
+    return input.CreateFrom(ir::MakeNode<ir::ops::CrossEntropy>(
+        log_softmax->operand_value(0), target.GetIrValue(),
+        GetOptionalIrValue(weight), GetXlaReductionMode(reduction),
+        ignore_index));
+  }
   return input.CreateFrom(ir::MakeNode<ir::ops::NllLoss>(
-      input.GetIrValue(), target.GetIrValue(), GetOptionalIrValue(weight),
+      input_value, target.GetIrValue(), GetOptionalIrValue(weight),
       GetXlaReductionMode(reduction), ignore_index));
 }
 
@@ -1689,9 +1761,13 @@ XLATensor XLATensor::nll_loss_backward(const XLATensor& grad_output,
       GetXlaReductionMode(reduction), ignore_index));
 }
 
-XLATensor XLATensor::nonzero(const XLATensor& input) {
-  ir::NodePtr node = ir::MakeNode<ir::ops::NonZero>(input.GetIrValue());
-  return input.CreateFrom(ir::Value(node, 0), at::ScalarType::Long);
+std::tuple<XLATensor, XLATensor> XLATensor::nonzero(const XLATensor& input,
+                                                    bool dynamic) {
+  ir::NodePtr node =
+      ir::MakeNode<ir::ops::NonZero>(input.GetIrValue(), dynamic);
+  return std::make_tuple(
+      input.CreateFrom(ir::Value(node, 0), at::ScalarType::Long),
+      input.CreateFrom(ir::Value(node, 1), at::ScalarType::Int));
 }
 
 XLATensor XLATensor::norm(const XLATensor& input, c10::optional<at::Scalar> p,
@@ -1777,7 +1853,10 @@ std::tuple<XLATensor, XLATensor> XLATensor::qr(const XLATensor& input,
 void XLATensor::randperm_out(XLATensor& out, xla::int64 n) {
   xla::PrimitiveType xla_element_type =
       GetDevicePrimitiveType(xla::PrimitiveType::S64, &out.GetDevice());
-  out.SetIrValue(ir::MakeNode<ir::ops::Randperm>(n, xla_element_type));
+  xla::int64 rng_offset;
+  ir::Value seed = GetRngSeed(out.GetDevice(), &rng_offset);
+  out.SetIrValue(ir::MakeNode<ir::ops::Randperm>(seed, n, xla_element_type,
+                                                 rng_offset));
 }
 
 XLATensor XLATensor::reciprocal(const XLATensor& input) {
@@ -1854,8 +1933,10 @@ void XLATensor::resize_(XLATensor& input, std::vector<xla::int64> size) {
 XLATensor XLATensor::rrelu_with_noise(const XLATensor& input, XLATensor& noise,
                                       at::Scalar lower, at::Scalar upper,
                                       bool training) {
+  xla::int64 rng_offset;
+  ir::Value seed = GetRngSeed(input.GetDevice(), &rng_offset);
   ir::NodePtr output_node = ir::MakeNode<ir::ops::RreluWithNoise>(
-      input.GetIrValue(), lower, upper, training);
+      input.GetIrValue(), seed, lower, upper, training, rng_offset);
   noise.SetIrValue(ir::Value(output_node, 1));
   return input.CreateFrom(ir::Value(output_node, 0));
 }
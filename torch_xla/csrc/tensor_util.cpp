@@ -370,6 +370,8 @@ void TensorToBufferSType(const at::Tensor& tensor, const xla::Shape& dest_shape,
   }
 }
 
+}  // namespace
+
 void PopulateTensorBuffer(const at::Tensor& tensor,
                           const xla::Shape& dest_shape, void* dest_buffer,
                           size_t dest_buffer_size, const Device& device) {
@@ -415,6 +417,8 @@ void PopulateTensorBuffer(const at::Tensor& tensor,
   }
 }
 
+namespace {
+
 xla::ComputationClient::DataPtr TensorToXlaData(const at::Tensor& tensor,
                                                 const xla::Shape& shape,
                                                 const Device& device) {
@@ -563,30 +567,58 @@ xla::Literal GetTensorLiteral(const at::Tensor& tensor, const xla::Shape* shape,
 }
 
 size_t TensorHash(const at::Tensor& tensor) {
-  at::Tensor ctensor = tensor.contiguous();
-  int64_t size = ctensor.numel() * ctensor.element_size();
-  switch (ctensor.scalar_type()) {
+  switch (tensor.scalar_type()) {
     case at::ScalarType::Bool:
-      return xla::util::DataHash(ctensor.data_ptr<bool>(), size);
     case at::ScalarType::Byte:
-      return xla::util::DataHash(ctensor.data_ptr<uint8_t>(), size);
     case at::ScalarType::Char:
-      return xla::util::DataHash(ctensor.data_ptr<int8_t>(), size);
     case at::ScalarType::Short:
-      return xla::util::DataHash(ctensor.data_ptr<int16_t>(), size);
     case at::ScalarType::Int:
-      return xla::util::DataHash(ctensor.data_ptr<int32_t>(), size);
     case at::ScalarType::Long:
-      return xla::util::DataHash(ctensor.data_ptr<int64_t>(), size);
     case at::ScalarType::Float:
-      return xla::util::DataHash(ctensor.data_ptr<float>(), size);
     case at::ScalarType::Double:
-      return xla::util::DataHash(ctensor.data_ptr<double>(), size);
     case at::ScalarType::BFloat16:
-      return xla::util::DataHash(ctensor.data_ptr<at::BFloat16>(), size);
+      break;
     default:
-      XLA_ERROR() << "Unsupported scalar type: " << ctensor.scalar_type();
+      XLA_ERROR() << "Unsupported scalar type: " << tensor.scalar_type();
+  }
+  // Strided tensors whose innermost dimension rows are dense, and big enough
+  // to be fed in bulk to the hasher, are hashed one row at a time in logical
+  // order. This matches the hash of the contiguous version of the tensor,
+  // without having to create it. Every other layout is made contiguous first.
+  static const int64_t kMinRowBytes = 64;
+  int64_t element_size = tensor.element_size();
+  int64_t rank = tensor.dim();
+  if (tensor.is_contiguous() || tensor.numel() == 0 ||
+      tensor.stride(rank - 1) != 1 ||
+      tensor.size(rank - 1) * element_size < kMinRowBytes) {
+    at::Tensor ctensor = tensor.contiguous();
+    return xla::util::DataHash(ctensor.data_ptr(),
+                               ctensor.numel() * element_size);
+  }
+  const char* data = static_cast<const char*>(tensor.data_ptr());
+  auto sizes = tensor.sizes();
+  auto strides = tensor.strides();
+  int64_t row_bytes = sizes[rank - 1] * element_size;
+  std::vector<int64_t> indices(rank - 1, 0);
+  xla::util::FastHasher hasher(xla::util::kDataHashSeed);
+  while (true) {
+    const char* row = data;
+    for (int64_t i = 0; i < rank - 1; ++i) {
+      row += indices[i] * strides[i] * element_size;
+    }
+    hasher.Update(row, row_bytes);
+    int64_t dim = rank - 2;
+    for (; dim >= 0; --dim) {
+      if (++indices[dim] < sizes[dim]) {
+        break;
+      }
+      indices[dim] = 0;
+    }
+    if (dim < 0) {
+      break;
+    }
   }
+  return hasher.Digest();
 }
 
 std::vector<xla::Shape> GetComponentShapes(const xla::Shape& shape) {
@@ -26,6 +26,12 @@ xla::ComputationClient::DataPtr TensorToXlaData(const at::Tensor& tensor,
 
 size_t TensorHash(const at::Tensor& tensor);
 
+// Copies the ATEN tensor data into dest_buffer, converting it to the element
+// type and layout of dest_shape.
+void PopulateTensorBuffer(const at::Tensor& tensor,
+                          const xla::Shape& dest_shape, void* dest_buffer,
+                          size_t dest_buffer_size, const Device& device);
+
 // Retrieves the device data handles by parallel uploading data onto the
 // corresponding devices.
 std::vector<xla::ComputationClient::DataPtr> CreateTensorsData(
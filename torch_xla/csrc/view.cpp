@@ -1,16 +1,19 @@
 #include "torch_xla/csrc/view.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <functional>
 #include <numeric>
 
 #include "tensorflow/compiler/xla/shape_util.h"
 #include "tensorflow/compiler/xla/util.h"
 #include "tensorflow/compiler/xla/xla_client/debug_macros.h"
+#include "tensorflow/compiler/xla/xla_client/metrics.h"
 #include "tensorflow/compiler/xla/xla_client/util.h"
 #include "torch_xla/csrc/helpers.h"
 #include "torch_xla/csrc/ops/as_strided.h"
 #include "torch_xla/csrc/ops/as_strided_view_update.h"
+#include "torch_xla/csrc/ops/device_data.h"
 #include "torch_xla/csrc/ops/diagonal.h"
 #include "torch_xla/csrc/ops/diagonal_view_update.h"
 #include "torch_xla/csrc/ops/generic_slice.h"
@@ -20,7 +23,9 @@
 #include "torch_xla/csrc/ops/select.h"
 #include "torch_xla/csrc/ops/unselect.h"
 #include "torch_xla/csrc/ops/update_slice.h"
+#include "torch_xla/csrc/ops/update_slices.h"
 #include "torch_xla/csrc/ops/view.h"
+#include "torch_xla/csrc/tensor_util.h"
 
 namespace torch_xla {
 namespace {
@@ -115,6 +120,172 @@ ir::Value ApplyUpdate(ir::Value ir_value,
   return result;
 }
 
+// Tries to fold view_info into last, which precedes it within a view chain.
+// Returns true if last now represents the composition of the two.
+bool MergeViewInfo(ViewInfo* last, const ViewInfo& view_info) {
+  if (last->view_type != view_info.view_type) {
+    return false;
+  }
+  switch (view_info.view_type) {
+    case ViewInfo::Type::kNarrow:
+      for (size_t i = 0; i < last->indices.size(); ++i) {
+        last->indices[i] += view_info.indices[i];
+      }
+      break;
+    case ViewInfo::Type::kPermute:
+      last->permutation =
+          XlaHelpers::Permute(view_info.permutation, last->permutation);
+      break;
+    case ViewInfo::Type::kReshape:
+      break;
+    default:
+      return false;
+  }
+  last->shape = view_info.shape;
+  return true;
+}
+
+bool IsIdentityView(const ViewInfo& view_info) {
+  switch (view_info.view_type) {
+    case ViewInfo::Type::kNoOp:
+      return true;
+    case ViewInfo::Type::kPermute:
+      return view_info.permutation ==
+             xla::util::Iota<xla::int64>(view_info.permutation.size());
+    case ViewInfo::Type::kReshape:
+      return xla::util::ToVector<xla::int64>(view_info.shape.dimensions()) ==
+             view_info.sizes;
+    default:
+      return false;
+  }
+}
+
+// Appends view_info to the view chain, composing it with the last view of the
+// chain when possible, so that the IR generated by the chain forward and
+// backward applications does not grow with the number of chained views.
+void AppendViewInfo(std::vector<ViewInfo>* view_infos, ViewInfo view_info) {
+  if (view_info.view_type == ViewInfo::Type::kSelect &&
+      view_info.select->stride == 1) {
+    // A select with unit stride is a narrow, which composes with other ones.
+    ViewInfo narrow_info(ViewInfo::Type::kNarrow, view_info.shape,
+                         view_info.sizes);
+    narrow_info.indices[view_info.select->dim] = view_info.select->start;
+    view_info = std::move(narrow_info);
+  }
+  if (!view_infos->empty() && MergeViewInfo(&view_infos->back(), view_info)) {
+    if (IsIdentityView(view_infos->back())) {
+      view_infos->pop_back();
+    }
+  } else if (!IsIdentityView(view_info)) {
+    view_infos->push_back(std::move(view_info));
+  }
+}
+
+// Returns true if the update writes a slice of the alias, possibly through a
+// reshape of the slice, which is what select() and integer indexing produce.
+bool IsSliceUpdate(const Alias::UpdateData& update_data) {
+  const std::vector<ViewInfo>& view_infos = update_data.view_infos;
+  return (view_infos.size() == 1 || view_infos.size() == 2) &&
+         view_infos[0].view_type == ViewInfo::Type::kNarrow &&
+         (view_infos.size() == 1 ||
+          view_infos[1].view_type == ViewInfo::Type::kReshape);
+}
+
+bool SliceContains(const ViewInfo& outer, const ViewInfo& inner) {
+  for (size_t i = 0; i < outer.indices.size(); ++i) {
+    if (inner.indices[i] < outer.indices[i] ||
+        inner.indices[i] + inner.shape.dimensions(i) >
+            outer.indices[i] + outer.shape.dimensions(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns true if two slices of the same size share at least one element.
+bool SlicesOverlap(const ViewInfo& info1, const ViewInfo& info2) {
+  for (size_t i = 0; i < info1.indices.size(); ++i) {
+    if (std::abs(info1.indices[i] - info2.indices[i]) >=
+        info1.shape.dimensions(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Writes a group of equally sized and non overlapping slice updates with a
+// single scatter, whose base indices are uploaded as device data so that they
+// do not become part of the graph hash.
+ir::Value ApplySliceUpdateGroup(
+    ir::Value ir_value,
+    const std::vector<const Alias::UpdateData*>& slice_updates,
+    const Device& device) {
+  if (slice_updates.size() == 1) {
+    return ApplyUpdate(ir_value, *slice_updates.front());
+  }
+  const ViewInfo& first_info = slice_updates.front()->view_infos.front();
+  int64_t rank = first_info.indices.size();
+  at::Tensor indices =
+      at::empty({static_cast<int64_t>(slice_updates.size()), rank},
+                at::TensorOptions(at::kInt));
+  auto indices_accessor = indices.accessor<int32_t, 2>();
+  std::vector<ir::Value> sources;
+  sources.reserve(slice_updates.size());
+  for (size_t i = 0; i < slice_updates.size(); ++i) {
+    const ViewInfo& slice_info = slice_updates[i]->view_infos.front();
+    for (int64_t j = 0; j < rank; ++j) {
+      indices_accessor[i][j] = slice_info.indices[j];
+    }
+    sources.push_back(slice_updates[i]->ir_value);
+  }
+  XLA_COUNTER("ViewSliceUpdatesScattered", slice_updates.size());
+  return ir::MakeNode<ir::ops::UpdateSlices>(
+      ir_value,
+      ir::MakeNode<ir::ops::DeviceData>(TensorToXlaData(indices, device)),
+      sources,
+      xla::util::ToVector<xla::int64>(first_info.shape.dimensions()));
+}
+
+// Applies the slice updates within the [start, end) range. The updates whose
+// slice is fully overwritten by a later one are dropped, and runs of the
+// remaining ones which have the same size and do not overlap are written with
+// a single IR node. Overlapping slices start a new run, so that later updates
+// still overwrite earlier ones.
+ir::Value ApplySliceUpdates(ir::Value ir_value,
+                            const std::vector<Alias::UpdateData>& updates,
+                            size_t start, size_t end, const Device& device) {
+  std::vector<const Alias::UpdateData*> live_updates;
+  for (size_t i = end; i > start; --i) {
+    const ViewInfo& slice_info = updates[i - 1].view_infos.front();
+    auto overwritten = [&](const Alias::UpdateData* update_data) {
+      return SliceContains(update_data->view_infos.front(), slice_info);
+    };
+    if (std::none_of(live_updates.begin(), live_updates.end(), overwritten)) {
+      live_updates.push_back(&updates[i - 1]);
+    }
+  }
+  XLA_COUNTER("ViewSliceUpdates", end - start);
+  XLA_COUNTER("ViewSliceUpdatesOverwritten",
+              end - start - live_updates.size());
+  std::vector<const Alias::UpdateData*> slice_updates;
+  for (auto it = live_updates.rbegin(); it != live_updates.rend(); ++it) {
+    const ViewInfo& slice_info = (*it)->view_infos.front();
+    auto overlaps = [&](const Alias::UpdateData* update_data) {
+      return SlicesOverlap(update_data->view_infos.front(), slice_info);
+    };
+    if (!slice_updates.empty() &&
+        (!xla::ShapeUtil::SameDimensions(
+             slice_updates.front()->view_infos.front().shape,
+             slice_info.shape) ||
+         std::any_of(slice_updates.begin(), slice_updates.end(), overlaps))) {
+      ir_value = ApplySliceUpdateGroup(ir_value, slice_updates, device);
+      slice_updates.clear();
+    }
+    slice_updates.push_back(*it);
+  }
+  return ApplySliceUpdateGroup(ir_value, slice_updates, device);
+}
+
 }  // namespace
 
 ViewInfo::ViewInfo(Type view_type, xla::Shape shape,
@@ -173,8 +344,21 @@ void Alias::Update(ir::Value ir_value, std::vector<ViewInfo> view_infos) {
 }
 
 ir::Value Alias::SyncUpdateOperations() {
-  for (auto& update_data : updates_) {
-    ir_value_ = ApplyUpdate(ir_value_, update_data);
+  size_t start = 0;
+  while (start < updates_.size()) {
+    // Runs of consecutive slice updates are coalesced, as they are what loops
+    // writing into many slices of the same tensor produce.
+    size_t end = start;
+    while (end < updates_.size() && IsSliceUpdate(updates_[end])) {
+      ++end;
+    }
+    if (end - start > 1) {
+      ir_value_ = ApplySliceUpdates(ir_value_, updates_, start, end, device_);
+      start = end;
+    } else {
+      ir_value_ = ApplyUpdate(ir_value_, updates_[start]);
+      ++start;
+    }
   }
   updates_.clear();
   return ir_value_;
@@ -182,14 +366,16 @@ ir::Value Alias::SyncUpdateOperations() {
 
 View::View(xla::Shape shape, std::shared_ptr<Alias> alias, ViewInfo view_info)
     : shape_(std::move(shape)), alias_(std::move(alias)) {
-  view_infos_.push_back(std::move(view_info));
+  AppendViewInfo(&view_infos_, std::move(view_info));
 }
 
 View::View(xla::Shape shape, std::shared_ptr<Alias> alias,
            std::vector<ViewInfo> view_infos)
-    : view_infos_(std::move(view_infos)),
-      shape_(std::move(shape)),
-      alias_(std::move(alias)) {}
+    : shape_(std::move(shape)), alias_(std::move(alias)) {
+  for (auto& view_info : view_infos) {
+    AppendViewInfo(&view_infos_, std::move(view_info));
+  }
+}
 
 void View::Update(ir::Value ir_value) {
   alias_->Update(std::move(ir_value), view_infos_);
@@ -198,7 +384,7 @@ void View::Update(ir::Value ir_value) {
 std::shared_ptr<View> View::CreateSubView(xla::Shape shape,
                                           ViewInfo view_info) {
   std::vector<ViewInfo> view_infos(view_infos_);
-  view_infos.push_back(std::move(view_info));
+  AppendViewInfo(&view_infos, std::move(view_info));
   return std::make_shared<View>(std::move(shape), alias_,
                                 std::move(view_infos));
 }
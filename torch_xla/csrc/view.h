@@ -6,6 +6,7 @@
 #include "absl/types/optional.h"
 #include "tensorflow/compiler/xla/shape.h"
 #include "tensorflow/compiler/xla/types.h"
+#include "torch_xla/csrc/device.h"
 #include "torch_xla/csrc/ir.h"
 
 namespace torch_xla {
@@ -98,7 +99,8 @@ class Alias {
     std::vector<ViewInfo> view_infos;
   };
 
-  explicit Alias(ir::Value ir_value) : ir_value_(std::move(ir_value)) {}
+  Alias(ir::Value ir_value, Device device)
+      : ir_value_(std::move(ir_value)), device_(std::move(device)) {}
 
   const ir::Value& ir_value() const { return ir_value_; }
 
@@ -111,11 +113,16 @@ class Alias {
   // the alias's ir_value to the update ir_value.
   void Update(ir::Value ir_value, std::vector<ViewInfo> view_infos);
 
+  // Applies the stacked updates to the IR value of the alias, and returns it.
+  // Consecutive updates of equally sized, non overlapping, slices of the alias
+  // are applied with a single IR node.
   ir::Value SyncUpdateOperations();
 
  private:
   // The IR value which is the root at which the view was created.
   ir::Value ir_value_;
+  // The device holding the alias, where the slice update indices are uploaded.
+  Device device_;
   // The stacked updates on the view. Orders matter, as most recent updates
   // might overwrite older ones.
   std::vector<UpdateData> updates_;
@@ -15,6 +15,8 @@
 #include "torch_xla/csrc/convert_ops.h"
 #include "torch_xla/csrc/data_ops.h"
 #include "torch_xla/csrc/helpers.h"
+#include "torch_xla/csrc/random.h"
+#include "torch_xla/csrc/reduction.h"
 #include "torch_xla/csrc/tensor_util.h"
 
 namespace torch_xla {
@@ -240,7 +242,30 @@ xla::XlaOp XlaDenseScatter(
   });
 }
 
-std::vector<xla::XlaOp> BuildConditionIndices(const xla::XlaOp& condition) {
+// Returns a PRED tensor of the given size, which is true for the elements whose
+// index along the first dimension is lower than length.
+xla::XlaOp CreateValidPrefixMask(
+    const xla::XlaOp& length,
+    tensorflow::gtl::ArraySlice<const xla::int64> sizes) {
+  xla::Shape iota_shape =
+      xla::ShapeUtil::MakeShape(xla::PrimitiveType::S32, sizes);
+  return xla::Lt(xla::Iota(length.builder(), iota_shape, 0), length);
+}
+
+// Zeroes the padding elements past the valid prefix of length elements, or
+// marks the first dimension as dynamic if the dynamic flag is set.
+xla::XlaOp SetValidPrefix(const xla::XlaOp& padded, const xla::XlaOp& length,
+                          bool dynamic) {
+  if (dynamic) {
+    return xla::SetDimensionSize(padded, length, 0);
+  }
+  const xla::Shape& shape = XlaHelpers::ShapeOfXlaOp(padded);
+  return xla::Select(CreateValidPrefixMask(length, shape.dimensions()), padded,
+                     xla::ZerosLike(padded));
+}
+
+std::vector<xla::XlaOp> BuildConditionIndices(const xla::XlaOp& condition,
+                                              bool dynamic) {
   ConditionMaskData cmd = CreateConditionMaskData(condition);
   std::vector<xla::XlaOp> to_sort = {cmd.reshaped_condition_int};
   std::vector<xla::PrimitiveType> types_to_sort = {xla::PrimitiveType::S32};
@@ -264,8 +289,7 @@ std::vector<xla::XlaOp> BuildConditionIndices(const xla::XlaOp& condition) {
   }
 
   xla::XlaOp result = xla::ConcatInDim(condition.builder(), to_concat, 1);
-  xla::XlaOp result_padded = xla::SetDimensionSize(result, cmd.length, 0);
-  return {result_padded, cmd.length};
+  return {SetValidPrefix(result, cmd.length, dynamic), cmd.length};
 }
 
 }  // namespace
@@ -403,30 +427,22 @@ xla::XlaOp CreateMatMul(const xla::XlaOp& lhs, const xla::XlaOp& rhs) {
 }
 
 xla::XlaOp BuildBernoulli(const xla::XlaOp& probability,
+                          const xla::XlaOp& seed, xla::int64 rng_offset,
                           const xla::Shape& shape) {
   const xla::Shape& probability_shape = XlaHelpers::ShapeOfXlaOp(probability);
   xla::XlaOp zero = XlaHelpers::ScalarValue<float>(
       0, probability_shape.element_type(), probability.builder());
   xla::XlaOp one = XlaHelpers::ScalarValue<float>(
       1, probability_shape.element_type(), probability.builder());
-  xla::XlaOp noise = xla::RngUniform(zero, one, probability_shape);
+  xla::XlaOp noise =
+      BuildRngUniform(seed, rng_offset, probability_shape, zero, one);
   return xla::ConvertElementType(xla::Lt(noise, probability),
                                  shape.element_type());
 }
 
-xla::XlaOp BuildDropout(const xla::XlaOp& input, float probability) {
-  const xla::Shape& shape = XlaHelpers::ShapeOfXlaOp(input);
-  xla::XlaOp prob =
-      XlaHelpers::ScalarBroadcast<float>(probability, shape, input.builder());
-  xla::XlaOp mask = BuildBernoulli(prob, shape);
-  if (probability > 0.0f) {
-    mask = mask / prob;
-  }
-  return input * mask;
-}
-
 xla::XlaOp BuildRandperm(xla::int64 n, xla::PrimitiveType element_type,
-                         xla::XlaBuilder* builder) {
+                         const xla::XlaOp& seed, xla::int64 rng_offset) {
+  xla::XlaBuilder* builder = seed.builder();
   xla::XlaOp input = xla::Iota(builder, element_type, n);
   // Ensure that the key space is greater than or equal to the cube of the
   // number of values to manage the number of collisions. Inspired by
@@ -435,13 +451,16 @@ xla::XlaOp BuildRandperm(xla::int64 n, xla::PrimitiveType element_type,
   const int kExponent = 3;
   const int rounds = static_cast<int>(
       std::ceil(kExponent * std::log(n) / std::log(tensorflow::kuint32max)));
-  const xla::Shape key_shape = xla::ShapeUtil::MakeShape(xla::U32, {n});
-  xla::XlaOp zero = xla::ConstantR0(builder, 0U);
-  xla::XlaOp max_value = xla::ConstantR0(builder, tensorflow::kuint32max);
-
   xla::XlaOp curr = input;
+  if (rounds == 0) {
+    return curr;
+  }
+  // The keys of all the rounds are generated at once, as a random operation
+  // owns a single counter offset.
+  xla::XlaOp all_keys = BuildRngBits(seed, rng_offset, {rounds, n});
   for (int i = 0; i < rounds; ++i) {
-    xla::XlaOp keys = xla::RngUniform(zero, max_value, key_shape);
+    xla::XlaOp keys =
+        xla::Reshape(xla::SliceInDim(all_keys, i, i + 1, 1, 0), {n});
     xla::XlaOp sorted = xla::Sort(
         {keys, curr},
         xla::CreateScalarLtComputation({xla::U32, element_type}, builder));
@@ -655,14 +674,48 @@ xla::XlaOp CreatePut(const xla::XlaOp& input, const xla::XlaOp& index,
   return xla::Reshape(r1_scatter, input_shape.dimensions());
 }
 
-std::vector<xla::XlaOp> BuildNonZero(const xla::XlaOp& input) {
+xla::XlaOp BuildUpdateSlices(
+    const xla::XlaOp& input, const xla::XlaOp& indices,
+    tensorflow::gtl::ArraySlice<const xla::XlaOp> sources,
+    tensorflow::gtl::ArraySlice<const xla::int64> slice_sizes) {
+  const xla::Shape& input_shape = XlaHelpers::ShapeOfXlaOp(input);
+  std::vector<xla::int64> update_sizes({1});
+  update_sizes.insert(update_sizes.end(), slice_sizes.begin(),
+                      slice_sizes.end());
+  std::vector<xla::XlaOp> updates;
+  updates.reserve(sources.size());
+  for (auto& source : sources) {
+    xla::PrimitiveType source_type =
+        XlaHelpers::ShapeOfXlaOp(source).element_type();
+    xla::XlaOp update_source = source;
+    if (source_type != input_shape.element_type()) {
+      update_source = ConvertTo(source, source_type,
+                                input_shape.element_type(), /*device=*/nullptr);
+    }
+    updates.push_back(xla::Reshape(update_source, update_sizes));
+  }
+  xla::ScatterDimensionNumbers scatter_dnums;
+  scatter_dnums.set_index_vector_dim(1);
+  for (xla::int64 i = 0; i < input_shape.rank(); ++i) {
+    scatter_dnums.add_update_window_dims(i + 1);
+    scatter_dnums.add_scatter_dims_to_operand_dims(i);
+  }
+  return xla::Scatter(
+      input, indices, xla::ConcatInDim(input.builder(), updates, 0),
+      MakeScatterComputation(nullptr, input_shape.element_type()),
+      scatter_dnums);
+}
+
+std::vector<xla::XlaOp> BuildNonZero(const xla::XlaOp& input, bool dynamic) {
   const xla::Shape& input_shape = XlaHelpers::ShapeOfXlaOp(input);
   return BuildConditionIndices(
-      xla::Ne(input, xla::Zero(input.builder(), input_shape.element_type())));
+      xla::Ne(input, xla::Zero(input.builder(), input_shape.element_type())),
+      dynamic);
 }
 
 std::vector<xla::XlaOp> BuildMaskedSelect(const xla::XlaOp& input,
-                                          const xla::XlaOp& mask) {
+                                          const xla::XlaOp& mask,
+                                          bool dynamic) {
   xla::Shape input_shape;
   xla::XlaOp r1_input = XlaHelpers::Flatten(input, &input_shape);
   const xla::Shape& mask_shape = XlaHelpers::ShapeOfXlaOp(mask);
@@ -681,9 +734,49 @@ std::vector<xla::XlaOp> BuildMaskedSelect(const xla::XlaOp& input,
       /*dimension=*/0,
       /*is_stable=*/true);
   xla::XlaOp sorted_input = xla::GetTupleElement(sorted, 1);
-  xla::XlaOp sorted_input_padded =
-      xla::SetDimensionSize(sorted_input, cmd.length, 0);
-  return {sorted_input_padded, cmd.length};
+  return {SetValidPrefix(sorted_input, cmd.length, dynamic), cmd.length};
+}
+
+xla::XlaOp BuildMaskedScatter(const xla::XlaOp& input, const xla::XlaOp& mask,
+                              const xla::XlaOp& source) {
+  xla::Shape input_shape;
+  xla::XlaOp r1_input = XlaHelpers::Flatten(input, &input_shape);
+  xla::Shape source_shape;
+  xla::XlaOp r1_source = XlaHelpers::Flatten(source, &source_shape);
+  xla::int64 source_elements = xla::ShapeUtil::ElementsIn(source_shape);
+  if (source_elements == 0) {
+    // No element can be selected without erroring out, so the input is left
+    // as is.
+    return input;
+  }
+  const xla::Shape& mask_shape = XlaHelpers::ShapeOfXlaOp(mask);
+  xla::Shape promoted_mask_shape =
+      XlaHelpers::GetPromotedShape(mask_shape, input_shape);
+  xla::XlaOp bcast_mask =
+      XlaHelpers::ImplicitBroadcast(mask, mask_shape, promoted_mask_shape);
+  ConditionMaskData cmd =
+      CreateConditionMaskData(XlaHelpers::Flatten(bcast_mask));
+  xla::XlaOp zero = xla::Zero(input.builder(), xla::PrimitiveType::S32);
+  xla::XlaOp selected = xla::Gt(cmd.reshaped_condition_int, zero);
+  xla::XlaOp r1_mask_int =
+      xla::ConvertElementType(selected, xla::PrimitiveType::S32);
+  // The exclusive prefix sum of the mask is, for every selected element of the
+  // input, the position of the source element which goes in its place.
+  xla::XlaOp positions =
+      BuildCumulativeComputation(
+          r1_mask_int, 0,
+          xla::CreateScalarAddComputation(xla::PrimitiveType::S32,
+                                          input.builder()),
+          zero) -
+      r1_mask_int;
+  // Bound the positions anyway, so that a source smaller than the selected
+  // elements never results in out of bounds reads.
+  xla::XlaOp bound_positions =
+      xla::Min(positions, XlaHelpers::ScalarValue<xla::int32>(
+                              source_elements - 1, input.builder()));
+  xla::XlaOp gathered = xla::TorchIndexSelect(r1_source, bound_positions, 0);
+  xla::XlaOp r1_result = xla::Select(selected, gathered, r1_input);
+  return xla::Reshape(r1_result, input_shape.dimensions());
 }
 
 }  // namespace torch_xla
@@ -18,13 +18,14 @@ std::vector<xla::XlaOp> CreateTopK(const xla::XlaOp& input, xla::int64 k,
 
 xla::XlaOp CreateMatMul(const xla::XlaOp& lhs, const xla::XlaOp& rhs);
 
+// The random operations below take the RNG seed scalar and the counter offset
+// reserved for the operation, see BuildRngBits().
 xla::XlaOp BuildBernoulli(const xla::XlaOp& probability,
+                          const xla::XlaOp& seed, xla::int64 rng_offset,
                           const xla::Shape& shape);
 
-xla::XlaOp BuildDropout(const xla::XlaOp& input, float probability);
-
 xla::XlaOp BuildRandperm(xla::int64 n, xla::PrimitiveType element_type,
-                         xla::XlaBuilder* builder);
+                         const xla::XlaOp& seed, xla::int64 rng_offset);
 
 std::vector<xla::XlaOp> CreateBroadcastTensors(
     tensorflow::gtl::ArraySlice<const xla::XlaOp> operands);
@@ -62,9 +63,28 @@ xla::XlaOp CreateScatter(const xla::XlaOp& input, const xla::XlaOp& index,
 xla::XlaOp CreatePut(const xla::XlaOp& input, const xla::XlaOp& index,
                      const xla::XlaOp& source, bool accumulate);
 
-std::vector<xla::XlaOp> BuildNonZero(const xla::XlaOp& input);
+// Writes each of the sources, reshaped to slice_sizes, at the base indices
+// held by the matching row of the [N, rank] indices tensor, with a single
+// scatter. The slices must not overlap.
+xla::XlaOp BuildUpdateSlices(
+    const xla::XlaOp& input, const xla::XlaOp& indices,
+    tensorflow::gtl::ArraySlice<const xla::XlaOp> sources,
+    tensorflow::gtl::ArraySlice<const xla::int64> slice_sizes);
+
+// The nonzero() and masked_select() lowerings return the result padded to the
+// number of elements of the input, together with the S32 count of its valid
+// elements. If dynamic is true, the first dimension of the result is marked as
+// dynamic with size equal to the count, otherwise the padding elements are set
+// to zero.
+std::vector<xla::XlaOp> BuildNonZero(const xla::XlaOp& input, bool dynamic);
 
 std::vector<xla::XlaOp> BuildMaskedSelect(const xla::XlaOp& input,
-                                          const xla::XlaOp& mask);
+                                          const xla::XlaOp& mask, bool dynamic);
+
+// Copies the source elements, in order, into the input elements selected by the
+// (broadcastable to the input) mask. The source must hold at least as many
+// elements as the selected ones, which the caller has to check.
+xla::XlaOp BuildMaskedScatter(const xla::XlaOp& input, const xla::XlaOp& mask,
+                              const xla::XlaOp& source);
 
 }  // namespace torch_xla
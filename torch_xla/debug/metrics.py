@@ -1,7 +1,90 @@
 from __future__ import print_function
 
+import json
 import torch_xla
 
 
 def metrics_report():
   return torch_xla._XLAC._xla_metrics_report()
+
+
+def counter_value(name):
+  """Returns the value of the given counter, or `None` if it does not exist."""
+  return torch_xla._XLAC._xla_counter_value(name)
+
+
+def metric_data(name):
+  """Returns the data of the given metric, or `None` if it does not exist.
+
+  The data is a `(total_samples, accumulator, samples)` tuple, where `samples`
+  is a tuple of the `(timestamp, value)` pairs retained by the metric.
+  """
+  return torch_xla._XLAC._xla_metric_data(name)
+
+
+def metrics_report_json():
+  """Returns the current counters and metrics statistics as a dictionary.
+
+  The dictionary has a `counters` entry, mapping counter names to their values,
+  and a `metrics` one, mapping metric names to their `total_samples`,
+  `accumulator`, `min`, `max` and `percentiles` statistics.
+  """
+  return json.loads(torch_xla._XLAC._xla_metrics_report_json())
+
+
+def set_step_metrics_deltas(enabled=True):
+  """Enables or disables the capture of the metrics deltas at every step.
+
+  The capture is enabled by default if the `XLA_METRICS_STEP_DELTAS` or the
+  `XLA_METRICS_JSON_FILE` environment variables are set.
+  """
+  torch_xla._XLAC._xla_set_step_metrics_deltas(enabled)
+
+
+def last_step_metrics():
+  """Returns the changes of counters and metrics during the last step.
+
+  The returned dictionary holds the `step` number, the `time_ns` elapsed since
+  the previous step, the `counters` whose values changed (mapped to their
+  deltas), and the `metrics` which received samples (mapped to the number of
+  new `samples` and their `accumulator` delta). Returns `None` if the step
+  deltas capture is not enabled, or no step has been completed yet.
+  """
+  delta = torch_xla._XLAC._xla_last_step_metrics()
+  return json.loads(delta) if delta else None
+
+
+def set_op_profiling(enabled=True):
+  """Enables or disables the sampling profiler of the ATen operations dispatch.
+
+  The profiler can also be enabled by setting the `XLA_OP_PROFILE` environment
+  variable. One every `XLA_OP_PROFILE_SAMPLE_RATE` (default 16) operations is
+  profiled by each thread.
+  """
+  torch_xla._XLAC._xla_set_op_profiling(enabled)
+
+
+def op_profile_report(top_n=20):
+  """Returns a report of the `top_n` ATen operations by sampled host time.
+
+  For every operation, the host time is split into bridging (XLA tensors
+  extraction and wrapping), IR building, shape inference and CPU fallback time.
+  """
+  return torch_xla._XLAC._xla_op_profile_report(top_n)
+
+
+def reset_op_profile():
+  torch_xla._XLAC._xla_reset_op_profile()
+
+
+def fallback_report():
+  """Returns a report of the ATen operations executed by the CPU fallbacks.
+
+  Every fallback is reported together with its Python call site, the number of
+  times it has been called, and the total time it took.
+  """
+  return torch_xla._XLAC._xla_fallback_report()
+
+
+def reset_fallback_report():
+  torch_xla._XLAC._xla_reset_fallback_report()
@@ -4,8 +4,10 @@ import os
 import threading
 import torch_xla
 import torch_xla.debug.metrics as met
+import torch_xla.utils.utils as xu
 
 _STEP_METRICS_FILE = None
+_STEP_METRICS_JSON_FILE = None
 _STEP_METRICS_FILE_LOCK = threading.Lock()
 
 _TLS = threading.local()
@@ -17,10 +19,10 @@ def _counter():
   return counter
 
 
-def _extract_metrics_file():
+def _extract_metrics_file(env='XLA_METRICS_FILE'):
   # Delay xla_model import to avoid cross dependencies.
   import torch_xla.core.xla_model as xm
-  metrics_file = os.environ.get('XLA_METRICS_FILE', None)
+  metrics_file = os.environ.get(env, None)
   if metrics_file is not None:
     ordinal = xm.get_ordinal(defval=-1)
     if ordinal >= 0:
@@ -35,14 +37,34 @@ def _get_metrics_file():
   return _STEP_METRICS_FILE
 
 
+def _get_metrics_json_file():
+  global _STEP_METRICS_JSON_FILE
+  if _STEP_METRICS_JSON_FILE is None:
+    _STEP_METRICS_JSON_FILE = _extract_metrics_file(env='XLA_METRICS_JSON_FILE')
+  return _STEP_METRICS_JSON_FILE
+
+
+def _save_step_metrics_json():
+  metrics_file = _get_metrics_json_file()
+  if metrics_file is not None:
+    # The step delta is captured by the mark_step() call which precedes this
+    # one, so only the already serialized JSON line needs to be written.
+    metrics_data = torch_xla._XLAC._xla_last_step_metrics()
+    if metrics_data:
+      with _STEP_METRICS_FILE_LOCK:
+        with open(metrics_file, 'a') as fd:
+          fd.write(metrics_data + '\n')
+
+
 def save_metrics(metrics_file=None):
+  _save_step_metrics_json()
   if metrics_file is None:
     metrics_file = _get_metrics_file()
   if metrics_file is not None:
     metrics_data = '[MetricsData; step={}]\n{}\n'.format(
         _counter(), met.metrics_report())
     if metrics_file == 'STDERR':
-      print(metrics_data, file=sys.stderr)
+      xu.eprint(metrics_data)
     elif metrics_file == 'STDOUT':
       print(metrics_data)
     else:
@@ -0,0 +1,58 @@
+from __future__ import print_function
+
+import torch_xla
+
+
+def start_trace(clear=True):
+  """Starts collecting timeline events.
+
+  The events cover the host side graph tracing (between step markers), the IR
+  lowering, the compilation, the execution, the data transfers and the device
+  handles release. Tracing can also be enabled since startup with the
+  `XLA_TRACE=1` environment variable.
+
+  Args:
+    clear (bool, optional): Whether the events collected so far should be
+      dropped.
+      Default: True
+  """
+  if clear:
+    torch_xla._XLAC._xla_clear_trace()
+  torch_xla._XLAC._xla_set_tracing(True)
+
+
+def stop_trace():
+  """Stops collecting timeline events.
+
+  The events collected so far are retained, and can be retrieved with the
+  `dump_trace()` API.
+  """
+  torch_xla._XLAC._xla_set_tracing(False)
+
+
+def is_tracing():
+  return torch_xla._XLAC._xla_is_tracing()
+
+
+def clear_trace():
+  torch_xla._XLAC._xla_clear_trace()
+
+
+def dump_trace(path=None):
+  """Dumps the collected timeline events in Chrome trace JSON format.
+
+  The trace can be loaded within the `chrome://tracing` page, or the Perfetto
+  UI.
+
+  Args:
+    path (string, optional): If specified, the path of the file where the trace
+      should be written.
+
+  Returns:
+    The trace JSON string.
+  """
+  trace = torch_xla._XLAC._xla_dump_trace()
+  if path is not None:
+    with open(path, 'w') as fd:
+      fd.write(trace)
+  return trace
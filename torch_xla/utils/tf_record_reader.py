@@ -1,6 +1,7 @@
 from __future__ import division
 from __future__ import print_function
 
+import torch
 import torch_xla
 
 
@@ -62,3 +63,161 @@ class TfRecordReader(object):
         else:
           raise RuntimeError('Invalid transform: {}'.format(trs))
     return ex
+
+
+class InterleavedTfRecordReader(object):
+  """Reads TfRecords from a set of files, interleaving them.
+
+  The reader keeps `cycle_length` files open at a time, and returns
+  `block_length` consecutive records from each of them in turn. Once a file is
+  exhausted, the next one in the list takes its place. Reading and
+  decompression happen in background threads, with up to `prefetch_records`
+  records buffered per open file. The order of the returned records only depends
+  on the list of files and the reader arguments.
+
+  Args:
+    paths (list): The paths of the files containing TfRecords.
+    compression (string, optional): The compression type. The empty string for
+      no compression, otherwise ``ZLIB`` or ``GZIP``.
+      Default: No compression.
+    buffer_size (int, optional): The size of the buffer to be used to read
+      TfRecords from each file.
+      Default: 16 * 1024 * 1024
+    cycle_length (int, optional): The number of files read concurrently.
+      Default: 8
+    block_length (int, optional): The number of consecutive records taken from
+      a file before moving to the next one in the cycle.
+      Default: 1
+    prefetch_records (int, optional): The maximum number of records buffered in
+      background for each open file.
+      Default: 256
+    shard_ordinal (int, optional): The ordinal of the worker reading the data.
+      Only the files whose index modulo `num_shards` equals `shard_ordinal` are
+      read by this reader.
+      Default: 0
+    num_shards (int, optional): The number of workers the files are split
+      among.
+      Default: 1
+  """
+
+  def __init__(self,
+               paths,
+               compression='',
+               buffer_size=16 * 1024 * 1024,
+               cycle_length=8,
+               block_length=1,
+               prefetch_records=256,
+               shard_ordinal=0,
+               num_shards=1):
+    self._reader = torch_xla._XLAC._xla_create_interleaved_tfrecord_reader(
+        list(paths),
+        compression=compression,
+        buffer_size=buffer_size,
+        cycle_length=cycle_length,
+        block_length=block_length,
+        prefetch_records=prefetch_records,
+        shard_ordinal=shard_ordinal,
+        num_shards=num_shards)
+
+  def read_records(self, count):
+    """Reads up to `count` TfRecords.
+
+    Returns:
+      A list with the raw bytes of the records read. The list is shorter than
+      `count` only when the end of the input files is reached, and empty on EOF.
+    """
+    return torch_xla._XLAC._xla_interleaved_tfrecord_read(self._reader, count)
+
+  def read_examples(self, count, features, device=None):
+    """Reads up to `count` TfExamples and decodes them into batched tensors.
+
+    Args:
+      count (int): The maximum number of examples to read.
+      features (dict): The `ExampleFeature` specs of the features to decode.
+      device (string or torch.device, optional): If specified, the device where
+        the batched tensors should be uploaded.
+
+    Returns:
+      The result of `decode_examples()` over the records read, or ``None`` in
+      case of EOF.
+    """
+    records = self.read_records(count)
+    if not records:
+      return None
+    return decode_examples(records, features, device=device)
+
+  def read_record(self):
+    """Reads a TfRecord and returns the raw bytes.
+
+    Returns:
+      The raw bytes of the record, or ``None`` in case of EOF.
+    """
+    records = self.read_records(1)
+    return records[0] if records else None
+
+  def __iter__(self):
+    while True:
+      record = self.read_record()
+      if record is None:
+        break
+      yield record
+
+
+class ExampleFeature(object):
+  """Describes how a TfExample feature is decoded into a dense tensor.
+
+  Args:
+    shape (list): The per example shape of the feature.
+    dtype (torch.dtype, optional): The element type of the decoded tensor. The
+      feature values are converted to it.
+      Default: torch.float32
+    padded (bool, optional): Whether examples can carry fewer values than the
+      ones the shape holds, in which case the remaining ones are set to
+      `default_value`. A missing padded feature is decoded with all the values
+      set to `default_value`.
+      Default: False
+    default_value (number, optional): The padding value.
+      Default: 0
+  """
+
+  def __init__(self, shape, dtype=torch.float32, padded=False, default_value=0):
+    self.shape = list(shape)
+    self.dtype = dtype
+    self.padded = padded
+    self.default_value = default_value
+
+
+def decode_examples(records, features, device=None):
+  """Decodes serialized TfExamples into batched tensors.
+
+  The records are parsed in parallel, with the GIL released, and the feature
+  values are written directly into the batched tensors.
+
+  Args:
+    records (list): The serialized TfExample records.
+    features (dict): A dictionary with the feature name as key, and the
+      `ExampleFeature` spec of the feature as value.
+    device (string or torch.device, optional): If specified, the device where
+      the batched tensors should be uploaded.
+
+  Returns:
+    A dictionary with the feature name as key. The value is a tensor of shape
+    `[len(records)] + feature.shape` for non padded features, and a tuple with
+    such tensor plus a `[len(records)]` tensor holding the number of values of
+    each example, for padded ones.
+  """
+  names = list(features.keys())
+  specs = []
+  for name in names:
+    feature = features[name]
+    specs.append((name, feature.dtype, feature.shape, feature.padded,
+                  float(feature.default_value)))
+  values, lengths = torch_xla._XLAC._xla_decode_tfexamples(
+      records, specs, device=str(device) if device is not None else '')
+  result = dict()
+  for i, name in enumerate(names):
+    if lengths[i] is not None:
+      result[name] = (values[i], lengths[i])
+    else:
+      result[name] = values[i]
+  return result